@@ -24,6 +24,8 @@
 
 #include "roveIncludes/mrdtRoveWare.h"
 
+#include <ti/sysbios/hal/Hwi.h>
+
 // globally create UART handles
 
 //uart0 and uart1 DO NOT have pinouts on MOB
@@ -53,10 +55,28 @@ Watchdog_Handle watchdog;
 
 const uint8_t FOREVER = 1;
 
+// roveLog takes its place in the ring with interrupts off, it is called from Hwis too
+
+static uint32_t logLock(void) {
+
+	return Hwi_disable();
+
+}				//endfnctn logLock
+
+static void logUnlock(uint32_t key) {
+
+	Hwi_restore(key);
+
+}				//endfnctn logUnlock
+
 // init main
 
 int main(void) {
 
+	// first, so everything after can log with a time
+
+	roveLogInit(roveGetMicros, logLock, logUnlock);
+
 // init TI board driver routines
 
 	Board_initGeneral();
@@ -64,18 +84,15 @@ int main(void) {
 	Board_initEMAC();
 	Board_initWatchdog();
 
-	System_printf("Init uarts\n");
-	System_flush();
+	roveLogEvent(LOG_MAIN_INIT_UARTS);
 	Board_initUART();
 
-	System_printf("Init PWM\n");
-	System_flush();
+	roveLogEvent(LOG_MAIN_INIT_PWM);
 	Board_initPWM();
 
 //init UARTS
 
-	System_printf("Assign UARTS\n");
-	System_flush();
+	roveLogEvent(LOG_MAIN_ASSIGN_UARTS);
 
 	// not utilizing uart0 or uart1 (no mob to pins)
 
@@ -93,32 +110,85 @@ int main(void) {
 //System_printf("Assign PWM 1\n");
 //System_flush();
 
-	motor_0 = (PWM_Handle) rovePWMInit(1, 20000);
+	motor_0 = roveDrivePWMInit(0);
 
 	//System_printf("Assign PWM 2\n");
 	//System_flush();
 
-	motor_1 = (PWM_Handle) rovePWMInit(2, 20000);
+	motor_1 = roveDrivePWMInit(1);
 
 	//System_printf("Assign PWM 3\n");
 	//System_flush();
 
-	motor_2 = (PWM_Handle) rovePWMInit(3, 20000);
+	motor_2 = roveDrivePWMInit(2);
 
 	//System_printf("Assign PWM 4\n");
 	//System_flush();
 
-	motor_3 = (PWM_Handle) rovePWMInit(4, 20000);
+	motor_3 = roveDrivePWMInit(3);
 
 	//System_printf("Assign PWM 5\n");
 	//System_flush();
 
-	motor_4 = (PWM_Handle) rovePWMInit(5, 20000);
+	motor_4 = roveDrivePWMInit(4);
 
 	//System_printf("Assign PWM 6\n");
 	//System_flush();
 
-	motor_5 = (PWM_Handle) rovePWMInit(6, 20000);
+	motor_5 = roveDrivePWMInit(5);
+
+	// per motor ESC tables from EEPROM, before anything stages a pulse width
+
+	roveCalibrationLoad();
+
+	// generators are in global sync mode: latch the periods and neutral duties together
+
+	rovePWMSyncInit();
+
+	// roveMotionProfileClock starts stepping the drive ramps with BIOS_start
+
+	roveDriveProfileInit();
+
+	// CRC module for SERIAL_FRAME_CRC16 frames
+
+	initSerialCrc();
+
+	// stamped commands older than this are dropped until the base station asks otherwise
+
+	roveCmdExpirySetMaxAge(CMD_MAX_AGE_MS);
+
+	// roveTcpHandler to roveCmdCntrl, before either task runs
+
+	roveMsgPoolInit();
+	roveCmdQueueInit();
+
+	// field layouts of the delta encoded telemetry, before roveTcpSender encodes any
+
+	initTelemCodecStreams();
+
+	// long device messages from roveTelemCntrl to roveTcpSender
+
+	roveFragmentLinkInit();
+
+	// cycle counter for the roveProfile probes, before anything runs one
+
+	if (PROFILE_ENABLED) {
+
+		roveProfileInit();
+
+	} //endif
+
+	// program counter sampling timer, plugged straight into the vector table
+
+	if (SAMPLER_ENABLED) {
+
+		roveSamplerInit();
+
+	} //endif
+
+	// deadmanTimer starts ticking with BIOS_start
+
+	roveDeadmanInitGroups();
 
 
 	watchdog = rove_init_watchdog(Board_WATCHDOG0);
@@ -128,10 +198,7 @@ int main(void) {
 // start TI BIOS
 	ms_delay(1);
 
-	System_printf("roveMotherboardMain init \n");
-	System_printf("\n");
-	System_printf("\n");
-	System_flush();
+	roveLogEvent(LOG_MAIN_INIT);
 
 	ms_delay(1);
 
@@ -9,7 +9,7 @@
 // this implements a single function BIOS thread
 // that acts as the RoverMotherboard.cfg roveCmdCtrlTask handle
 //
-// recieves commands from roveTCPHandler in roveCom protocol using TI.Mailbox.from object
+// recieves commands from roveTCPHandler in roveCom protocol through roveCmdQueue
 //
 // sends pwm commands to motors, and uart commands to robot arm
 //
@@ -21,6 +21,239 @@
 
 #include "roveIncludes/roveWareHeaders/roveCmdCntrl.h"
 
+#include <ti/sysbios/knl/Swi.h>
+
+// wheels are commanded forward positive in motor_0 ... motor_5 order, right side first
+// roveKinematics applies each motor's direction and trim
+//
+// the speeds are targets for roveMotionProfile, staged here until commitTargets
+
+static int16_t drive_targets[DRIVE_MOTOR_COUNT];
+static uint8_t drive_targets_staged = 0;
+
+// when the first of the staged targets was staged, for DRIVE_COMMIT_DEADLINE_MS
+
+static uint32_t drive_staged_tick;
+
+// the oldest traced command among the staged targets, its wait to be committed counts
+// against it in TRACE_ACTUATE
+
+static uint32_t drive_trace_start;
+static bool drive_traced = false;
+
+static void traceStaged(const base_station_msg_struct* message) {
+
+    if (!drive_traced && (message->flags & CMD_FLAG_TRACED)) {
+
+        drive_trace_start = message->trace_start;
+        drive_traced = true;
+
+    } //endif
+
+} //endfnctn traceStaged
+
+static void sendArmStop(void) {
+
+    struct robot_arm_command stop = { e_stop_arm, 0 };
+    char buffer[sizeof(stop) + SERIAL_FRAME_OVERHEAD];
+    int jack = getDeviceJack(e_stop_arm);
+    int size;
+
+    if (jack == -1) {
+
+        return;
+
+    } //endif
+
+    size = buildSerialStructMessage(&stop, buffer);
+
+    deviceWrite(jack, buffer, size);
+
+} //endfnctn sendArmStop
+
+// which commands roveCmdExpiry orders against each other, and which of them are stops
+
+static int commandClass(const base_station_msg_struct* message) {
+
+    switch (message->id) {
+
+    case motor_left_id:
+    case motor_right_id:
+    case six_wheel_drive_id:
+    case twist_drive_id:
+        return CMD_CLASS_DRIVE;
+
+    case wrist_clock_wise ... drill_forward:
+        return CMD_CLASS_ARM;
+
+    } //endswitch
+
+    return CMD_CLASS_NONE;
+
+} //endfnctn commandClass
+
+static bool isStopCommand(const base_station_msg_struct* message) {
+
+    const struct six_wheel_drive_struct* sixWheel;
+    const struct twist_drive_struct* twist;
+    int i;
+
+    switch (message->id) {
+
+    case e_stop_arm:
+        return true;
+
+    case motor_left_id:
+    case motor_right_id:
+        return ((const struct motor_control_struct*) message)->speed == 0;
+
+    case six_wheel_drive_id:
+
+        sixWheel = (const struct six_wheel_drive_struct*) message;
+
+        for (i = 0; i < DRIVE_MOTOR_COUNT; i++) {
+
+            if (sixWheel->speed[i] != 0) {
+
+                return false;
+
+            } //endif
+
+        } //endfor
+
+        return true;
+
+    case twist_drive_id:
+
+        twist = (const struct twist_drive_struct*) message;
+
+        return (twist->linear_mm_s == 0) && (twist->angular_mrad_s == 0);
+
+    } //endswitch
+
+    return false;
+
+} //endfnctn isStopCommand
+
+// CMD_ACCEPT for anything unstamped, see roveCmdExpiry.h
+
+static int expiryCheck(const base_station_msg_struct* message) {
+
+    struct cmd_stamp stamp;
+
+    stamp.cmd_class = commandClass(message);
+
+    if ((stamp.cmd_class == CMD_CLASS_NONE) || !(message->flags & CMD_FLAG_STAMPED)) {
+
+        return CMD_ACCEPT;
+
+    } //endif
+
+    stamp.seq = message->seq;
+    stamp.stop = isStopCommand(message);
+    stamp.age_known = roveClockSyncIsValid();
+    stamp.age_us = stamp.age_known ?
+            (int32_t) (roveGetMicros() - roveClockFromBase(message->sent_us)) : 0;
+
+    return roveCmdExpiryCheck(&stamp);
+
+} //endfnctn expiryCheck
+
+// one way base send -> actuation latency of a stamped command just written to the PWM / uart
+
+static void expiryApplied(const base_station_msg_struct* message) {
+
+    if (!(message->flags & CMD_FLAG_STAMPED) || !roveClockSyncIsValid()) {
+
+        return;
+
+    } //endif
+
+    roveCmdExpiryApplied(roveClockToBase(roveGetMicros()) - message->sent_us);
+
+} //endfnctn expiryApplied
+
+static void commitTargets(void) {
+
+    UInt key;
+    int i;
+
+    // roveMotionProfileClock runs as a Swi: it sees every new target or none of them
+
+    key = Swi_disable();
+
+    for (i = 0; i < DRIVE_MOTOR_COUNT; i++) {
+
+        if (drive_targets_staged & (1 << i)) {
+
+            roveMotionProfileSetTarget(i, drive_targets[i]);
+
+        } //endif
+
+    } //endfor
+
+    Swi_restore(key);
+
+    drive_targets_staged = 0;
+
+    if (drive_traced) {
+
+        roveTraceStage(TRACE_ACTUATE, drive_trace_start);
+        drive_traced = false;
+
+    } //endif
+
+} //endfnctn commitTargets
+
+// a wheel staged again before its last target was committed: that target goes out first,
+// rather than being overwritten without ever reaching the motion profile
+
+static void stageBegin(uint8_t wheels) {
+
+    if (drive_targets_staged & wheels) {
+
+        commitTargets();
+
+    } //endif
+
+    if (drive_targets_staged == 0) {
+
+        drive_staged_tick = Clock_getTicks();
+
+    } //endif
+
+} //endfnctn stageBegin
+
+static void stageSide(int first_wheel, int speed) {
+
+    int wheel;
+
+    stageBegin(((1 << KINEMATICS_SIDE_COUNT) - 1) << first_wheel);
+
+    for (wheel = first_wheel; wheel < first_wheel + KINEMATICS_SIDE_COUNT; wheel++) {
+
+        drive_targets[wheel] = roveKinematicsWheel(wheel, speed);
+        drive_targets_staged |= (1 << wheel);
+
+    } //endfor
+
+} //endfnctn stageSide
+
+static void stageWheels(const int16_t wheel[DRIVE_MOTOR_COUNT]) {
+
+    int i;
+
+    stageBegin((1 << DRIVE_MOTOR_COUNT) - 1);
+
+    for (i = 0; i < DRIVE_MOTOR_COUNT; i++) {
+
+        drive_targets[i] = wheel[i];
+        drive_targets_staged |= (1 << i);
+
+    } //endfor
+
+} //endfnctn stageWheels
+
 Void roveCmdCntrl(UArg arg0, UArg arg1) {
 
     //const FOREVER hack to kill the 'unreachable statement' compiler warning
@@ -36,30 +269,102 @@ Void roveCmdCntrl(UArg arg0, UArg arg1) {
     extern PWM_Handle motor_4;
     extern PWM_Handle motor_5;
 
-    base_station_msg_struct fromBaseMsg;
-
-    char commandBuffer[MAX_COMMAND_SIZE + 4];
+    int msgBuffer;
+    base_station_msg_struct* fromBaseMsg;
 
     int messageSize;
     int deviceJack;
+    int destination;
     int motor_speed = 0;
 
     int16_t arm_speed = 0;
 
+    bool driveStaged = false;
+
+    struct twist_drive_struct* twist;
+    struct six_wheel_drive_struct* sixWheel;
+    int32_t forward[DRIVE_MOTOR_COUNT];
+    int16_t wheel[DRIVE_MOTOR_COUNT];
+
+    struct drive_calibration_command* calibrationCmd;
+    struct drive_calibration calibration;
+
+    struct kinematics_config kinematics = { KINEMATICS_TRACK_WIDTH_MM,
+            KINEMATICS_MAX_WHEEL_SPEED_MM_S, KINEMATICS_DIRECTION };
+
     int i = 0;
 
-    System_printf("roveCmdCntrlr		init! \n\n");
+    for (i = 0; i < DRIVE_MOTOR_COUNT; i++) {
 
-    System_flush();
+        kinematics.trim_q12[i] = KINEMATICS_TRIM_ONE;
+
+    } //endfor
+
+    roveKinematicsConfigure(&kinematics);
+
+    // routes for getDeviceJack, before the first command needs one
+
+    roveDiscoveryScan();
+
+    roveLogEvent(LOG_CMD_INIT);
 
     while (FOREVER) {
 
+        // drive commands are staged and go out together once nothing else is waiting,
+        // so a left and a right command sent back to back change speed in the same pwm period.
+        // Under a steady stream they go out DRIVE_COMMIT_DEADLINE_MS after the first was staged,
+        // or when a wheel is staged again
+
+        if (driveStaged
+                && ((roveCmdQueueCount() == 0)
+                        || ((Clock_getTicks() - drive_staged_tick) >= DRIVE_COMMIT_DEADLINE_MS))) {
+
+            commitTargets();
+            driveStaged = false;
+
+        } //endif
+
 //		System_printf("CmdCntrl Is PENDING FOR MAIL!\n\n");
 //		System_flush();
 
-        Mailbox_pend(fromBaseStationMailbox, &fromBaseMsg, BIOS_WAIT_FOREVER);
+        // the command stays in its pool buffer, which goes back to the pool after the switch
+
+        msgBuffer = roveCmdQueuePend();
+
+        // the arm deadman expired: stop it from here, the only task that writes its uart
+
+        if (roveDeadmanArmStopTake()) {
+
+            sendArmStop();
+
+        } //endif
+
+        if (msgBuffer < 0) {
+
+            continue;
+
+        } //endif
+
+        fromBaseMsg = roveMsgPoolMessage(msgBuffer);
+
+        // a stamped drive or arm command that sat too long in tcp or the queue, or was
+        // overtaken by a newer one, is dropped rather than applied as if it were fresh.
+        // Stops are always applied
 
-        switch (fromBaseMsg.id) {
+        if (expiryCheck(fromBaseMsg) != CMD_ACCEPT) {
+
+            roveMsgPoolFree(msgBuffer);
+            continue;
+
+        } //endif
+
+        if (fromBaseMsg->flags & CMD_FLAG_TRACED) {
+
+            roveTraceStage(TRACE_DISPATCH, fromBaseMsg->trace_start);
+
+        } //endif
+
+        switch (fromBaseMsg->id) {
 
         // case 0 hack to make a happy switch
         case 0:
@@ -67,13 +372,17 @@ Void roveCmdCntrl(UArg arg0, UArg arg1) {
 
         case motor_right_id:
 
-            //the left motors must be the negative of the right motors. Their phase is backwards
+            //the left motors must be the negative of the right motors. Their phase is backwards (see drive_direction)
+            roveDeadmanFeed(DEADMAN_RIGHT_DRIVE);
+
             motor_speed =
-                    -(((struct motor_control_struct*) (&fromBaseMsg))->speed);
+                    (((struct motor_control_struct*) fromBaseMsg)->speed);
 
-            DriveMotor(motor_0, motor_speed);
-            DriveMotor(motor_1, motor_speed);
-            DriveMotor(motor_2, -motor_speed);
+            stageSide(KINEMATICS_RIGHT_FIRST, motor_speed);
+            driveStaged = true;
+            traceStaged(fromBaseMsg);
+
+            expiryApplied(fromBaseMsg);
 
             break;
 
@@ -81,37 +390,174 @@ Void roveCmdCntrl(UArg arg0, UArg arg1) {
 
         case motor_left_id:
 
+            roveDeadmanFeed(DEADMAN_LEFT_DRIVE);
+
             motor_speed =
-                    (((struct motor_control_struct*) (&fromBaseMsg))->speed);
+                    (((struct motor_control_struct*) fromBaseMsg)->speed);
+
+            stageSide(KINEMATICS_LEFT_FIRST, motor_speed);
+            driveStaged = true;
+            traceStaged(fromBaseMsg);
 
-            DriveMotor(motor_3, -motor_speed);
-            DriveMotor(motor_4, motor_speed);
-            DriveMotor(motor_5, -motor_speed);
+            expiryApplied(fromBaseMsg);
 
             break;
 
             //end drive motor_left_id
 
+        case six_wheel_drive_id:
+
+            // one frame for the whole rover, goes out in a single synchronized pwm update
+            roveDeadmanFeed(DEADMAN_RIGHT_DRIVE);
+            roveDeadmanFeed(DEADMAN_LEFT_DRIVE);
+
+            sixWheel = (struct six_wheel_drive_struct*) fromBaseMsg;
+
+            for (i = 0; i < DRIVE_MOTOR_COUNT; i++) {
+
+                forward[i] = sixWheel->speed[i];
+
+            } //endfor
+
+            roveKinematicsMix(forward, wheel);
+            stageWheels(wheel);
+            driveStaged = true;
+            traceStaged(fromBaseMsg);
+
+            expiryApplied(fromBaseMsg);
+
+            break;
+
+            //end drive six_wheel_drive_id
+
+        case twist_drive_id:
+
+            roveDeadmanFeed(DEADMAN_RIGHT_DRIVE);
+            roveDeadmanFeed(DEADMAN_LEFT_DRIVE);
+
+            twist = (struct twist_drive_struct*) fromBaseMsg;
+
+            roveKinematicsTwist(twist->linear_mm_s, twist->angular_mrad_s, wheel);
+            stageWheels(wheel);
+            driveStaged = true;
+            traceStaged(fromBaseMsg);
+
+            expiryApplied(fromBaseMsg);
+
+            break;
+
+            //end drive twist_drive_id
+
+        case drive_calibration_id:
+
+            calibrationCmd = (struct drive_calibration_command*) fromBaseMsg;
+
+            calibration.neutral_us = calibrationCmd->neutral_us;
+
+            for (i = 0; i < CALIBRATION_POINTS; i++) {
+
+                calibration.forward_us[i] = calibrationCmd->forward_us[i];
+                calibration.reverse_us[i] = calibrationCmd->reverse_us[i];
+
+            } //endfor
+
+            if (!roveCalibrationApply(calibrationCmd->motor, &calibration)) {
+
+                roveLog(LOG_CMD_CALIBRATION_REJECTED, calibrationCmd->motor, 0, 0);
+
+            } else if (calibrationCmd->save && !roveCalibrationSave()) {
+
+                roveLogEvent(LOG_CMD_CALIBRATION_SAVE_FAILED);
+
+            } //endif
+
+            break;
+
+            //end drive_calibration_id
+
         case bms_emergency_command_id:
-        	if((((struct bms_emergency_command*) (&fromBaseMsg)) -> command)
+        	if((((struct bms_emergency_command*) fromBaseMsg) -> command)
         			== 1)
         	{
         		digitalWrite(SOFT_RESET_GPIO_PIN, HIGH);
         	}
         	break;
 
+        case fragment_id:
+
+            // a piece of a ROVER_LONG_MESSAGE, to the jack of the device the whole message is for
+            destination = ((struct fragment_struct*) fromBaseMsg)->destination;
+
+            // a long message to the arm keeps it alive like any other arm command
+            if ((destination >= wrist_clock_wise) && (destination <= drill_forward)) {
+
+                roveDeadmanFeed(DEADMAN_ARM);
+
+            } //endif
+
+            deviceJack = getDeviceJack(destination);
+
+            if (deviceJack == -1) {
+
+                roveLog(LOG_CMD_FRAGMENT_NO_JACK, destination, 0, 0);
+                break;
+
+            } //endif
+
+            messageSize = buildSerialStructInPlace(roveMsgPoolHeadroom(msgBuffer));
+
+            if (messageSize != -1) {
+
+                deviceWrite(deviceJack, roveMsgPoolHeadroom(msgBuffer), messageSize);
+                roveFragmentLinkSent((struct fragment_struct*) fromBaseMsg);
+
+            } //endif
+
+            break;
+
+            //end fragment_id
+
         default:
-            deviceJack = getDeviceJack(fromBaseMsg.id);
-            // flag for invalid struct size
-            if (getStructSize(fromBaseMsg.id) != -1) {
-                messageSize = buildSerialStructMessage((void *) &fromBaseMsg,
-                        commandBuffer);
-
-                deviceWrite(deviceJack, commandBuffer, messageSize);
-            }
+            // feed before writing, so the arm deadman does not expire while the write is under way
+            if ((fromBaseMsg->id >= wrist_clock_wise)
+                    && (fromBaseMsg->id <= drill_forward)) {
+
+                roveDeadmanFeed(DEADMAN_ARM);
+
+            } //endif
+
+            deviceJack = getDeviceJack(fromBaseMsg->id);
+
+            if (deviceJack == -1) {
+
+                roveLog(LOG_CMD_NO_JACK, fromBaseMsg->id, 0, 0);
+                break;
+
+            } //endif
+
+            // frame header goes in the pool buffer's headroom, the uart writes it and
+            // the command as they lie. -1 flags an invalid struct size
+            messageSize = buildSerialStructInPlace(roveMsgPoolHeadroom(msgBuffer));
+
+            if (messageSize != -1) {
+
+                deviceWrite(deviceJack, roveMsgPoolHeadroom(msgBuffer), messageSize);
+
+                if (fromBaseMsg->flags & CMD_FLAG_TRACED) {
+
+                    roveTraceStage(TRACE_ACTUATE, fromBaseMsg->trace_start);
+
+                } //endif
+
+                expiryApplied(fromBaseMsg);
+
+            } //endif
+
             break;
         } //endswitch
 
+        roveMsgPoolFree(msgBuffer);
+
         //debugging only:
 
 //		i = 0;
@@ -125,10 +571,8 @@ Void roveCmdCntrl(UArg arg0, UArg arg1) {
 //
 //		} //end while
     }
-    System_flush();
 
-    System_printf("Rove Cmd Cntrl Task Error: Forced Exit\n");
-    System_flush();
+    roveLogEvent(LOG_CMD_EXIT);
 
     Task_exit();
 
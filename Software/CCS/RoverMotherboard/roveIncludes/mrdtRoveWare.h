@@ -99,6 +99,86 @@
 // PM0
 // PM6
 
+// drive motor pwm frame and pulse protocol, per motor in DriveMotorStage order
+//
+// a new speed waits up to one frame for the ESC to see it: 20000 us (the old 50 Hz servo frame)
+// costs up to 20 ms, 2500 us (400 Hz) under 3 ms. Put a motor back to 20000 if its ESC will not
+// take the faster frame. Motors 1 and 2, and 3 and 4, share a PWM generator and so a period
+
+#define DRIVE_PWM_PERIOD_US { 2500, 2500, 2500, 2500, 2500, 2500 }
+
+// DRIVE_ESC_STANDARD: the calibrated 1000 to 2000 us servo pulse
+// DRIVE_ESC_ONESHOT125: the same pulse divided by 8 (125 to 250 us), with a frame as short as 500 us
+
+#define DRIVE_ESC_STANDARD 1
+#define DRIVE_ESC_ONESHOT125 8
+
+#define DRIVE_ESC_PROTOCOL { DRIVE_ESC_STANDARD, DRIVE_ESC_STANDARD, DRIVE_ESC_STANDARD, \
+    DRIVE_ESC_STANDARD, DRIVE_ESC_STANDARD, DRIVE_ESC_STANDARD }
+
+// drive motors in DriveMotorStage order: PWM0 outputs 1 through 6 on generators 0 to 3
+
+#define DRIVE_MOTOR_COUNT 6
+
+// roveCmdCntrl holds staged drive targets while more commands wait, but never longer than this
+// after the first was staged, so a steady command stream can't hold the drive back
+
+#define DRIVE_COMMIT_DEADLINE_MS 10
+
+// drive motion profile (see roveMotionProfile.h), stepped by roveMotionProfileClock
+// the clock period in RoverMotherboard.cfg is 1000 / MOTION_PROFILE_RATE_HZ ticks, change both together
+
+#define MOTION_PROFILE_RATE_HZ 500
+
+// DriveMotor units per second: 0 to full speed in half a second, a full reversal in one
+
+#define MOTION_ACCEL_LIMIT 2000
+
+// DriveMotor units per second per second: full acceleration is reached in 100 ms
+
+#define MOTION_JERK_LIMIT 20000
+
+// closed loop wheel speed control (see roveSpeedControl.h), stepped with the motion profile
+// off: the profile output goes straight to the ESCs as before. Its wheel_feedback_telem must come
+// in on GPS_ON_MOB, the only jack roveTelemCntrl reads (deviceRead can't poll the other jacks)
+
+#define SPEED_CONTROL_CLOSED_LOOP false
+
+// Q16 gains tuned on Software/Tests/SpeedControlSim: kp 2.0, ki 0.01 per tick, feedforward 1.0
+
+#define SPEED_CONTROL_KP_Q16 131072
+#define SPEED_CONTROL_KI_Q16 655
+#define SPEED_CONTROL_KD_Q16 0
+#define SPEED_CONTROL_KFF_Q16 65536
+
+// a wheel with no feedback for this many profile ticks (100 ms) drops back to open loop
+
+#define SPEED_CONTROL_FEEDBACK_TIMEOUT_TICKS 50
+
+// for the speed estimate from power board motor current: winding resistance and pack voltage
+
+#define SPEED_CONTROL_WINDING_MOHM 200
+#define SPEED_CONTROL_PACK_MV 24000
+
+// drive ESC calibration (see roveCalibration.h), kept in the on chip EEPROM from this byte address
+
+#define CALIBRATION_EEPROM_ADDRESS 0
+
+// drive kinematics (see roveKinematics.h)
+
+// distance between the left and right wheel centers
+
+#define KINEMATICS_TRACK_WIDTH_MM 760
+
+// ground speed of a wheel at full DriveMotor command
+
+#define KINEMATICS_MAX_WHEEL_SPEED_MM_S 1500
+
+// phase of each motor controller: the two sides face opposite ways and motor_2 and motor_4
+// are wired backwards on their side
+
+#define KINEMATICS_DIRECTION { -1, -1, 1, -1, 1, -1 }
+
 // Network Parameters
 
 // tcp ip socket flags
@@ -127,6 +207,12 @@
 #define ROVER_COMMAND		0x05
 #define ROVER_TELEM			0x06
 #define ROVER_ERROR			0x07
+#define ROVER_TELEM_DELTA	0x08
+#define ROVER_HEARTBEAT		0x09
+#define ROVER_TELEM_STAMPED	0x0A
+#define ROVER_COMMAND_STAMPED	0x0B
+#define ROVER_DIAGNOSTIC	0x0C
+#define ROVER_LONG_MESSAGE	0x0D
 #define JSON_START_BYTE 	'{'
 
 // TCP Sending Parameters
@@ -135,7 +221,214 @@
 
 #define RECV_UART_NONBLOCK_TASK_PRIORITY 2
 
-#define SEND_KEEPALIVE_DELAY_TICKS BIOS_WAIT_FOREVER //Can also be set to BIOS_WAIT_FOREVER or BIOS_NO_WAIT
+// boot time device discovery (see roveDiscovery.h): one task per uart, below roveCmdCntrl which waits on them
+
+#define DISCOVERY_LANE_TASK_PRIORITY 3
+
+// the RS485 jacks it probes, 7 through 17
+
+#define DISCOVERY_FIRST_JACK 7
+#define DISCOVERY_JACKS 11
+
+// how long a jack gets to answer, and the bound on the whole scan (four jacks on the busiest uart)
+
+#define DISCOVERY_REPLY_TIMEOUT_MS 50
+#define DISCOVERY_TIMEOUT_MS 300
+
+// the boot scan sends mobo_identify_req (id 252) to every jack and discovery_telem goes out on
+// each connection. Off, getDeviceJack uses its fixed jacks only. Only turn on once the devices
+// answer mobo_identify_req and the base station reads discovery_telem
+
+#define DISCOVERY_ENABLED false
+
+// heartbeat to the base station (see roveLinkStats.h), Clock ticks are 1 ms
+
+#define HEARTBEAT_PERIOD_MS 100
+
+// ROVER_HEARTBEAT and link_stats_telem go out, and a link whose echoes stop is shut down.
+// Only turn on once the base station echoes ROVER_HEARTBEAT and reads link_stats_telem
+
+#define LINK_HEARTBEAT_ENABLED false
+
+// no heartbeat echo for this long and the link is declared dead
+
+#define HEARTBEAT_TIMEOUT_MS 500
+
+// rtts kept for the percentiles in link_stats_telem, at most 255 (its samples field is one byte)
+
+#define LINK_RTT_WINDOW 64
+
+// how often link_stats_telem goes to the base station
+
+#define LINK_STATS_PERIOD_MS 1000
+
+// base station clock synchronization over SYNCHRONIZE_STATUS (see roveClockSync.h)
+
+#define CLOCK_SYNC_PERIOD_MS 1000
+
+// SYNCHRONIZE_STATUS requests and clock_sync_telem go out. Off, the clock never synchronizes:
+// telemetry goes unstamped and stamped commands are only checked for order. Only turn on once
+// the base station answers SYNCHRONIZE_STATUS and reads clock_sync_telem
+
+#define CLOCK_SYNC_ENABLED false
+
+// exchanges the lowest delay offset is picked from
+
+#define CLOCK_SYNC_WINDOW 8
+
+// once synchronized, plain telemetry goes out as ROVER_TELEM_STAMPED with its capture time
+// in base station microseconds. Only turn on once the base station reads ROVER_TELEM_STAMPED
+
+#define TELEM_TIMESTAMPS false
+
+// the sender wakes at least this often to send heartbeats and flush held telemetry
+
+#define SEND_KEEPALIVE_DELAY_TICKS HEARTBEAT_PERIOD_MS //Can also be set to BIOS_WAIT_FOREVER or BIOS_NO_WAIT
+
+// telemetry delta encoding (see roveTelemCodec.h)
+
+// a delta encoded id sends a full keyframe after this many delta frames
+
+#define TELEM_KEYFRAME_INTERVAL 20
+
+// only turn on once the base station decodes ROVER_TELEM_DELTA
+
+#define TELEM_DELTA_ENCODE_GPS false
+
+// telemetry rate limiting (see roveTelemPolicy.h)
+
+// number of telemetry ids that get their own policy and counters
+
+#define TELEM_POLICY_MAX_IDS 16
+
+// policy an id gets the first time it is seen: no rate limit, newest sample wins
+
+#define TELEM_POLICY_DEFAULT_MODE TELEM_POLICY_KEEP_LATEST
+#define TELEM_POLICY_DEFAULT_RATE_DHZ 0
+
+// telemetry samples held for the base station before the oldest is overwritten (see roveTelemQueue.h)
+
+#define TELEM_QUEUE_DEPTH 16
+
+// command buffers shared by roveTcpHandler and roveCmdCntrl (see roveMsgPool.h), at most 256.
+// Each has room in front of the command for the serial frame header
+
+#define MSG_POOL_SIZE 16
+
+#define MSG_FRAME_HEADER 3
+
+// rove serial frames (see roveStructTransfer.h): the byte after 0x06 says which trailer follows
+// the struct. Every device speaks SERIAL_FRAME_XOR, a device has to know SERIAL_FRAME_CRC16
+// before the rover can send it
+
+#define SERIAL_FRAME_XOR 0x85
+#define SERIAL_FRAME_CRC16 0x86
+
+#define SERIAL_FRAME_VERSION SERIAL_FRAME_XOR
+
+// most bytes a frame adds to a struct: header and a CRC
+
+#define SERIAL_FRAME_OVERHEAD 5
+
+// CRC-16 on the TM4C1294 CRC module, false for the table in roveChecksum. Only turn on once
+// roveChecksumTester has matched the module against the table on the rover
+
+#define SERIAL_CRC_HARDWARE false
+
+// bytes of the queue of pool buffers for roveCmdCntrl (see roveCmdQueue.h), a power of 2.
+// A buffer index takes 3 bytes, so 64 holds more than the whole pool
+
+#define CMD_QUEUE_SIZE 64
+
+// messages longer than MAX_COMMAND_SIZE (see roveFragment.h). They cross TCP whole as a
+// ROVER_LONG_MESSAGE and the uarts as fragments: the longest the rover puts back together
+
+#define FRAGMENT_MAX_MESSAGE 512
+
+// a device message that gets no fragment for this long is thrown away, all 22 fragments of
+// 512 bytes take about 65 ms at 115200 baud
+
+#define FRAGMENT_TIMEOUT_MS 250
+
+// bytes of the queue of whole device messages for roveTcpSender, a power of 2
+
+#define FRAGMENT_QUEUE_SIZE 1024
+
+// device fragments are put back together and go out as ROVER_LONG_MESSAGE, and fragment_telem
+// goes out every LINK_STATS_PERIOD_MS. Off, device fragments are dropped; a ROVER_LONG_MESSAGE
+// from the base station is still split to its device. Only turn on once the base station reads
+// ROVER_LONG_MESSAGE and fragment_telem
+
+#define FRAGMENT_LINK_ENABLED false
+
+// system_health_telem and task_health_telem go out every HEALTH_PERIOD_MS. Only turn on once
+// the base station reads them
+
+#define HEALTH_ENABLED false
+
+// system health telemetry (see roveHealth.h), a low rate: every task's stack is scanned for it
+
+#define HEALTH_PERIOD_MS 5000
+
+// task_health_telem sent with each system_health_telem, taking turns through the tasks so
+// the telemetry queue (TELEM_QUEUE_DEPTH) isn't filled with them every period
+
+#define HEALTH_TASKS_PER_PERIOD 2
+
+// tasks reported, past this they are counted but not sent
+
+#define HEALTH_MAX_TASKS 12
+
+#define HEALTH_TASK_NAME_SIZE 18
+
+// command latency tracing (see roveTrace.h): samples kept per stage, a power of 2
+
+#define TRACE_RING_SIZE 64
+
+// what a ROVER_DIAGNOSTIC asks for, and what the rover's answer holds
+
+#define DIAGNOSTIC_TRACE 0x01
+#define DIAGNOSTIC_LOG 0x02
+#define DIAGNOSTIC_PROFILE 0x03
+#define DIAGNOSTIC_SAMPLES 0x04
+
+// cycle counter probes on the hot roveWare functions (see roveProfile.h), off they compile to nothing
+
+#define PROFILE_ENABLED false
+
+// statistical program counter sampling (see roveSampler.h), off the sampling timer is never started.
+// The rate is prime so the samples don't fall in step with the 1 ms Clock tick or the 2 ms motion profile
+
+#define SAMPLER_ENABLED false
+
+#define SAMPLER_RATE_HZ 199
+
+// samples held until the base station drains them, a power of 2: 1024 is 5 s at 199 Hz
+
+#define SAMPLER_RING_SIZE 1024
+
+// samples in one DIAGNOSTIC_SAMPLES, roveTcpSender sends as many as it takes to empty the ring
+
+#define SAMPLER_BATCH 256
+
+// stamped drive / arm commands older than this are dropped by roveCmdCntrl (see roveCmdExpiry.h)
+// can be changed at run time with COMMAND_METADATA
+
+#define CMD_MAX_AGE_MS 250
+
+// command_expiry_telem goes out every LINK_STATS_PERIOD_MS, off it is only sent in answer to a
+// COMMAND_METADATA. Only turn on once the base station reads command_expiry_telem unasked
+
+#define CMD_EXPIRY_TELEM_ENABLED false
+
+// deadman failsafe (see roveDeadman.h): a drive side that gets no command for this long is
+// put in neutral from the deadmanTimer Hwi, the arm is sent an e_stop_arm by roveCmdCntrl
+
+#define DEADMAN_WINDOW_MS 250
+
+// deadmanTimer period in RoverMotherboard.cfg, change both together
+
+#define DEADMAN_TICK_MS 5
 
 // hardware
 
@@ -154,6 +447,9 @@
 #define	test_device_id 									99
 #define	motor_left_id 									100
 #define	motor_right_id 									101
+#define	six_wheel_drive_id 								102
+#define	twist_drive_id 									103
+#define	drive_calibration_id 							104
 
 #define PTZ_Cam_id_0                   110
 #define PTZ_Cam_id_1                   111
@@ -168,6 +464,15 @@
 #define PTZ_Cam_id_10                  120
 
 #define gps_telem_reply                                 140
+#define telem_policy_telem_id                           141
+#define link_stats_telem_id                             142
+#define clock_sync_telem_id                             143
+#define command_expiry_telem_id                         144
+#define wheel_feedback_telem_id                         145
+#define discovery_telem_id                              146
+#define system_health_telem_id                          147
+#define task_health_telem_id                            148
+#define fragment_telem_id                               149
 
 #define	bms_emergency_command_id					150
 
@@ -218,6 +523,15 @@
 
 #define drill_forward 209
 
+// a piece of a message longer than one struct, either way (see roveFragment.h)
+
+#define fragment_id 250
+
+// device discovery, mobo to device and back (see roveDiscovery.h)
+
+#define mobo_identify_req_id 252
+#define dev_identify_reply_id 253
+
 // telem_device_id
 /*
 #define	telem_req_id 254
@@ -256,6 +570,98 @@
 
 #include "roveWareHeaders/roveWatchdog.h"
 
+//MRDesign Team:: 	roveWare::		roveNet delta + varint compression of slowly changing telemetry
+
+#include "roveWareHeaders/roveTelemCodec.h"
+
+//MRDesign Team:: 	roveWare::		roveNet per telemetry id rate limiting and decimation
+
+#include "roveWareHeaders/roveTelemPolicy.h"
+
+//MRDesign Team:: 	roveWare::		roveNet non blocking drop oldest telemetry queue to the base station
+
+#include "roveWareHeaders/roveTelemQueue.h"
+
+//MRDesign Team:: 	roveWare::		roveNet heartbeat round trip time and dead link detection
+
+#include "roveWareHeaders/roveLinkStats.h"
+
+//MRDesign Team:: 	roveWare::		roveNet base station clock offset estimate for one way latency
+
+#include "roveWareHeaders/roveClockSync.h"
+
+//MRDesign Team:: 	roveWare::		roveCom drops stale and out of order base station commands
+
+#include "roveWareHeaders/roveCmdExpiry.h"
+
+//MRDesign Team:: 	roveWare::		roveCom puts actuator groups in neutral when their commands stop
+
+#include "roveWareHeaders/roveDeadman.h"
+
+//MRDesign Team:: 	roveWare::		roveCom fixed point differential drive wheel mixing
+
+#include "roveWareHeaders/roveKinematics.h"
+
+//MRDesign Team:: 	roveWare::		roveCom acceleration and jerk limited drive motor ramps
+
+#include "roveWareHeaders/roveMotionProfile.h"
+
+//MRDesign Team:: 	roveWare::		roveCom fixed point closed loop wheel speed control
+
+#include "roveWareHeaders/roveSpeedControl.h"
+
+//MRDesign Team:: 	roveWare::		roveCom per motor ESC pulse width calibration tables
+
+#include "roveWareHeaders/roveCalibration.h"
+
+//MRDesign Team:: 	roveWare::		roveCom boot time device discovery and routing on the RS485 jacks
+
+#include "roveWareHeaders/roveDiscovery.h"
+
+//MRDesign Team:: 	roveWare::		roveCom command latency tracing
+
+#include "roveWareHeaders/roveTrace.h"
+
+//MRDesign Team:: 	roveWare::		roveCom binary event log
+
+#include "roveWareHeaders/roveLog.h"
+
+//MRDesign Team:: 	roveWare::		roveCom cpu load, stack and heap health
+
+#include "roveWareHeaders/roveHealth.h"
+
+//MRDesign Team:: 	roveWare::		roveCom cycle counter profiling
+
+#include "roveWareHeaders/roveProfile.h"
+
+//MRDesign Team:: 	roveWare::		roveCom serial frame checksum and CRC kernels
+
+#include "roveWareHeaders/roveChecksum.h"
+
+//MRDesign Team:: 	roveWare::		roveCom lock free single producer single consumer queue
+
+#include "roveWareHeaders/roveQueue.h"
+
+//MRDesign Team:: 	roveWare::		roveCom command buffer pool
+
+#include "roveWareHeaders/roveMsgPool.h"
+
+//MRDesign Team:: 	roveWare::		roveCom command queue from roveTcpHandler to roveCmdCntrl
+
+#include "roveWareHeaders/roveCmdQueue.h"
+
+//MRDesign Team:: 	roveWare::		roveCom fragmentation and reassembly of long messages
+
+#include "roveWareHeaders/roveFragment.h"
+
+//MRDesign Team:: 	roveWare::		roveCom long messages between roveTcpHandler, the uarts and roveTcpSender
+
+#include "roveWareHeaders/roveFragmentLink.h"
+
+//MRDesign Team:: 	roveWare::		roveCom statistical program counter sampler
+
+#include "roveWareHeaders/roveSampler.h"
+
 //MRDesign Team:: 	roveWare::		lets the rover make its own decisions
 
 //#include "roveWareHeaders/roveAutonomy.h"
@@ -286,4 +692,8 @@
 
 //#include "rovMotorControlTester.h"
 
+//MRDesign Team::roveWare::		    roveCom checksum kernel Tester BIOS thread service
+
+//#include "roveChecksumTester.h"
+
 #endif // MRDTROVEWARE_H_
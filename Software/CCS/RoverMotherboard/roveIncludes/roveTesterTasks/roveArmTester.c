@@ -35,6 +35,8 @@ Void roveArmTester(UArg arg0, UArg arg1) {
     base_station_msg_struct test_command_msg;
     struct robot_arm_command robot_arm;
 
+    memset(&test_command_msg, 0, sizeof(test_command_msg));
+
     robot_arm.struct_id = STRUCT_ID_MIN;
     robot_arm.speed = MIN_SPEED;
     while (FOREVER) {
@@ -50,8 +52,7 @@ Void roveArmTester(UArg arg0, UArg arg1) {
                 System_flush();
 
                 memcpy(&test_command_msg, &robot_arm, sizeof(robot_arm));
-                Mailbox_post(fromBaseStationMailbox, &test_command_msg,
-                        BIOS_WAIT_FOREVER);
+                roveCmdQueuePost(&test_command_msg);
 
                 ms_delay(MS_DELAY);
 
@@ -66,8 +67,7 @@ Void roveArmTester(UArg arg0, UArg arg1) {
                 System_flush();
 
                 memcpy(&test_command_msg, &robot_arm, sizeof(robot_arm));
-                Mailbox_post(fromBaseStationMailbox, &test_command_msg,
-                        BIOS_WAIT_FOREVER);
+                roveCmdQueuePost(&test_command_msg);
 
                 ms_delay(MS_DELAY);
 
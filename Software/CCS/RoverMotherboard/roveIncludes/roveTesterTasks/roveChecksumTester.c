@@ -0,0 +1,145 @@
+// roveChecksumTester.c MST MRDT
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+//
+// this implements a single function BIOS thread
+// that acts as the RoverMotherboard.cfg roveChecksumTesterTask handle
+//
+// This task would need to be activated in RoverMotherbaordMain.cfg gui with low pri,
+// it runs once and exits
+//
+// the rover half of Software/Tests/ChecksumBench: the CRC module is checked against the
+// CRC-16 table in roveChecksum at every frame length, which has to pass before
+// SERIAL_CRC_HARDWARE goes on, then every kernel is timed in cycles on the frame sizes the
+// rover sends. Everything goes to roveLog, read it with base_station_sync.py and rove_log.py
+//
+// this is a RoverMotherboard.cfg object::roveChecksumTesterTask::
+//
+// priority 1, 1024 persistent private stack
+
+#include "../roveWareHeaders/roveChecksumTester.h"
+
+#define CHECKSUM_TESTER_ROUNDS 1000
+
+#define CHECKSUM_TESTER_MAX 64
+
+// calcCheckSum before roveChecksumXor
+
+static uint8_t xorBytes(const uint8_t* data, uint8_t size, uint8_t seed) {
+
+    int i;
+
+    for (i = 0; i < size; i++) {
+
+        seed ^= data[i];
+
+    } //endfor
+
+    return seed;
+
+} //endfnctn xorBytes
+
+// calcCrc16 with the table, whatever SERIAL_CRC_HARDWARE says
+
+static uint16_t crcTable(const uint8_t* data, uint8_t size) {
+
+    return roveChecksumCrc16(data, size, roveChecksumCrc16(&size, 1, CHECKSUM_CRC16_SEED));
+
+} //endfnctn crcTable
+
+Void roveChecksumTester(UArg arg0, UArg arg1) {
+
+    // a motor_control_struct, the word loop cut over, the largest command, the longest frame
+    static const uint8_t sizes[] = { 5, CHECKSUM_XOR_WORD_MIN, 31, CHECKSUM_TESTER_MAX };
+
+    static uint8_t frame[CHECKSUM_TESTER_MAX + 1];
+    volatile uint32_t sink = 0;
+    uint32_t start;
+    int16_t cycles[4];
+    uint16_t hardware;
+    uint16_t table;
+    int matched = 0;
+    int length;
+    int size;
+    int round;
+
+    for (length = 0; length < sizeof(frame); length++) {
+
+        frame[length] = length * 37 + 11;
+
+    } //endfor
+
+    initSerialCrcHardware();
+
+    // DWT cycle counter, the same one the roveProfile probes read
+    roveProfileInit();
+
+    // the struct sits one byte off a word after the 3 byte frame header, so start at frame + 1
+    for (length = 1; length <= CHECKSUM_TESTER_MAX; length++) {
+
+        hardware = calcCrc16Hardware(frame + 1, length);
+        table = crcTable(frame + 1, length);
+
+        if (hardware == table) {
+
+            matched++;
+
+        } else {
+
+            roveLog(LOG_CHECKSUM_CRC_MISMATCH, length, hardware, table);
+
+        } //endif
+
+    } //endfor
+
+    roveLog(LOG_CHECKSUM_CRC_CHECKED, matched, CHECKSUM_TESTER_MAX, 0);
+
+    for (size = 0; size < sizeof(sizes); size++) {
+
+        start = PROFILE_CYCLE_COUNTER;
+
+        for (round = 0; round < CHECKSUM_TESTER_ROUNDS; round++) {
+
+            sink ^= xorBytes(frame + 1, sizes[size], sizes[size]);
+
+        } //endfor
+
+        cycles[0] = (PROFILE_CYCLE_COUNTER - start) / CHECKSUM_TESTER_ROUNDS;
+        start = PROFILE_CYCLE_COUNTER;
+
+        for (round = 0; round < CHECKSUM_TESTER_ROUNDS; round++) {
+
+            sink ^= roveChecksumXor(frame + 1, sizes[size], sizes[size]);
+
+        } //endfor
+
+        cycles[1] = (PROFILE_CYCLE_COUNTER - start) / CHECKSUM_TESTER_ROUNDS;
+        start = PROFILE_CYCLE_COUNTER;
+
+        for (round = 0; round < CHECKSUM_TESTER_ROUNDS; round++) {
+
+            sink ^= crcTable(frame + 1, sizes[size]);
+
+        } //endfor
+
+        cycles[2] = (PROFILE_CYCLE_COUNTER - start) / CHECKSUM_TESTER_ROUNDS;
+        start = PROFILE_CYCLE_COUNTER;
+
+        for (round = 0; round < CHECKSUM_TESTER_ROUNDS; round++) {
+
+            sink ^= calcCrc16Hardware(frame + 1, sizes[size]);
+
+        } //endfor
+
+        cycles[3] = (PROFILE_CYCLE_COUNTER - start) / CHECKSUM_TESTER_ROUNDS;
+
+        roveLog(LOG_CHECKSUM_XOR_CYCLES, sizes[size], cycles[0], cycles[1]);
+        roveLog(LOG_CHECKSUM_CRC_CYCLES, sizes[size], cycles[2], cycles[3]);
+
+    } //endfor
+
+} //endfnctn roveChecksumTester
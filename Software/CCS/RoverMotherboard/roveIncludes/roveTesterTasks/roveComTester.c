@@ -29,7 +29,7 @@ Void roveComTester(UArg arg0, UArg arg1) {
 
         ms_delay(1000);
 
-        Mailbox_post(fromBaseStationMailbox, &baseStationMsg, BIOS_WAIT_FOREVER);
+        roveCmdQueuePost(&baseStationMsg);
 
     }
     */
@@ -0,0 +1,86 @@
+// roveCalibration.h MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#pragma once
+
+#ifndef ROVECALIBRATION_H_
+#define ROVECALIBRATION_H_
+
+// only the C lib: this module also builds on a host for Software/Tests/CalibrationRef
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Per motor ESC calibration: DriveMotor speed (-1000 to 1000) to pulse width in microseconds
+//
+// every ESC has its own neutral, deadband and end points. Each side of neutral is a table of
+// CALIBRATION_POINTS pulse widths at fixed speeds: the first at speed 1, the edge of the
+// deadband, then every CALIBRATION_STEP up to full scale. Speed 0 is always neutral_us
+//
+// speeds between points are interpolated with slopes worked out when a table is set, so
+// roveCalibrationPulse is a table lookup, a multiply and a shift
+
+#define CALIBRATION_MOTORS 6
+#define CALIBRATION_POINTS 6
+#define CALIBRATION_FULL_SCALE 1000
+#define CALIBRATION_STEP (CALIBRATION_FULL_SCALE / (CALIBRATION_POINTS - 1))
+
+// anything outside this is not a servo pulse, the table is refused
+
+#define CALIBRATION_MIN_US 800
+#define CALIBRATION_MAX_US 2200
+
+// forward_us climbs and reverse_us falls away from neutral_us, point 0 at speed +1 / -1
+
+struct drive_calibration {
+
+    uint16_t neutral_us;
+    uint16_t forward_us[CALIBRATION_POINTS];
+    uint16_t reverse_us[CALIBRATION_POINTS];
+
+};
+
+// what goes in EEPROM: a whole number of words, checked by magic and checksum before use
+
+#define CALIBRATION_MAGIC 0x43414C31
+
+struct calibration_store {
+
+    uint32_t magic;
+    struct drive_calibration tables[CALIBRATION_MOTORS];
+    uint32_t checksum;
+
+};
+
+// Post: table is the old linear mapping, 1000 to 2000 us around 1500 with no deadband
+
+void roveCalibrationDefault(struct drive_calibration* table);
+
+// Post: every motor on the default table
+
+void roveCalibrationReset(void);
+
+// Post: returns false and changes nothing if the table is out of range or not monotonic
+
+bool roveCalibrationSet(int motor, const struct drive_calibration* table);
+
+void roveCalibrationGet(int motor, struct drive_calibration* table);
+
+// Post: returns the pulse width for speed, speed clamped to full scale
+
+uint16_t roveCalibrationPulse(int motor, int speed);
+
+// Post: store holds every motor's table, ready to write out
+
+void roveCalibrationStore(struct calibration_store* store);
+
+// Post: returns false and changes nothing unless magic, checksum and every table are good
+
+bool roveCalibrationRestore(const struct calibration_store* store);
+
+#endif // ROVECALIBRATION_H_
@@ -0,0 +1,40 @@
+// roveChecksum.h MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#pragma once
+
+#ifndef ROVECHECKSUM_H_
+#define ROVECHECKSUM_H_
+
+// only the C lib: this module also builds on a host for Software/Tests/ChecksumBench
+
+#include <stdint.h>
+
+// Checksum kernels for the rove serial frames (see roveStructTransfer.h)
+//
+// the legacy XOR is what every device speaks. It can't see two bytes swapped or the same
+// error in two bytes, so frames with the CRC-16/CCITT (poly 0x1021, seed 0xFFFF) trailer
+// exist too. On the rover the CRC normally runs on the TM4C1294 CRC module, this table
+// version is the fallback and what a host uses
+
+#define CHECKSUM_CRC16_SEED 0xFFFF
+
+// shorter than this, lining up on a word and folding the lanes costs more than it saves
+// (a 5 byte motor_control_struct). Measured by checksum_bench and roveChecksumTester
+
+#define CHECKSUM_XOR_WORD_MIN 8
+
+// Post: seed XORed with every byte of data, four at a time once data is word aligned
+
+uint8_t roveChecksumXor(const void* data, uint32_t size, uint8_t seed);
+
+// Post: crc carried on over data, start from CHECKSUM_CRC16_SEED
+
+uint16_t roveChecksumCrc16(const void* data, uint32_t size, uint16_t crc);
+
+#endif // ROVECHECKSUM_H_
@@ -0,0 +1,24 @@
+// roveChecksumTester.h MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#pragma once
+
+#ifndef ROVECHECKSUMTESTER_H_
+#define ROVECHECKSUMTESTER_H_
+
+//globally scoped Texas Instruments (TI) headers
+
+#include "../RoverMotherboardMain.h"
+
+//MRDesign Team::roveWare::		roveCom and RoveNet services headers
+
+#include "../mrdtRoveWare.h"
+
+Void roveChecksumTester(UArg arg0, UArg arg1);
+
+#endif //ROVECHECKSUMTESTER_H_
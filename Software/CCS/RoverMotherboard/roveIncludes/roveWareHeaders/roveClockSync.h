@@ -0,0 +1,65 @@
+// roveClockSync.h MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#pragma once
+
+#ifndef ROVECLOCKSYNC_H_
+#define ROVECLOCKSYNC_H_
+
+// globally scoped Texas Instruments (TI) headers
+
+#include "../RoverMotherboardMain.h"
+
+// MRDesign Team::roveWare::		roveCom and RoveNet services headers
+
+#include "../mrdtRoveWare.h"
+
+// Estimates the base station's microsecond clock from the rover, NTP style
+//
+// every CLOCK_SYNC_PERIOD_MS roveTcpSender sends a SYNCHRONIZE_STATUS with t1 (rover send time),
+// the base station answers with t2 (its receive time) and t3 (its send time), the answer lands at t4:
+//
+// 	offset = ((t2 - t1) + (t3 - t4)) / 2		base clock minus rover clock
+// 	delay  = (t4 - t1) - (t3 - t2)				network round trip
+//
+// of the last CLOCK_SYNC_WINDOW exchanges the one with the smallest delay is trusted,
+// it is the one least skewed by queuing in one direction
+
+// defined in roveStructs.h
+
+struct clock_sync_struct;
+struct clock_sync_telem;
+
+// call on every new base station connection, conversions are invalid until the next answer
+
+void roveClockSyncReset(void);
+
+// Post: request filled in with t1, ready to send
+
+void roveClockSyncBuild(struct clock_sync_struct* request);
+
+// Pre: reply is the base station's answer to a roveClockSyncBuild request
+// Post: taken into the window only if it answers the latest request, anything else is dropped
+
+void roveClockSyncUpdate(const struct clock_sync_struct* reply);
+
+// true once the base station has answered at least once on this connection
+
+bool roveClockSyncIsValid(void);
+
+// convert between roveGetMicros() time and base station time
+
+uint32_t roveClockToBase(uint32_t rover_us);
+
+uint32_t roveClockFromBase(uint32_t base_us);
+
+// Post: report holds the offset and delay currently in use
+
+void roveClockSyncReport(struct clock_sync_telem* report);
+
+#endif // ROVECLOCKSYNC_H_
@@ -0,0 +1,94 @@
+// roveCmdExpiry.h MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#pragma once
+
+#ifndef ROVECMDEXPIRY_H_
+#define ROVECMDEXPIRY_H_
+
+// only the C lib: this module also builds on a host for Software/Tests/CmdExpiry
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Drops drive and arm commands that are too old to act on
+//
+// a command sent as ROVER_COMMAND_STAMPED carries the base station's sequence number and send time.
+// roveCmdCntrl drops it when
+//
+// 	CMD_DROP_STALE			it is older than the max age (needs roveClockSync to be valid)
+// 	CMD_DROP_OUT_OF_ORDER	a newer command of the same class was already applied
+//
+// plain ROVER_COMMANDs have neither and are always applied. So are stop commands (e_stop_arm,
+// a zero drive speed) however late or out of order: acting on an old stop only stops the rover
+//
+// roveCmdCntrl turns each stamped command into a cmd_stamp, with its age from roveClockSync
+
+#define CMD_ACCEPT 0
+#define CMD_DROP_STALE 1
+#define CMD_DROP_OUT_OF_ORDER 2
+
+// commands are ordered within a class, a drive command says nothing about the arm
+
+#define CMD_CLASS_NONE -1
+#define CMD_CLASS_DRIVE 0
+#define CMD_CLASS_ARM 1
+#define CMD_CLASS_COUNT 2
+
+struct cmd_stamp {
+
+    int cmd_class;
+    uint16_t seq;
+
+    // stops everything the command moves
+    bool stop;
+
+    // false until roveClockSync is valid, there is nothing to judge the age by
+    bool age_known;
+    int32_t age_us;
+
+};
+
+// counters since boot, filled into a command_expiry_telem by roveTcpHandler
+
+struct cmd_expiry_stats {
+
+    uint16_t max_age_ms;
+    uint32_t accepted;
+    uint32_t dropped_stale;
+    uint32_t dropped_out_of_order;
+    uint32_t unchecked_age;
+    uint32_t late_stops;
+    uint32_t latency_avg_us;
+    uint32_t latency_max_us;
+
+};
+
+// call on every new base station connection, the base station may restart its numbering
+
+void roveCmdExpiryReset(void);
+
+// max age in milliseconds, 0 turns the age check off
+
+void roveCmdExpirySetMaxAge(uint16_t max_age_ms);
+
+// Pre: stamp is of a stamped command of cmd_class other than CMD_CLASS_NONE
+// returns CMD_ACCEPT or the reason it should be dropped, and counts it
+
+int roveCmdExpiryCheck(const struct cmd_stamp* stamp);
+
+// Pre: a stamped command was accepted and has just been written to the PWM / uart
+// Post: its one way base send -> actuation latency recorded
+
+void roveCmdExpiryApplied(uint32_t latency_us);
+
+// Post: stats holds the counters by reason and the latency seen
+
+void roveCmdExpiryStats(struct cmd_expiry_stats* stats);
+
+#endif // ROVECMDEXPIRY_H_
@@ -0,0 +1,60 @@
+// roveCmdQueue.h MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#pragma once
+
+#ifndef ROVECMDQUEUE_H_
+#define ROVECMDQUEUE_H_
+
+// globally scoped Texas Instruments (TI) headers
+
+#include "../RoverMotherboardMain.h"
+
+// MRDesign Team::roveWare::		roveCom and RoveNet services headers
+
+#include "../mrdtRoveWare.h"
+
+// Command queue from roveTcpHandler to roveCmdCntrl, replaces the fromBaseStationMailbox
+//
+// a roveQueue of roveMsgPool buffer indices: the command itself stays in its pool buffer, a
+// post is a one byte record and a Semaphore_post rather than a Mailbox's slot copy and two
+// semaphores. One task posts at a time: roveTcpHandler, or a tester task in its place
+
+// defined in roveStructs.h
+
+struct base_station_msg_struct;
+
+// Pre: called from main before BIOS_start
+
+void roveCmdQueueInit(void);
+
+// Pre: buffer came from roveMsgPoolAlloc and holds a command, roveCmdCntrl now owns it
+// Post: buffer queued, waits a tick at a time while the queue is full
+
+void roveCmdQueuePostBuffer(int buffer);
+
+// Post: message copied into a pool buffer and queued, for commands made on the rover
+
+void roveCmdQueuePost(const struct base_station_msg_struct* message);
+
+// Post: pool buffer of the oldest command, waits on fromBaseStationSemaphore while there is
+// none. The caller frees it with roveMsgPoolFree. -1 if roveCmdQueueWake woke it first
+
+int roveCmdQueuePend(void);
+
+// Post: roveCmdCntrl's pend returns, with -1 if nothing is queued. Safe from a Hwi
+
+void roveCmdQueueWake(void);
+
+// commands waiting right now, and the most ever waiting at once
+
+int roveCmdQueueCount(void);
+
+int roveCmdQueueHighWater(void);
+
+#endif // ROVECMDQUEUE_H_
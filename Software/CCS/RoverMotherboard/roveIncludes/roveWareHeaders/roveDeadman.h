@@ -0,0 +1,59 @@
+// roveDeadman.h MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#pragma once
+
+#ifndef ROVEDEADMAN_H_
+#define ROVEDEADMAN_H_
+
+// only the C lib: this module also builds on a host for Software/Tests/DeadmanSim
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Deadman failsafe for the actuator groups
+//
+// every command roveCmdCntrl applies feeds its group's deadman. A group that goes
+// window_ms without being fed has its neutral function called once, straight from the
+// deadmanTimer Hwi (see roveHardwareAbstraction.c), so a stalled link stops the rover
+// without waiting on any task or on the socket timeout
+//
+// time only moves when roveDeadmanTick() is called, so a host simulation can drive it with virtual time
+
+#define DEADMAN_LEFT_DRIVE 0
+#define DEADMAN_RIGHT_DRIVE 1
+#define DEADMAN_ARM 2
+#define DEADMAN_GROUP_COUNT 3
+
+// Pre: called before the timer starts ticking
+// Post: group is disarmed until its first feed, neutral is called from the tick's context when it expires
+
+void roveDeadmanInit(int group, uint32_t window_ms, void (*neutral)(void));
+
+// window_ms of 0 disables the group
+
+void roveDeadmanSetWindow(int group, uint32_t window_ms);
+
+// Post: group re-armed to expire window_ms from now, safe from any task
+
+void roveDeadmanFeed(int group);
+
+// Pre: called every elapsed_ms from the deadman timer Hwi (or a simulation)
+// Post: every armed group past its deadline is neutralized and disarmed
+
+void roveDeadmanTick(uint32_t elapsed_ms);
+
+// true from the moment a group expires until it is fed again
+
+bool roveDeadmanIsTripped(int group);
+
+// times the group has been neutralized
+
+uint32_t roveDeadmanTrips(int group);
+
+#endif // ROVEDEADMAN_H_
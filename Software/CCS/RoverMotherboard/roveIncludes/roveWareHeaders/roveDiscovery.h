@@ -0,0 +1,56 @@
+// roveDiscovery.h MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#pragma once
+
+#ifndef ROVEDISCOVERY_H_
+#define ROVEDISCOVERY_H_
+
+// globally scoped Texas Instruments (TI) headers
+
+#include "../RoverMotherboardMain.h"
+
+// MRDesign Team::roveWare::		roveCom and RoveNet services headers
+
+#include "../mrdtRoveWare.h"
+
+// Boot time device discovery on the RS485 jacks
+//
+// every jack is sent a mobo_identify_req and given DISCOVERY_REPLY_TIMEOUT_MS to answer with a
+// dev_identify_reply. Jacks behind one uart share its mux and are probed one after another,
+// the uarts are probed in parallel, one task each, so the scan takes as long as the uart with
+// the most jacks. A lane still going at DISCOVERY_TIMEOUT_MS stops after the jack it is on and
+// the scan waits for it, so no lane is left on a uart once the scan returns
+//
+// a device answers with the first struct id it handles (wrist_clock_wise for the arm,
+// PTZ_Cam_id_n for a camera), and every id it owns is routed to the jack it answered on.
+// getDeviceJack asks here first and falls back to its fixed jacks for anything not found.
+// Nothing is probed unless DISCOVERY_ENABLED
+
+#define DISCOVERY_NO_JACK 0
+
+// discovery_telem device_id for a jack with no device on it
+
+#define DISCOVERY_SILENT 0
+#define DISCOVERY_NOT_PROBED 254
+#define DISCOVERY_BAD_REPLY 255
+
+// Pre: BIOS started, uarts open, nothing else using jacks DISCOVERY_FIRST_JACK on
+// Post: routing table built, what answered on each jack in roveLog
+
+void roveDiscoveryScan(void);
+
+// Post: returns the jack the device owning struct_id answered on, or DISCOVERY_NO_JACK
+
+int roveDiscoveryJack(uint8_t struct_id);
+
+struct discovery_telem;
+
+void roveDiscoveryReport(struct discovery_telem* report);
+
+#endif // ROVEDISCOVERY_H_
@@ -0,0 +1,136 @@
+// roveFragment.h MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#pragma once
+
+#ifndef ROVEFRAGMENT_H_
+#define ROVEFRAGMENT_H_
+
+// only the C lib: this module also builds on a host for Software/Tests/FragmentLoopback,
+// and on a device board
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Fragmentation of messages longer than one rove struct
+//
+// a message is any rove struct, its struct id first, of up to 65535 bytes. It is cut into
+// fragment_structs that each carry FRAGMENT_DATA_SIZE bytes of it, and those are ordinary
+// 30 byte rove structs: they go through the serial frames, roveMsgPool and roveCmdQueue like
+// any command or telemetry. The last fragment is padded with zeros
+//
+// the receiver puts one message back together at a time, in a buffer of its own. Fragments
+// must arrive in order, as they do on a uart: a gap, a fragment of another message or a
+// message that stalls for longer than the timeout throws the partial message away
+
+// header, and the message bytes one fragment holds so it is no bigger than MAX_TELEM_SIZE
+
+#define FRAGMENT_HEADER_SIZE 6
+#define FRAGMENT_DATA_SIZE 24
+
+// most fragments of a message, the index is a byte
+
+#define FRAGMENT_MAX_COUNT 256
+
+// destination is the message's struct id, so each fragment can be routed on its own.
+// message_id counts up per sender and tells one message's fragments from the next
+
+struct fragment_struct {
+
+    uint8_t struct_id;
+    uint8_t destination;
+    uint8_t message_id;
+    uint8_t index;
+    uint16_t total_length;
+    uint8_t data[FRAGMENT_DATA_SIZE];
+
+}__attribute__((packed));
+
+// counters for both directions, from boot. Bytes are message bytes, without the fragment headers
+// or padding, and a message's bytes are counted received once it is whole. dropped counts
+// fragments: those refused and those of partial messages thrown away, timeouts the messages
+// thrown away because they stalled
+
+struct fragment_stats {
+
+    uint32_t messages_sent;
+    uint32_t messages_received;
+    uint32_t fragments_sent;
+    uint32_t fragments_received;
+    uint32_t bytes_sent;
+    uint32_t bytes_received;
+    uint32_t timeouts;
+    uint32_t dropped;
+
+};
+
+struct fragment_reassembly {
+
+    uint8_t* buffer;
+    uint16_t size;
+    uint32_t timeout_ms;
+
+    // the message being put together: next is the index expected, last_ms when a fragment came
+    bool active;
+    uint8_t destination;
+    uint8_t message_id;
+    uint16_t total_length;
+    uint16_t next;
+    uint32_t last_ms;
+
+    struct fragment_stats* stats;
+
+};
+
+// roveFragmentAccept results
+
+#define FRAGMENT_PENDING 0
+#define FRAGMENT_COMPLETE 1
+#define FRAGMENT_DROPPED -1
+
+// fragments a message of total_length bytes is sent in, 0 if it is too long or empty
+
+int roveFragmentCount(uint16_t total_length);
+
+// struct_id is the id fragments go by, fragment_id in mrdtRoveWare.h
+
+// Pre: index < roveFragmentCount(total_length)
+// Post: header of fragment index filled in and its data zeroed, returns how many message
+// bytes go in its data. For a sender that writes the data itself, straight from a socket
+
+int roveFragmentPrepare(struct fragment_struct* fragment, uint8_t struct_id, uint8_t destination,
+        uint8_t message_id, uint8_t index, uint16_t total_length);
+
+// Post: fragment index of message, returns the message bytes in it
+
+int roveFragmentSplit(struct fragment_struct* fragment, uint8_t struct_id, uint8_t message_id,
+        uint8_t index, const void* message, uint16_t total_length);
+
+// Post: fragment counted in stats as sent, and its message once this is the last fragment
+
+void roveFragmentCountSent(struct fragment_stats* stats, const struct fragment_struct* fragment);
+
+// Pre: buffer holds size bytes, the longest message taken. stats may be shared with the sender
+// Post: nothing being reassembled
+
+void roveFragmentReassemblyInit(struct fragment_reassembly* reassembly, uint8_t* buffer,
+        uint16_t size, uint32_t timeout_ms, struct fragment_stats* stats);
+
+// now_ms is any millisecond clock that wraps at 32 bits
+// Post: FRAGMENT_COMPLETE with the whole message in buffer, its length in total_length, until
+// the next call. FRAGMENT_DROPPED when this fragment or the message it belonged to was thrown
+// away, otherwise FRAGMENT_PENDING
+
+int roveFragmentAccept(struct fragment_reassembly* reassembly,
+        const struct fragment_struct* fragment, uint32_t now_ms);
+
+// Post: a partial message older than the timeout thrown away, returns true if there was one
+
+bool roveFragmentExpire(struct fragment_reassembly* reassembly, uint32_t now_ms);
+
+#endif // ROVEFRAGMENT_H_
@@ -0,0 +1,62 @@
+// roveFragmentLink.h MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#pragma once
+
+#ifndef ROVEFRAGMENTLINK_H_
+#define ROVEFRAGMENTLINK_H_
+
+// globally scoped Texas Instruments (TI) headers
+
+#include "../RoverMotherboardMain.h"
+
+// MRDesign Team::roveWare::		roveCom and RoveNet services headers
+
+#include "../mrdtRoveWare.h"
+
+// Long messages through the rover, with roveFragment
+//
+// TCP has no size limit, so a long message crosses it whole as a ROVER_LONG_MESSAGE:
+// [0x0D][u16 length][the message, struct id first]. The uarts get it as fragment_structs
+//
+// base station to device: roveTcpHandler cuts the message into fragments as it reads it, each
+// straight into a roveMsgPool buffer, and posts them to roveCmdCntrl like commands. roveCmdCntrl
+// sends each to the jack of its destination. Nothing on the rover holds the whole message
+//
+// device to base station: roveTelemCntrl puts the fragments back together in one static buffer
+// and queues the whole message for roveTcpSender, which sends it the next time it wakes. The
+// fragments never go through roveTelemPolicy or roveTelemQueue, which would merge or drop them
+
+// defined in roveStructs.h
+
+struct fragment_telem;
+
+// Pre: called from main before BIOS_start
+
+void roveFragmentLinkInit(void);
+
+// roveTelemCntrl only
+// Post: fragment from a device taken in, a message it completes queued for roveTcpSender
+
+void roveFragmentLinkReceive(const char* fragment);
+
+// roveTcpSender only
+// Post: oldest whole device message copied into message, returns its length or -1 for none
+
+int roveFragmentLinkTake(char message[FRAGMENT_MAX_MESSAGE]);
+
+// roveCmdCntrl only
+// Post: a fragment written to a device counted
+
+void roveFragmentLinkSent(const struct fragment_struct* fragment);
+
+// Post: counters since boot in a fragment_telem, ready for roveTelemQueuePost
+
+void roveFragmentLinkReport(struct fragment_telem* report);
+
+#endif // ROVEFRAGMENTLINK_H_
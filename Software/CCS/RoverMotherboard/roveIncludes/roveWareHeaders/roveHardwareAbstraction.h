@@ -55,6 +55,73 @@ void pwmWrite(PWM_Handle pin, int val);
 
 void DriveMotor(PWM_Handle motor, int speed);
 
+// batched drive motor update over the PWM0 generators
+//
+// DriveMotor goes through the TI driver one output at a time. Stage every motor that
+// changes, then commit: the compare registers are written back to back and latched
+// with one PWMSyncUpdate, so all six outputs change on the same period boundary
+
+// Post: drive motor (0 to DRIVE_MOTOR_COUNT - 1) open at its DRIVE_PWM_PERIOD_US frame
+
+PWM_Handle roveDrivePWMInit(int motor);
+
+// Pre: all six motors opened with roveDrivePWMInit
+// Post: pulse width scaling cached, periods and duties latched
+
+void rovePWMSyncInit(void);
+
+// Post: speed held for motor (0 to DRIVE_MOTOR_COUNT - 1) as that motor's calibrated pulse width, outputs unchanged
+
+void DriveMotorStage(int motor, int speed);
+
+// Post: every staged motor changes at the next period boundary, safe from any task or Hwi
+
+void DriveMotorCommit(void);
+
+// drive ESC calibration (see roveCalibration.h)
+
+struct drive_calibration;
+
+// Post: tables read from EEPROM, or the default linear tables if it holds none
+
+void roveCalibrationLoad(void);
+
+// Post: returns false if the EEPROM write failed
+
+bool roveCalibrationSave(void);
+
+// Post: returns false for a bad table, otherwise motor is re-driven at its current speed with the new table
+
+bool roveCalibrationApply(int motor, const struct drive_calibration* table);
+
+// drive motion profile (see roveMotionProfile.h)
+
+// Post: every drive motor ramps at MOTION_ACCEL_LIMIT / MOTION_JERK_LIMIT, and is speed
+// controlled with the SPEED_CONTROL gains when SPEED_CONTROL_CLOSED_LOOP is set
+
+void roveDriveProfileInit(void);
+
+// RoverMotherboard.cfg roveMotionProfileClock function, Swi context:
+// steps all six ramps (and speed loops) and commits the ones that moved in one synchronized update
+
+Void roveMotionProfileTick(UArg arg);
+
+// deadman failsafe hardware (see roveDeadman.h)
+
+// Pre: motor PWMs and uarts open
+// Post: drive sides and the arm are watched by the deadmanTimer from BIOS_start
+
+void roveDeadmanInitGroups(void);
+
+// RoverMotherboard.cfg deadmanTimer function, Hwi context
+
+Void roveDeadmanTimerIsr(UArg arg);
+
+// roveCmdCntrl only: true once after the arm deadman expires, it then sends the arm an e_stop_arm.
+// The deadman wakes it with roveCmdQueueWake, uart7 is never written from the Hwi
+
+bool roveDeadmanArmStopTake(void);
+
 // deviceWrite sends data passed to it to the specified RS485 jack.
 // It will deal with properly muxing to the device and writing to the uart
 //    internally
@@ -0,0 +1,47 @@
+// roveHealth.h MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#pragma once
+
+#ifndef ROVEHEALTH_H_
+#define ROVEHEALTH_H_
+
+// globally scoped Texas Instruments (TI) headers
+
+#include "../RoverMotherboardMain.h"
+
+// MRDesign Team::roveWare::		roveCom and RoveNet services headers
+
+#include "../mrdtRoveWare.h"
+
+// CPU load, stack and heap use for sizing the RoverMotherboard.cfg objects from real numbers
+//
+// the loads come from ti.sysbios.utils.Load, which the idle task updates every Load.windowInMs.
+// A stack's peak is how much of the fill pattern BIOS wrote into it at create is gone, so it is
+// the worst since the task started. Every task is reported, the static ones from the cfg and
+// the ones made at run time (roveTcpSender, the NDK stack thread, readIntTask while it waits)
+//
+// roveTcpSender sends a system_health_telem every HEALTH_PERIOD_MS through the normal telemetry
+// queue, and after it the task_health_telem of the next HEALTH_TASKS_PER_PERIOD tasks in turn
+
+// defined in roveStructs.h
+
+struct system_health_telem;
+struct task_health_telem;
+
+// Post: every task's load and stack read in one pass, report holds the system totals,
+// returns how many task_health_telem roveHealthTaskReport has for this pass
+
+int roveHealthReport(struct system_health_telem* report);
+
+// Pre: roveHealthReport returned more than task
+// Post: report holds that task as of the last roveHealthReport
+
+void roveHealthTaskReport(int task, struct task_health_telem* report);
+
+#endif // ROVEHEALTH_H_
@@ -0,0 +1,69 @@
+// roveKinematics.h MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#pragma once
+
+#ifndef ROVEKINEMATICS_H_
+#define ROVEKINEMATICS_H_
+
+// only the C lib: this module also builds on a host for Software/Tests/KinematicsRef
+
+#include <stdint.h>
+
+// Differential drive kinematics and wheel mixing, all fixed point
+//
+// wheels are in motor_0 ... motor_5 order, right side first. Wheel speeds come out in
+// DriveMotor units (-1000 to 1000) with each motor's direction already applied
+//
+// 	side speed		linear_mm_s -/+ angular_mrad_s * track_width_mm / 2000	(left -, right +)
+// 	wheel command	side speed * 1000 / max_wheel_speed_mm_s * trim
+//
+// when any wheel would pass full scale every wheel is scaled down by the same factor,
+// so the rover slows down on the arc it was asked for instead of turning tighter
+
+#define KINEMATICS_WHEEL_COUNT 6
+#define KINEMATICS_RIGHT_FIRST 0
+#define KINEMATICS_LEFT_FIRST 3
+#define KINEMATICS_SIDE_COUNT 3
+
+#define KINEMATICS_FULL_SCALE 1000
+
+// trim is Q12: 4096 is unity gain
+
+#define KINEMATICS_TRIM_ONE 4096
+
+struct kinematics_config {
+
+    uint16_t track_width_mm;
+    uint16_t max_wheel_speed_mm_s;
+    int8_t direction[KINEMATICS_WHEEL_COUNT];
+    uint16_t trim_q12[KINEMATICS_WHEEL_COUNT];
+
+};
+
+// Post: config copied, takes effect on the next call. Until the first call every wheel comes out 0
+
+void roveKinematicsConfigure(const struct kinematics_config* config);
+
+// Post: wheel holds the command for every motor to drive at linear_mm_s (forward positive)
+// while turning at angular_mrad_s (counter clockwise positive)
+
+void roveKinematicsTwist(int32_t linear_mm_s, int32_t angular_mrad_s,
+        int16_t wheel[KINEMATICS_WHEEL_COUNT]);
+
+// Pre: forward holds a forward positive speed per wheel, -1000 to 1000
+// Post: wheel holds the motor commands, trimmed and saturated together
+
+void roveKinematicsMix(const int32_t forward[KINEMATICS_WHEEL_COUNT],
+        int16_t wheel[KINEMATICS_WHEEL_COUNT]);
+
+// one wheel on its own (for the single side messages): trimmed, clamped and direction applied
+
+int16_t roveKinematicsWheel(int wheel, int32_t forward);
+
+#endif // ROVEKINEMATICS_H_
@@ -0,0 +1,69 @@
+// roveLinkStats.h MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#pragma once
+
+#ifndef ROVELINKSTATS_H_
+#define ROVELINKSTATS_H_
+
+// globally scoped Texas Instruments (TI) headers
+
+#include "../RoverMotherboardMain.h"
+
+// MRDesign Team::roveWare::		roveCom and RoveNet services headers
+
+#include "../mrdtRoveWare.h"
+
+// Application heartbeat on the base station link
+//
+// roveTcpSender sends a ROVER_HEARTBEAT every HEARTBEAT_PERIOD_MS with its own send time,
+// the base station echoes it back with the times it received and answered it:
+//
+// 	rtt = (rover_rx - rover_tx) - (base_tx - base_rx)
+//
+// so time spent inside the base station doesn't count. The last LINK_RTT_WINDOW rtts
+// give the percentiles reported in link_stats_telem, and no echo for HEARTBEAT_TIMEOUT_MS
+// means the link is dead long before TCP would notice
+//
+// all of it only with LINK_HEARTBEAT_ENABLED, otherwise the link is TCP's to watch
+
+// defined in roveStructs.h
+
+struct heartbeat_struct;
+struct link_stats_telem;
+
+// call on every new base station connection
+
+void roveLinkStatsReset(void);
+
+// Post: heartbeat filled in with the next sequence number and the current time, ready to send
+
+void roveLinkHeartbeatBuild(struct heartbeat_struct* heartbeat);
+
+// Pre: heartbeat is an echo just received from the base station
+// Post: rtt estimate and window updated
+
+void roveLinkHeartbeatEcho(const struct heartbeat_struct* heartbeat);
+
+// true once the base station has echoed at least once and then went quiet for HEARTBEAT_TIMEOUT_MS
+
+bool roveLinkIsDead(void);
+
+// roveTcpSender only: one telemetry message went out, counted in link_stats_telem
+
+void roveLinkTelemSent(void);
+
+// latest smoothed rtt in microseconds, 0 before the first echo
+
+uint32_t roveLinkSmoothedRtt(void);
+
+// Post: report holds the rtt percentiles over the window and the heartbeat loss count
+
+void roveLinkStatsReport(struct link_stats_telem* report);
+
+#endif // ROVELINKSTATS_H_
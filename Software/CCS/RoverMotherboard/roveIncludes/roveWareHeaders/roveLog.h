@@ -0,0 +1,165 @@
+// roveLog.h MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#pragma once
+
+#ifndef ROVELOG_H_
+#define ROVELOG_H_
+
+// only the C lib: this module also builds on a host for Software/Tests/RoveLog
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Binary event log in place of printf / System_printf
+//
+// an event is its id, the time in roveGetMicros and up to three small arguments, written into
+// a RAM ring of LOG_RING_SIZE entries. Nothing is formatted on the rover: printf goes out over
+// the debugger one call at a time and SysMin only holds 128 bytes, this costs a few stores and
+// keeps the last LOG_RING_SIZE events
+//
+// the ring goes to the base station as a ROVER_DIAGNOSTIC DIAGNOSTIC_LOG and
+// Software/Tests/RoveLog/rove_log.py turns it back into text with the format in the comment
+// after each id below. Keep them on one line like the others, the decoder reads this file.
+// Ids are never reused, a retired event keeps its number
+//
+// the clock and the interrupt lock come from roveLogInit, so the ring itself is plain C
+
+// events kept, a power of 2 and at most 128 so an entry's tag can tell this lap from the last
+
+#define LOG_RING_SIZE 128
+
+// roveTcpHandler
+
+#define LOG_TCP_INIT 1 						// "roveTcpHandler init"
+#define LOG_TCP_CONNECTING 2 				// "roveTcpHandler attempting to connect"
+#define LOG_TCP_CONNECT_RESULT 3 			// "roveTcpHandler connect attempt finished, connected %d"
+#define LOG_TCP_SOCKET_FAILED 4 			// "roveTcpHandler socket() failed, fdError %d"
+#define LOG_TCP_CONNECT_FAILED 5 			// "roveTcpHandler connect() failed, fdError %d"
+#define LOG_TCP_WATCHDOG_CLEARED 6 			// "roveTcpHandler base station refused, watchdog cleared"
+#define LOG_TCP_SPAWN_SENDER 7 				// "roveTcpHandler spawning roveTcpSender"
+#define LOG_TCP_SENDER_FAILED 8 			// "roveTcpHandler could not create roveTcpSender"
+#define LOG_TCP_JSON 9 						// "roveTcpHandler got a JSON start byte, unable to parse"
+#define LOG_TCP_UNKNOWN_TYPE 10 			// "roveTcpHandler message type %d not recognized"
+#define LOG_TCP_BAD_STRUCT_ID 11 			// "roveTcpHandler invalid struct id %d, skipping"
+#define LOG_TCP_UNKNOWN_DIAGNOSTIC 12 		// "roveTcpHandler diagnostic %d not recognized"
+#define LOG_TCP_POLICY_FULL 13 				// "roveTcpHandler telem policy table full, id %d not managed"
+#define LOG_TCP_CLOSED 14 					// "roveTcpHandler connection has been closed"
+#define LOG_TCP_LOST 15 					// "roveTcpHandler connection lost"
+#define LOG_TCP_EXIT 16 					// "roveTcpHandler task error: forced exit"
+#define LOG_TCP_BAD_LONG_MESSAGE 17 		// "roveTcpHandler long message of %d bytes can not be fragmented, skipped"
+#define LOG_TCP_BAD_POLICY_MODE 18 			// "roveTcpHandler telem policy for id %d has unknown mode %d, ignored"
+
+// roveTcpSender
+
+// retired: one event per message pushed everything else out of the ring, see link_stats_telem telem_sent
+#define LOG_SENDER_SENT 20 					// "roveTcpSender sent telem id %d"
+#define LOG_SENDER_LINK_DEAD 21 			// "roveTcpSender no heartbeat echo for %d ms, dropping link"
+#define LOG_SENDER_CLOSED 22 				// "roveTcpSender connection closed, cleaning up"
+
+// roveCmdCntrl and roveTelemCntrl
+
+#define LOG_CMD_INIT 30 					// "roveCmdCntrl init"
+#define LOG_CMD_CALIBRATION_REJECTED 31 	// "roveCmdCntrl rejected calibration for motor %d"
+#define LOG_CMD_CALIBRATION_SAVE_FAILED 32 	// "roveCmdCntrl calibration EEPROM write failed"
+#define LOG_CMD_EXIT 33 					// "roveCmdCntrl task error: forced exit"
+#define LOG_TELEM_EXIT 34 					// "roveTelemCntrl task error: forced exit"
+#define LOG_CMD_FRAGMENT_NO_JACK 35 		// "roveCmdCntrl no jack for a fragment to device %d, dropped"
+#define LOG_CMD_NO_JACK 36 					// "roveCmdCntrl no jack for struct id %d, dropped"
+
+// RoverMotherboardMain
+
+#define LOG_MAIN_INIT_UARTS 40 				// "main init uarts"
+#define LOG_MAIN_INIT_PWM 41 				// "main init PWM"
+#define LOG_MAIN_ASSIGN_UARTS 42 			// "main assign uarts"
+#define LOG_MAIN_INIT 43 					// "main init done, starting BIOS"
+
+// roveHardwareAbstraction
+
+#define LOG_HAL_NULL_DEVICE 50 				// "getDeviceJack passed null device %d"
+#define LOG_HAL_INVALID_DEVICE 51 			// "getDeviceJack passed invalid device %d"
+#define LOG_HAL_INVALID_PIN 52 				// "digitalWrite passed invalid pin %d, value %d"
+#define LOG_HAL_DEPRECATED_JACK 53 			// "deviceWrite called with deprecated jack %d, now used for PWM"
+#define LOG_HAL_INVALID_JACK 54 			// "deviceWrite passed invalid jack %d"
+#define LOG_HAL_INVALID_READ_JACK 55 		// "deviceRead passed invalid jack %d, only GPS_ON_MOB is read"
+#define LOG_HAL_READ_SLEEP 56 				// "readIntTask sleeping %d ticks"
+#define LOG_HAL_READ_CANCELED 57 			// "readIntTask canceled uart read"
+#define LOG_HAL_READ_TASK_FAILED 58 		// "UART_read_nonblocking could not create readIntTask"
+#define LOG_HAL_EEPROM_FAILED 59 			// "roveCalibrationLoad EEPROM init failed, default tables"
+#define LOG_HAL_NO_CALIBRATION 60 			// "roveCalibrationLoad no saved tables, default tables"
+#define LOG_STRUCT_BAD_SIZE 61 				// "buildSerialStructMessage struct id %d has no valid size"
+
+// roveDiscovery
+
+#define LOG_DISCOVERY_LANE_FAILED 70 		// "roveDiscovery could not start lane %d"
+#define LOG_DISCOVERY_LANE_TIMEOUT 71 		// "roveDiscovery lane %d timed out"
+#define LOG_DISCOVERY_DUPLICATE 72 			// "roveDiscovery id %d on jacks %d and %d, using the first"
+#define LOG_DISCOVERY_SCAN 73 				// "roveDiscovery %d jacks in %d ms (%d ms one at a time)"
+#define LOG_DISCOVERY_SILENT 74 			// "roveDiscovery jack %d: nothing"
+#define LOG_DISCOVERY_BAD_REPLY 75 			// "roveDiscovery jack %d: bad reply"
+#define LOG_DISCOVERY_FOUND 76 				// "roveDiscovery jack %d: device %d"
+
+// roveFragmentLink
+
+#define LOG_FRAGMENT_QUEUE_FULL 80 			// "roveFragmentLink no room for a %d byte message from device id %d"
+
+// roveChecksumTester
+
+#define LOG_CHECKSUM_CRC_MISMATCH 90 		// "roveChecksumTester %d bytes: CRC module %d, table %d"
+#define LOG_CHECKSUM_CRC_CHECKED 91 		// "roveChecksumTester CRC module matched the table at %d of %d lengths"
+#define LOG_CHECKSUM_XOR_CYCLES 92 			// "roveChecksumTester XOR of %d bytes: %d cycles byte loop, %d roveChecksumXor"
+#define LOG_CHECKSUM_CRC_CYCLES 93 			// "roveChecksumTester CRC-16 of %d bytes: %d cycles table, %d CRC module"
+
+// one event, 12 bytes. tag is written last, in one store: the low byte is the event and the
+// high byte the low bits of its place in the log, so a reader can tell a finished entry from
+// one still being written or left from the lap before
+
+struct log_entry {
+
+    uint32_t us;
+    int16_t arg[3];
+    uint16_t tag;
+
+}__attribute__((packed));
+
+// header of a DIAGNOSTIC_LOG, followed by its entries, oldest first. first is the place in the
+// log of the oldest, written how many events there have been since boot
+
+struct log_report {
+
+    uint32_t now_us;
+    uint32_t first;
+    uint32_t written;
+    uint16_t entries;
+    uint8_t entry_size;
+
+}__attribute__((packed));
+
+// Pre: main, before BIOS_start. Until then events have time 0 and take no lock, only main runs
+// Post: events are stamped with clock, and each takes its place in the ring between lock and
+// unlock (Hwi_disable and Hwi_restore in the firmware)
+
+void roveLogInit(uint32_t (*clock)(void), uint32_t (*lock)(void), void (*unlock)(uint32_t key));
+
+// Post: event and its arguments in the ring, safe from any thread including a Hwi
+
+void roveLog(uint8_t event, int16_t arg0, int16_t arg1, int16_t arg2);
+
+#define roveLogEvent(event) roveLog((event), 0, 0, 0)
+
+// Post: report filled in and entries holds its report->entries finished events, oldest first
+
+void roveLogSnapshot(struct log_report* report, struct log_entry entries[LOG_RING_SIZE]);
+
+// a base station asked for the log: roveTcpHandler sets it, roveTcpSender takes it and sends
+
+void roveLogRequest(void);
+
+bool roveLogTakeRequest(void);
+
+#endif // ROVELOG_H_
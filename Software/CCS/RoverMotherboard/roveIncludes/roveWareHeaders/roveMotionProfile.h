@@ -0,0 +1,56 @@
+// roveMotionProfile.h MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#pragma once
+
+#ifndef ROVEMOTIONPROFILE_H_
+#define ROVEMOTIONPROFILE_H_
+
+// only the C lib: this module also builds on a host for Software/Tests/MotionProfileSim
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Per motor acceleration and jerk limited speed profile
+//
+// roveCmdCntrl only sets targets. roveMotionProfileClock steps every motor at
+// MOTION_PROFILE_RATE_HZ and stages what changed for one DriveMotorCommit, so a full
+// reversal ramps through neutral instead of stepping across it
+//
+// speeds are DriveMotor units (-1000 to 1000), kept in Q16 between ticks. The accel
+// toward the target is capped so it can always be ramped back to zero at the jerk limit
+// by the time the target is reached, which is what stops the profile overshooting
+
+#define MOTION_PROFILE_MOTORS 6
+
+// Post: motor limited to accel_limit units/s and jerk_limit units/s^2 when stepped rate_hz times a second
+// an accel_limit of 0 turns the profile off: the target goes straight out
+
+void roveMotionProfileConfigure(int motor, uint32_t accel_limit,
+        uint32_t jerk_limit, uint32_t rate_hz);
+
+void roveMotionProfileSetTarget(int motor, int16_t speed);
+
+// Post: motor stopped where it is, no ramp: speed, accel and target all 0 (used by the deadman)
+
+void roveMotionProfileHalt(int motor);
+
+// Pre: called once per tick for each motor
+// Post: output holds the speed to drive, returns false when it is the same as last tick
+
+bool roveMotionProfileStep(int motor, int16_t* output);
+
+// speed before it is rounded to the output, Q16 DriveMotor units
+
+int32_t roveMotionProfileSpeed(int motor);
+
+// floor(sqrt(value)), integer only
+
+uint32_t roveIsqrt64(uint64_t value);
+
+#endif // ROVEMOTIONPROFILE_H_
@@ -0,0 +1,64 @@
+// roveMsgPool.h MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#pragma once
+
+#ifndef ROVEMSGPOOL_H_
+#define ROVEMSGPOOL_H_
+
+// globally scoped Texas Instruments (TI) headers
+
+#include "../RoverMotherboardMain.h"
+
+// MRDesign Team::roveWare::		roveCom and RoveNet services headers
+
+#include "../mrdtRoveWare.h"
+
+// Static pool of MSG_POOL_SIZE command buffers, passed between tasks by index
+//
+// roveTcpHandler receives a command straight into a buffer from the pool and queues its index,
+// roveCmdCntrl works on the command where it lies and frees the buffer when done. Each buffer
+// has MSG_FRAME_HEADER bytes of headroom in front of the command for the 0x06 0x85 size of a
+// serial frame, and the command's frame_trailer leaves room for the checksum after it, so
+// buildSerialStructInPlace can frame it where it lies
+//
+// allocation and free are a few stores with interrupts off, so any task can use the pool
+
+// defined in roveStructs.h
+
+struct base_station_msg_struct;
+
+// Pre: called from main before BIOS_start
+// Post: every buffer free
+
+void roveMsgPoolInit(void);
+
+// Post: a buffer taken from the pool and its index returned, waits a tick at a time while the
+// pool is empty. Each wait is counted in roveMsgPoolExhausted
+
+int roveMsgPoolAlloc(void);
+
+// Pre: buffer came from roveMsgPoolAlloc and is not used again
+
+void roveMsgPoolFree(int buffer);
+
+// the command in a buffer, and the MSG_FRAME_HEADER bytes of headroom just in front of it
+
+struct base_station_msg_struct* roveMsgPoolMessage(int buffer);
+
+char* roveMsgPoolHeadroom(int buffer);
+
+// buffers in use right now, the most ever in use at once, and allocations that had to wait
+
+int roveMsgPoolInUse(void);
+
+int roveMsgPoolHighWater(void);
+
+uint32_t roveMsgPoolExhausted(void);
+
+#endif // ROVEMSGPOOL_H_
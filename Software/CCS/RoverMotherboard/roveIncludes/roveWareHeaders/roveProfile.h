@@ -0,0 +1,103 @@
+// roveProfile.h MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#pragma once
+
+#ifndef ROVEPROFILE_H_
+#define ROVEPROFILE_H_
+
+// globally scoped Texas Instruments (TI) headers
+
+#include "../RoverMotherboardMain.h"
+
+// MRDesign Team::roveWare::		roveCom and RoveNet services headers
+
+#include "../mrdtRoveWare.h"
+
+// On target function timing from the Cortex-M4 DWT cycle counter
+//
+// 	PROFILE_BEGIN(PROFILE_DEVICE_WRITE);
+// 	...
+// 	PROFILE_END(PROFILE_DEVICE_WRITE);
+//
+// BEGIN declares the start count, so it goes with the declarations at the top of a block and
+// END in the same block. A return between them skips the probe, which leaves error paths out
+// of the numbers. Each probe keeps count, min, max and total cycles in a static table
+//
+// with PROFILE_ENABLED false in mrdtRoveWare.h the probes compile to nothing. The cycle
+// counter wraps every 35 s at 120 MHz, anything timed has to be shorter than that
+
+// probes, and their names in base_station_sync.py
+
+#define PROFILE_CALC_CHECKSUM 0
+#define PROFILE_BUILD_SERIAL 1
+#define PROFILE_DEVICE_WRITE 2
+#define PROFILE_DRIVE_MOTOR 3
+#define PROFILE_DRIVE_STAGE 4
+#define PROFILE_DRIVE_COMMIT 5
+#define PROFILE_MOTION_TICK 6
+#define PROFILE_PARSE_COMMAND 7
+#define PROFILE_CALC_CRC 8
+
+#define PROFILE_PROBES 9
+
+// DWT_CYCCNT
+
+#define PROFILE_CYCLE_COUNTER (*((volatile uint32_t*) 0xE0001004))
+
+#if PROFILE_ENABLED
+
+#define PROFILE_BEGIN(probe) uint32_t profile_start_##probe = PROFILE_CYCLE_COUNTER
+
+#define PROFILE_END(probe) roveProfileRecord((probe), PROFILE_CYCLE_COUNTER - profile_start_##probe)
+
+#else
+
+#define PROFILE_BEGIN(probe)
+
+#define PROFILE_END(probe)
+
+#endif //endif PROFILE_ENABLED
+
+// sent to the base station as a ROVER_DIAGNOSTIC DIAGNOSTIC_PROFILE, see roveTcpSender
+// cycles, cpu_hz turns them into time. A probe that never ran has count 0 and min 0
+
+struct profile_probe_report {
+
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint32_t mean;
+
+}__attribute__((packed));
+
+struct profile_report {
+
+    uint32_t cpu_hz;
+    uint8_t probes;
+    struct profile_probe_report probe[PROFILE_PROBES];
+
+}__attribute__((packed));
+
+// Post: DWT cycle counter running, call once from main when PROFILE_ENABLED
+
+void roveProfileInit(void);
+
+// safe from any thread including a Hwi
+
+void roveProfileRecord(int probe, uint32_t cycles);
+
+void roveProfileReport(struct profile_report* report);
+
+// a base station asked for the profile: roveTcpHandler sets it, roveTcpSender takes it and sends
+
+void roveProfileRequest(void);
+
+bool roveProfileTakeRequest(void);
+
+#endif // ROVEPROFILE_H_
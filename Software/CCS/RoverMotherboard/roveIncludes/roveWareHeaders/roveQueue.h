@@ -0,0 +1,84 @@
+// roveQueue.h MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#pragma once
+
+#ifndef ROVEQUEUE_H_
+#define ROVEQUEUE_H_
+
+// only the C lib: this module also builds on a host for Software/Tests/QueueStress
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Single producer, single consumer queue of variable length records
+//
+// records are packed one after the other in a byte ring, each behind its u16 length, so a
+// 5 byte motor command takes 7 bytes instead of a full Mailbox slot. Neither side takes a lock
+// or disables interrupts: only the producer moves head and only the consumer moves tail, and
+// each copies its record before it moves its index. One task pushes and one task pops, a
+// second producer needs a queue of its own
+//
+// a record can be pushed in two pieces and popped back into two pieces, so a struct can be
+// sent as a fixed header plus only the used part of its body
+//
+// blocking is left to the caller: wakeup is called after every push, a TI Semaphore_post in
+// the firmware, and a consumer that finds the queue empty waits on that semaphore
+
+struct rove_queue {
+
+    uint8_t* buffer;
+    uint32_t size;
+
+    // bytes ever written and read, the difference is what is in the ring
+    volatile uint32_t head;
+    volatile uint32_t tail;
+
+    // records ever pushed and popped
+    volatile uint32_t pushed;
+    volatile uint32_t popped;
+
+    uint32_t high_water;
+    uint32_t full;
+
+    void (*wakeup)(void* arg);
+    void* wakeup_arg;
+
+};
+
+// Pre: size is a power of 2, buffer holds size bytes. wakeup may be NULL
+// Post: queue empty
+
+void roveQueueInit(struct rove_queue* queue, uint8_t* buffer, uint32_t size,
+        void (*wakeup)(void* arg), void* wakeup_arg);
+
+// producer only
+// Post: header then body queued as one record and wakeup called, or false with nothing
+// queued when there was no room for both. body may be NULL with body_length 0
+
+bool roveQueuePush(struct rove_queue* queue, const void* header, uint16_t header_length,
+        const void* body, uint16_t body_length);
+
+// consumer only
+// Post: oldest record removed, its first header_length bytes copied into header and the rest
+// into body up to body_max. Returns the length of the rest as pushed, -1 if the queue was empty
+
+int roveQueuePop(struct rove_queue* queue, void* header, uint16_t header_length, void* body,
+        uint16_t body_max);
+
+// records waiting, from either side
+
+int roveQueueCount(const struct rove_queue* queue);
+
+// most records ever waiting at once, and pushes refused for lack of room
+
+uint32_t roveQueueHighWater(const struct rove_queue* queue);
+
+uint32_t roveQueueFull(const struct rove_queue* queue);
+
+#endif // ROVEQUEUE_H_
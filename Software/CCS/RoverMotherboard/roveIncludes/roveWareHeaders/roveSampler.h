@@ -0,0 +1,89 @@
+// roveSampler.h MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#pragma once
+
+#ifndef ROVESAMPLER_H_
+#define ROVESAMPLER_H_
+
+// globally scoped Texas Instruments (TI) headers
+
+#include "../RoverMotherboardMain.h"
+
+// MRDesign Team::roveWare::		roveCom and RoveNet services headers
+
+#include "../mrdtRoveWare.h"
+
+// Statistical profiler: where the firmware spends its time under real load
+//
+// general purpose timer 7 interrupts SAMPLER_RATE_HZ times a second and records the program
+// counter it interrupted and who was running, into a ring of SAMPLER_RING_SIZE samples. Nothing
+// is instrumented, so unlike roveProfile it sees every function, library and BIOS included.
+//
+// The interrupt is plugged straight into the vector table at priority 0, a zero latency interrupt
+// in BIOS terms: Hwi_disable does not hold it off, so it also lands inside critical sections, but
+// it must not call into BIOS beyond reading the running task. Timer 7 is kept out of Timer.ANY
+// in RoverMotherboard.cfg
+//
+// roveTcpSender drains the ring as ROVER_DIAGNOSTIC DIAGNOSTIC_SAMPLES, base_station_sync.py
+// saves them to rove_samples.bin and Software/Tests/SampleProfiler/sample_profile.py maps them
+// to functions with the linker .map or the .out
+
+// who was running: a Task_Handle when the interrupt came from a task, otherwise the exception
+// number it interrupted, 0 for thread code on the main stack
+
+struct sampler_sample {
+
+    uint32_t pc;
+    uint32_t task;
+
+}__attribute__((packed));
+
+// task handles in the samples with their names, as of when the batch was sent
+
+struct sampler_task {
+
+    uint32_t handle;
+    char name[HEALTH_TASK_NAME_SIZE];
+
+}__attribute__((packed));
+
+// header of a DIAGNOSTIC_SAMPLES, followed by its tasks and then its samples. taken and dropped
+// count since boot, dropped are samples the ring had no room for
+
+struct sampler_report {
+
+    uint32_t rate_hz;
+    uint32_t taken;
+    uint32_t dropped;
+    uint16_t samples;
+    uint8_t tasks;
+
+}__attribute__((packed));
+
+// Post: sampling timer running, call once from main before BIOS_start when SAMPLER_ENABLED
+
+void roveSamplerInit(void);
+
+// Post: up to SAMPLER_BATCH of the oldest samples moved out of the ring into samples, the
+// running tasks in tasks and report->samples, report->tasks say how many of each
+
+void roveSamplerTake(struct sampler_report* report, struct sampler_task tasks[HEALTH_MAX_TASKS],
+        struct sampler_sample samples[SAMPLER_BATCH]);
+
+// samples waiting in the ring
+
+int roveSamplerPending(void);
+
+// a base station asked for the samples: roveTcpHandler sets it, roveTcpSender takes it and sends
+
+void roveSamplerRequest(void);
+
+bool roveSamplerTakeRequest(void);
+
+#endif // ROVESAMPLER_H_
@@ -0,0 +1,74 @@
+// roveSpeedControl.h MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#pragma once
+
+#ifndef ROVESPEEDCONTROL_H_
+#define ROVESPEEDCONTROL_H_
+
+// only the C lib: this module also builds on a host for Software/Tests/SpeedControlSim
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Per wheel closed loop speed control, fixed point PID with feedforward
+//
+// stepped once per roveMotionProfileClock tick with the profile output as the setpoint, and
+// returns the DriveMotor command to stage in its place. Speeds and commands are both DriveMotor
+// units (-1000 to 1000, full scale is the no load speed on the pack) in each motor's own direction
+//
+// feedback is either a measured wheel speed (an encoder) or the wheel's current, from which the
+// speed is estimated by taking the winding's IR drop off the last command. A wheel with no
+// feedback for feedback_timeout_ticks falls back to open loop: the setpoint goes straight out
+//
+// anti windup: the integral stops growing while the output is pinned at full scale in the
+// direction it would push, and is itself bounded to full scale
+
+#define SPEED_CONTROL_WHEELS 6
+#define SPEED_CONTROL_FULL_SCALE 1000
+
+// gains are Q16 (65536 is 1.0), per tick for ki
+
+struct speed_control_config {
+
+    int32_t kp_q16;
+    int32_t ki_q16;
+    int32_t kd_q16;
+    int32_t kff_q16;
+    uint16_t feedback_timeout_ticks;
+    uint16_t winding_mohm;
+    uint16_t pack_mv;
+
+};
+
+// Post: every wheel uses config, integrators cleared, open loop until feedback arrives
+
+void roveSpeedControlConfigure(const struct speed_control_config* config);
+
+// Post: wheel's integrator and feedback cleared (used by the deadman)
+
+void roveSpeedControlHalt(int wheel);
+
+// Post: speed is the wheel's new measurement
+
+void roveSpeedControlFeedback(int wheel, int32_t speed);
+
+// Post: the wheel's speed is estimated from current_ma and the last command
+
+void roveSpeedControlCurrent(int wheel, int32_t current_ma);
+
+// Pre: called once per tick for each wheel
+// Post: output holds the command for setpoint, returns false when it is the same as last tick
+
+bool roveSpeedControlStep(int wheel, int16_t setpoint, int16_t* output);
+
+// Post: returns true while the wheel has fresh feedback and is running closed loop
+
+bool roveSpeedControlIsClosed(int wheel);
+
+#endif // ROVESPEEDCONTROL_H_
@@ -25,10 +25,34 @@ uint8_t CalcCheckSum(const void* my_struct, uint8_t size);
 // XOR checksum calculation for a struct
 uint8_t calcCheckSum(const void* my_struct, uint8_t size);
 
-// Pre: buffer must be of size(my_struct) + 4 bytes (start bytes, size, and checksum)
+// CRC-16/CCITT of the size byte and the struct, on the CRC module when SERIAL_CRC_HARDWARE
+// Pre: initSerialCrc called from main
+uint16_t calcCrc16(const void* my_struct, uint8_t size);
+
+void initSerialCrc(void);
+
+// the CRC module on its own, whatever SERIAL_CRC_HARDWARE says, for roveChecksumTester
+// Pre: initSerialCrcHardware called once
+void initSerialCrcHardware(void);
+
+uint16_t calcCrc16Hardware(const void* my_struct, uint8_t size);
+
+// frames are 0x06, the version byte, size, the struct and then the version's trailer:
+// SERIAL_FRAME_XOR ends in the XOR checksum, SERIAL_FRAME_CRC16 in the CRC high byte first
+
+// Pre: buffer must be of size(my_struct) + SERIAL_FRAME_OVERHEAD bytes
+// Post: a SERIAL_FRAME_VERSION frame in buffer, returns its size or -1
 int buildSerialStructMessage(void* my_struct, char* buffer);
 
-// Pre: is a buffer where the received struct will be placed. The function returns true if the
+// the same as a SERIAL_FRAME_XOR frame, which every device understands
+int buildSerialStructLegacy(void* my_struct, char* buffer);
+
+// Pre: the struct starts MSG_FRAME_HEADER bytes into frame and has 2 free bytes after it, as a
+// roveMsgPool buffer from roveMsgPoolHeadroom does
+// Post: the frame is built around the struct without moving it, returns its size or -1
+int buildSerialStructInPlace(char* frame);
+
+// Pre: is a buffer where the received struct will be placed. Either frame version is accepted. The function returns true if the
 // received value is valid and false if not. This is currently a BLOCKING call and will
 // only return when either a whole message is read or an incorrect message was received and dropped
 // In the future this may be changed to work as a nonblocking function or a different function
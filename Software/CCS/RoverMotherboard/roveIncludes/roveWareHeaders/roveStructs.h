@@ -19,17 +19,46 @@
 
 #include "../mrdtRoveWare.h"
 
+// CALIBRATION_POINTS for drive_calibration_command
+
+#include "roveCalibration.h"
+
 // returns the size of the struct with the associated id, returns -1 for error
 
 int getStructSize(char structId);
 
+// Post: the field layouts of the delta encodable telemetry given to roveTelemCodec, switched
+// on by the flags in mrdtRoveWare.h. Called from main before BIOS_start
+
+void initTelemCodecStreams(void);
+
 typedef struct base_station_msg_struct{
 
 	char id;
 	char value[MAX_COMMAND_SIZE];
 
+	// room for the serial frame checksum or CRC after the largest command, see buildSerialStructInPlace
+
+	char frame_trailer[2];
+
+	// filled in by roveTcpHandler for roveCmdCntrl, never forwarded to a device
+	// anything posted to roveCmdQueue without a stamp must leave these zeroed
+
+	uint8_t flags;
+	uint16_t seq;
+	uint32_t sent_us;
+
+	// roveTraceStart when the message type byte came in, if CMD_FLAG_TRACED
+
+	uint32_t trace_start;
+
 }__attribute__((packed)) base_station_msg_struct, *base_msg;
 
+// base_station_msg_struct flags
+
+#define CMD_FLAG_STAMPED 0x01
+#define CMD_FLAG_TRACED 0x02
+
 //normally the compiler implicitly optimizes memory allocations for member variables by padding to the nearest 32 bits
 
 //attribute__((packed)) explicitly overides this and is necessary because the TI board is 32 bit and the ATMegas are 8 bit
@@ -41,6 +70,42 @@ struct motor_control_struct{
 
 }__attribute__((packed));
 
+// all six wheels in one frame, wheel order is motor_0 ... motor_5 (right side 0 to 2, left side 3 to 5)
+// speeds are -1000 to 1000 like motor_control_struct, positive drives the rover forward:
+// roveCmdCntrl applies each motor's phase, the base station does not
+
+struct six_wheel_drive_struct{
+
+	uint8_t struct_id;
+	int16_t speed[DRIVE_MOTOR_COUNT];
+
+}__attribute__((packed));
+
+// linear and angular velocity setpoint for the whole rover, mixed into wheel speeds by roveKinematics
+// linear in mm/s forward, angular in mrad/s counter clockwise (turning left)
+
+struct twist_drive_struct{
+
+	uint8_t struct_id;
+	int16_t linear_mm_s;
+	int16_t angular_mrad_s;
+
+}__attribute__((packed));
+
+// replaces one drive motor's ESC calibration table (see roveCalibration.h), applied straight away
+// save non zero also writes every motor's table to EEPROM, so it is there after a reset
+
+struct drive_calibration_command{
+
+	uint8_t struct_id;
+	uint8_t motor;
+	uint8_t save;
+	uint16_t neutral_us;
+	uint16_t forward_us[CALIBRATION_POINTS];
+	uint16_t reverse_us[CALIBRATION_POINTS];
+
+}__attribute__((packed));
+
 // sent from mobo to device to request identify
 
 struct device_telem_req{
@@ -154,6 +219,194 @@ struct gps_telem
     float angle;
 }__attribute__((packed));
 
+// TELEM_METADATA from the base station: sets the rate policy of one telemetry id (see roveTelemPolicy.h)
+
+struct telem_policy_command
+{
+    uint8_t telem_id;
+    uint8_t mode;
+    uint16_t max_rate_dhz;
+    uint8_t decimation;
+    uint8_t delta_encode;
+}__attribute__((packed));
+
+// sent back for every telem_policy_command: the policy now in force and its counters
+
+struct telem_policy_telem
+{
+    uint8_t struct_id;
+    uint8_t telem_id;
+    uint8_t mode;
+    uint8_t decimation;
+    uint16_t max_rate_dhz;
+    uint32_t received;
+    uint32_t forwarded;
+    uint32_t dropped;
+    uint32_t merged;
+}__attribute__((packed));
+
+// ROVER_HEARTBEAT, the rover fills in seq and rover_tx_us, the base station echoes it
+// back with the times it received and answered it (all microseconds on the sender's own clock)
+
+struct heartbeat_struct
+{
+    uint16_t seq;
+    uint32_t rover_tx_us;
+    uint32_t base_rx_us;
+    uint32_t base_tx_us;
+}__attribute__((packed));
+
+// round trip time of the base station link over the last LINK_RTT_WINDOW heartbeats, and the
+// telemetry messages roveTcpSender has sent on this connection (low 16 bits, it wraps). 30 bytes,
+// it has to fit MAX_TELEM_SIZE to go through roveTelemQueue
+
+struct link_stats_telem
+{
+    uint8_t struct_id;
+    uint8_t samples;
+    uint16_t heartbeats_lost;
+    uint32_t srtt_us;
+    uint32_t rttvar_us;
+    uint32_t p50_us;
+    uint32_t p90_us;
+    uint32_t p99_us;
+    uint32_t max_us;
+    uint16_t telem_sent;
+}__attribute__((packed));
+
+// SYNCHRONIZE_STATUS, the rover fills in seq and t1, the base station answers with
+// t2 and t3 from its own microsecond clock (see roveClockSync.h)
+
+struct clock_sync_struct
+{
+    uint8_t seq;
+    uint32_t t1_rover_tx_us;
+    uint32_t t2_base_rx_us;
+    uint32_t t3_base_tx_us;
+}__attribute__((packed));
+
+// the clock offset the rover is using, offset_us is base clock minus rover clock
+
+struct clock_sync_telem
+{
+    uint8_t struct_id;
+    uint8_t valid;
+    uint8_t samples;
+    int32_t offset_us;
+    uint32_t delay_us;
+}__attribute__((packed));
+
+// ROVER_COMMAND_STAMPED header, followed by the command struct exactly as in ROVER_COMMAND
+// sent_us is the base station clock (see roveClockSync.h), seq counts up per command
+
+struct command_stamp_struct
+{
+    uint16_t seq;
+    uint32_t sent_us;
+}__attribute__((packed));
+
+// COMMAND_METADATA, oldest stamped drive / arm command roveCmdCntrl still applies, 0 for no limit
+
+struct command_expiry_command
+{
+    uint16_t max_age_ms;
+}__attribute__((packed));
+
+// stamped command counters by outcome and the base send -> actuation latency. late_stops are
+// stale or out of order stop commands applied all the same
+
+struct command_expiry_telem
+{
+    uint8_t struct_id;
+    uint16_t max_age_ms;
+    uint32_t accepted;
+    uint32_t dropped_stale;
+    uint32_t dropped_out_of_order;
+    uint32_t unchecked_age;
+    uint32_t latency_avg_us;
+    uint32_t latency_max_us;
+    uint16_t late_stops;
+}__attribute__((packed));
+
+// wheel feedback for roveSpeedControl from an encoder or motor current board, device to mobo.
+// The board has to share the GPS_ON_MOB line with the GPS, no other jack is read for telemetry
+// value in DriveMotorStage motor order: DriveMotor units in each motor's own direction, or
+// current in 10 mA steps (a stalled drive motor passes 32 A)
+
+#define WHEEL_FEEDBACK_SPEED 0
+#define WHEEL_FEEDBACK_CURRENT 1
+
+struct wheel_feedback_telem
+{
+    uint8_t struct_id;
+    uint8_t kind;
+    int16_t value[DRIVE_MOTOR_COUNT];
+}__attribute__((packed));
+
+// what roveDiscovery found on jacks DISCOVERY_FIRST_JACK on at boot, and how long it took
+// device_id is what answered, or DISCOVERY_SILENT / DISCOVERY_NOT_PROBED / DISCOVERY_BAD_REPLY
+
+struct discovery_telem
+{
+    uint8_t struct_id;
+    uint16_t scan_ms;
+    uint8_t device_id[DISCOVERY_JACKS];
+}__attribute__((packed));
+
+// system health from roveHealth every HEALTH_PERIOD_MS, followed by task_health_telem for a few tasks in turn
+// loads are in tenths of a percent over the last Load window, stacks and heap in bytes.
+// The Hwi stack is Program.stack in RoverMotherboard.cfg, Swis and Hwis run on it
+
+struct system_health_telem
+{
+    uint8_t struct_id;
+    uint16_t cpu_load;
+    uint16_t swi_load;
+    uint32_t heap_free;
+    uint32_t heap_largest_free;
+    uint16_t hwi_stack_size;
+    uint16_t hwi_stack_peak;
+    uint8_t command_queue_count;
+    uint8_t command_queue_high_water;
+    uint8_t telem_queue_high_water;
+    uint8_t tasks;
+    uint8_t msg_pool_in_use;
+    uint8_t msg_pool_high_water;
+    uint16_t msg_pool_exhausted;
+}__attribute__((packed));
+
+// stack_peak is the most the task has ever used, from the fill pattern BIOS puts in the stack
+// name is the BIOS instance name, cut to fit and not terminated if it fills the array
+
+struct task_health_telem
+{
+    uint8_t struct_id;
+    uint8_t task;
+    int8_t priority;
+    uint16_t load;
+    uint16_t stack_size;
+    uint16_t stack_peak;
+    char name[HEALTH_TASK_NAME_SIZE];
+}__attribute__((packed));
+
+// long message counters from roveFragmentLink, from boot: sent is base station to devices,
+// received is devices to the base station. Bytes are message bytes, dropped counts fragments,
+// queue_full the whole messages roveTcpSender had no room for (see roveFragment.h)
+
+struct fragment_telem
+{
+    uint8_t struct_id;
+    uint16_t messages_sent;
+    uint16_t messages_received;
+    uint32_t bytes_sent;
+    uint32_t bytes_received;
+    uint16_t fragments_sent;
+    uint16_t fragments_received;
+    uint16_t dropped;
+    uint16_t timeouts;
+    uint16_t queue_full;
+}__attribute__((packed));
+
 // this struct should only be used for type casting as it does not have a corresponding id
 
 // may not work with non void pointer casts
@@ -19,9 +19,10 @@
 
 #include "../mrdtRoveWare.h"
 
-// when data is recieved it goes into the fromBaseStationMailbox as RoveNet recieve struct base_station_msg_struct
+// when data is recieved it is read into a roveMsgPool buffer as RoveNet recieve struct base_station_msg_struct,
+// and the buffer's index is posted to roveCmdQueue for roveCmdCntrl
 
-// when data is sent it goes into the toBaseStationMailbox mailbox RoveNet send switching on the enum device structs and sizeof()
+// when data is sent it comes out of the roveTelemQueue (oldest first, a reconnect backlog newest first) RoveNet send switching on the enum device structs and sizeof()
 
 // base Station Command Identifiers
 
@@ -68,10 +69,45 @@ static bool attemptToConnect(struct NetworkConnection* connection);
 
 // Network Message Parser
 
-//Pre: Next bytes in network queue are a rovecomm message
+//Pre: Next bytes in network queue are a rovecomm message, after a struct command_stamp_struct if stamped
 //     Should only be called if the message type indicates this
-//Post:Message placed in fromBaseStation mailbox
+//Post:Message placed in roveCmdQueue
 
-static bool parseRoverCommandMessage(struct NetworkConnection* connection);
+static bool parseRoverCommandMessage(struct NetworkConnection* connection,
+        bool stamped);
+
+//Pre: Next bytes in network queue are a struct command_expiry_command
+//Post:Max command age applied and a command_expiry_telem report queued for the base station
+
+static bool parseCommandMetadataMessage(struct NetworkConnection* connection);
+
+//Post:report holds the roveCmdExpiry counters, ready for roveTelemQueuePost
+
+static void commandExpiryReport(struct command_expiry_telem* report);
+
+//Pre: Next bytes in network queue are a struct telem_policy_command
+//Post:Policy applied and a telem_policy_telem report queued for the base station
+
+static bool parseTelemMetadataMessage(struct NetworkConnection* connection);
+
+//Pre: Next bytes in network queue are the base station's echo of a struct heartbeat_struct
+//Post:Round trip time estimate updated
+
+static bool parseHeartbeatMessage(struct NetworkConnection* connection);
+
+//Pre: Next bytes in network queue are the base station's answer to a struct clock_sync_struct
+//Post:Base station clock offset estimate updated
+
+static bool parseSynchronizeMessage(struct NetworkConnection* connection);
+
+//Pre: Next byte in network queue is what a ROVER_DIAGNOSTIC asks for
+//Post:roveTcpSender told to send it
+
+static bool parseDiagnosticMessage(struct NetworkConnection* connection);
+
+//Pre: Next bytes in network queue are the u16 length and the message of a ROVER_LONG_MESSAGE
+//Post:Message in roveCmdQueue as fragments, or skipped if it is too long to fragment
+
+static bool parseLongMessage(struct NetworkConnection* connection);
 
 #endif // ROVETCPHANDLER_H_
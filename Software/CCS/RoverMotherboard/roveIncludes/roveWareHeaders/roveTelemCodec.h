@@ -0,0 +1,91 @@
+// roveTelemCodec.h MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#pragma once
+
+#ifndef ROVETELEMCODEC_H_
+#define ROVETELEMCODEC_H_
+
+// only the C lib: this module also builds on a host for Software/Tests/TelemetryCodec
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Delta encoding for slowly changing telemetry (gps fixes, cell voltages...)
+//
+// every field after the struct_id is differenced against the last sample of the same id,
+// zigzag folded so small negative deltas stay small, and written as a base 128 varint
+//
+// ROVER_TELEM_DELTA frame on the wire:
+//
+//	[ROVER_TELEM_DELTA][struct_id][seq][flags][payload_len][payload]
+//
+// 	seq increments once per frame of that struct_id, a gap tells the base station it lost a frame
+// 	flags TELEM_DELTA_KEYFRAME: payload is the raw struct exactly as ROVER_TELEM would send it
+// 	otherwise payload is one varint per field in struct order
+//
+// a keyframe goes out every TELEM_KEYFRAME_INTERVAL frames so the base station can resync after loss
+
+#define TELEM_DELTA_KEYFRAME 0x01
+
+// header bytes in front of the payload, including the message type
+#define TELEM_DELTA_HEADER_SIZE 5
+
+// largest struct a stream can carry, MAX_TELEM_SIZE fits, and how many streams there can be
+#define TELEM_DELTA_MAX_SAMPLE 32
+#define TELEM_DELTA_MAX_STREAMS 4
+
+// worst case frame: header plus a 5 byte varint for every byte of the struct
+#define TELEM_DELTA_MAX_FRAME (TELEM_DELTA_HEADER_SIZE + 5 * TELEM_DELTA_MAX_SAMPLE)
+
+// one field of a telemetry struct: where it starts and how many bytes wide it is (1, 2 or 4)
+
+struct telem_field {
+
+    uint8_t offset;
+    uint8_t width;
+
+};
+
+// Pre: message_type is the first byte of every frame, ROVER_TELEM_DELTA on the rover
+// Post: no streams, the firmware's are added by initTelemCodecStreams in roveStructs.c
+
+void roveTelemCodecInit(uint8_t message_type, uint8_t keyframe_interval);
+
+// Pre: fields stay valid, size is at most TELEM_DELTA_MAX_SAMPLE
+// Post: struct_id is delta encodable with this field layout, false when there is no room
+
+bool roveTelemCodecAddStream(uint8_t struct_id, uint8_t size, const struct telem_field* fields,
+        uint8_t field_count, bool enabled);
+
+// true if struct_id has a field layout and delta encoding is switched on for it
+
+bool roveTelemCodecIsEnabled(uint8_t struct_id);
+
+// turns delta encoding on or off for a struct_id, returns false if the id has no field layout
+
+bool roveTelemCodecEnable(uint8_t struct_id, bool enable);
+
+// forces the next frame of every stream to be a keyframe, call on every new base station connection
+
+void roveTelemCodecResync(void);
+
+// Pre: telem_struct begins with a struct_id that roveTelemCodecIsEnabled()
+//      frame holds at least TELEM_DELTA_MAX_FRAME bytes
+// Post: frame holds a complete ROVER_TELEM_DELTA message, encoder history updated
+// returns the number of bytes in frame, or -1 if the id is not delta encoded
+
+int roveTelemEncode(const void* telem_struct, char* frame);
+
+// zigzag varint primitives, shared with anything else that wants compact integers
+
+int roveVarintWrite(int32_t value, uint8_t* buffer);
+
+int roveVarintRead(const uint8_t* buffer, int bytes_available, int32_t* value);
+
+#endif // ROVETELEMCODEC_H_
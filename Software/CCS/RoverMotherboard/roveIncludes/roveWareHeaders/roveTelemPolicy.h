@@ -0,0 +1,83 @@
+// roveTelemPolicy.h MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#pragma once
+
+#ifndef ROVETELEMPOLICY_H_
+#define ROVETELEMPOLICY_H_
+
+// globally scoped Texas Instruments (TI) headers
+
+#include "../RoverMotherboardMain.h"
+
+// MRDesign Team::roveWare::		roveCom and RoveNet services headers
+
+#include "../mrdtRoveWare.h"
+
+// Per telemetry id rate limiting, so one chatty device can't fill the queue to the base station
+//
+// every id gets a policy the first time it is seen (TELEM_POLICY_DEFAULT_* in mrdtRoveWare.h)
+// and the base station can change it at any time with a TELEM_METADATA message
+//
+// 	decimation:		only every Nth sample of the id is considered, the rest are dropped
+// 	max rate:		samples closer together than the rate allows are either
+// 	DROP_EXCESS		dropped, each sample stands on its own
+// 	KEEP_LATEST		held, a newer sample replaces (merges) the held one and the
+// 					newest goes out as soon as the rate allows
+//
+// a held sample goes out from roveTelemPolicyFlush, which runs after every device message and
+// every time roveTcpSender wakes, so it is not stuck behind a device that has gone quiet
+
+#define TELEM_POLICY_DROP_EXCESS 0
+#define TELEM_POLICY_KEEP_LATEST 1
+
+// telem_policy_command.mode that only asks for the counters, the policy is left alone
+
+#define TELEM_POLICY_QUERY 0xFF
+
+// roveTelemPolicyFilter results
+
+#define TELEM_POLICY_FORWARD 0
+#define TELEM_POLICY_DROP 1
+#define TELEM_POLICY_HOLD 2
+
+// defined in roveStructs.h
+
+struct telem_policy_command;
+struct telem_policy_telem;
+
+// Pre: telem is a complete struct as returned by recvSerialStructMessage()
+// returns TELEM_POLICY_FORWARD if telem should go to the base station now,
+// otherwise it has been dropped or copied into the id's hold slot. Ids with no struct size,
+// or one over MAX_TELEM_SIZE, are always TELEM_POLICY_DROP
+
+int roveTelemPolicyFilter(const char* telem);
+
+// Post: if a held sample's rate window has opened it is copied into buffer and true is returned
+// call until it returns false
+
+bool roveTelemPolicyTakeDue(char* buffer);
+
+// Post: every held sample whose rate window has opened posted to roveTelemQueue
+
+void roveTelemPolicyFlush(void);
+
+// true for the modes above, and TELEM_POLICY_QUERY
+
+bool roveTelemPolicyModeValid(uint8_t mode);
+
+// applies a base station TELEM_METADATA command, returns false for an unknown mode
+// or if the policy table is full
+
+bool roveTelemPolicyApply(const struct telem_policy_command* command);
+
+// Post: report holds the policy and counters for telem_id, returns false for an id never seen
+
+bool roveTelemPolicyReport(uint8_t telem_id, struct telem_policy_telem* report);
+
+#endif // ROVETELEMPOLICY_H_
@@ -0,0 +1,59 @@
+// roveTelemQueue.h MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#pragma once
+
+#ifndef ROVETELEMQUEUE_H_
+#define ROVETELEMQUEUE_H_
+
+// globally scoped Texas Instruments (TI) headers
+
+#include "../RoverMotherboardMain.h"
+
+// MRDesign Team::roveWare::		roveCom and RoveNet services headers
+
+#include "../mrdtRoveWare.h"
+
+// Telemetry queue to the base station, replaces the toBaseStationMailbox
+//
+// posting never blocks: when the ring is full the oldest sample is overwritten, so the
+// telemetry task keeps reading its uart while the base station is gone
+//
+// while connected the sender takes samples oldest first, in the order the devices sent them.
+// The backlog left by a dropped link (at most TELEM_QUEUE_DEPTH samples, the newest ones) is
+// delivered newest first once the link comes back, then it is back to oldest first
+
+// Post: telem is queued with the current roveGetMicros() time, the oldest sample is dropped if the ring was full
+// ids with no struct size or one over MAX_TELEM_SIZE are dropped. Never blocks, safe from any task
+
+void roveTelemQueuePost(const char* telem);
+
+// Post: samples waiting now, and any posted before they have all been taken, go out newest first
+// call when a new base station connection is set up
+
+void roveTelemQueueReconnect(void);
+
+// Pre: telem holds at least MAX_TELEM_SIZE bytes
+// Post: next queued sample copied into telem, the time it was posted into captured_us
+// returns false if nothing arrived within timeout ticks (BIOS_WAIT_FOREVER or BIOS_NO_WAIT work too)
+
+bool roveTelemQueuePend(char* telem, uint32_t* captured_us, UInt timeout);
+
+// samples waiting right now
+
+int roveTelemQueueCount(void);
+
+// most samples ever waiting at once
+
+int roveTelemQueueHighWater(void);
+
+// samples overwritten before the sender got to them
+
+uint32_t roveTelemQueueOverflows(void);
+
+#endif // ROVETELEMQUEUE_H_
@@ -20,4 +20,9 @@
 
 void ms_delay(int milliseconds);
 
+// free running microsecond clock from the BIOS timestamp provider, wraps every 71 minutes
+// differences between two readings are valid across the wrap as long as they are done unsigned
+
+uint32_t roveGetMicros(void);
+
 #endif //ROVETIMING_H_
@@ -0,0 +1,91 @@
+// roveTrace.h MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#pragma once
+
+#ifndef ROVETRACE_H_
+#define ROVETRACE_H_
+
+// globally scoped Texas Instruments (TI) headers
+
+#include "../RoverMotherboardMain.h"
+
+// MRDesign Team::roveWare::		roveCom and RoveNet services headers
+
+#include "../mrdtRoveWare.h"
+
+// Command latency tracing from the base station socket to the motors
+//
+// roveTcpHandler stamps a command with roveTraceStart as soon as its message type byte is
+// read, and every stage after that records how long it has been since then:
+//
+// 	TRACE_RECV 		rest of the command read off the socket, base_station_msg_struct ready to post
+// 	TRACE_POST 		roveCmdQueuePost returned (includes waiting on a full queue)
+// 	TRACE_DISPATCH 	roveCmdCntrl took it out of the queue and it was not expired
+// 	TRACE_ACTUATE 	drive targets handed to roveMotionProfile, or deviceWrite returned
+//
+// so the step between two stages' histograms is the time spent in between. Samples are raw
+// Timestamp ticks, cheap enough to take on every command, and only turned into microseconds
+// when a report is built
+//
+// each stage has its own ring with a single writer (RECV to POST in roveTcpHandler, DISPATCH
+// and ACTUATE in roveCmdCntrl), so recording takes no lock. A report copies a ring and
+// throws away whatever a writer overwrote while it was copying
+
+#define TRACE_RECV 0
+#define TRACE_POST 1
+#define TRACE_DISPATCH 2
+#define TRACE_ACTUATE 3
+
+#define TRACE_STAGES 4
+
+// bucket b counts latencies from 2^b up to 2^(b+1) microseconds, the first also takes 0 and 1
+// and the last everything from 2^(TRACE_BUCKETS - 1) up
+
+#define TRACE_BUCKETS 16
+
+// sent to the base station as a ROVER_DIAGNOSTIC DIAGNOSTIC_TRACE, see roveTcpSender
+
+struct trace_stage_report {
+
+    // recorded since boot, and how many of those the histogram covers (the newest)
+    uint32_t samples;
+    uint16_t window;
+    uint32_t max_us;
+    uint16_t histogram[TRACE_BUCKETS];
+
+}__attribute__((packed));
+
+struct trace_report {
+
+    uint8_t stages;
+    uint8_t buckets;
+    struct trace_stage_report stage[TRACE_STAGES];
+
+}__attribute__((packed));
+
+// Post: the current time to hand to roveTraceStage, in Timestamp ticks
+
+uint32_t roveTraceStart(void);
+
+// Pre: only one thread ever records a given stage
+// Post: time since start recorded for stage
+
+void roveTraceStage(int stage, uint32_t start);
+
+// Post: report holds a histogram per stage over the newest samples in its ring
+
+void roveTraceReport(struct trace_report* report);
+
+// a base station asked for the trace: roveTcpHandler sets it, roveTcpSender takes it and sends
+
+void roveTraceRequest(void);
+
+bool roveTraceTakeRequest(void);
+
+#endif // ROVETRACE_H_
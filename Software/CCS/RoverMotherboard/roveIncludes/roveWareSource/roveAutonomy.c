@@ -10,17 +10,22 @@
 void emergencyStop()
 {
 	int i;
+	base_station_msg_struct message;
+
+	// post with no stamp: roveCmdCntrl must never drop a stop as stale
 
 	for (i = 0; i < (sizeof(E_STOP_MOTORS) / sizeof(E_STOP_MOTORS[0])); i++)
 	{
-		Mailbox_post(fromBaseStationMailbox, &(E_STOP_MOTORS[i]),
-		        BIOS_WAIT_FOREVER);
+		memset(&message, 0, sizeof(message));
+		memcpy(&message, &(E_STOP_MOTORS[i]), sizeof(E_STOP_MOTORS[i]));
+		roveCmdQueuePost(&message);
 	}
 
 	for (i = 0; i < (sizeof(E_STOP_ARM) / sizeof(E_STOP_ARM[0])); i++)
 	{
-		Mailbox_post(fromBaseStationMailbox, &(E_STOP_ARM[i]),
-		        BIOS_WAIT_FOREVER);
+		memset(&message, 0, sizeof(message));
+		memcpy(&message, &(E_STOP_ARM[i]), sizeof(E_STOP_ARM[i]));
+		roveCmdQueuePost(&message);
 	}
 
 	return;
@@ -0,0 +1,257 @@
+// roveCalibration.c MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#include "../roveWareHeaders/roveCalibration.h"
+
+#include <string.h>
+#include <stddef.h>
+
+// slopes are Q16 microseconds per speed count, one per segment between points
+
+struct calibration_lut {
+
+    struct drive_calibration table;
+    int32_t forward_slope[CALIBRATION_POINTS - 1];
+    int32_t reverse_slope[CALIBRATION_POINTS - 1];
+
+};
+
+static struct calibration_lut luts[CALIBRATION_MOTORS];
+
+// speed of point 0 is 1, the rest sit on multiples of CALIBRATION_STEP
+
+static int32_t pointSpeed(int point) {
+
+    return (point == 0) ? 1 : point * CALIBRATION_STEP;
+
+} //endfnctn pointSpeed
+
+static bool inRange(uint16_t us) {
+
+    return (us >= CALIBRATION_MIN_US) && (us <= CALIBRATION_MAX_US);
+
+} //endfnctn inRange
+
+static bool tableValid(const struct drive_calibration* table) {
+
+    int point;
+
+    if (!inRange(table->neutral_us)) {
+
+        return false;
+
+    } //endif
+
+    for (point = 0; point < CALIBRATION_POINTS; point++) {
+
+        if (!inRange(table->forward_us[point]) || !inRange(table->reverse_us[point])) {
+
+            return false;
+
+        } //endif
+
+        if (point == 0) {
+
+            if ((table->forward_us[0] < table->neutral_us)
+                    || (table->reverse_us[0] > table->neutral_us)) {
+
+                return false;
+
+            } //endif
+
+        } else if ((table->forward_us[point] < table->forward_us[point - 1])
+                || (table->reverse_us[point] > table->reverse_us[point - 1])) {
+
+            return false;
+
+        } //endif
+
+    } //endfor
+
+    return true;
+
+} //endfnctn tableValid
+
+static void slopes(const uint16_t us[CALIBRATION_POINTS], int32_t slope[CALIBRATION_POINTS - 1]) {
+
+    int point;
+
+    for (point = 0; point < CALIBRATION_POINTS - 1; point++) {
+
+        slope[point] = (((int32_t) us[point + 1] - us[point]) * 65536)
+                / (pointSpeed(point + 1) - pointSpeed(point));
+
+    } //endfor
+
+} //endfnctn slopes
+
+void roveCalibrationDefault(struct drive_calibration* table) {
+
+    int point;
+
+    table->neutral_us = 1500;
+
+    for (point = 0; point < CALIBRATION_POINTS; point++) {
+
+        table->forward_us[point] = 1500 + pointSpeed(point) / 2;
+        table->reverse_us[point] = 1500 - pointSpeed(point) / 2;
+
+    } //endfor
+
+} //endfnctn roveCalibrationDefault
+
+void roveCalibrationReset(void) {
+
+    struct drive_calibration table;
+    int motor;
+
+    roveCalibrationDefault(&table);
+
+    for (motor = 0; motor < CALIBRATION_MOTORS; motor++) {
+
+        roveCalibrationSet(motor, &table);
+
+    } //endfor
+
+} //endfnctn roveCalibrationReset
+
+bool roveCalibrationSet(int motor, const struct drive_calibration* table) {
+
+    struct calibration_lut* lut;
+
+    if ((motor < 0) || (motor >= CALIBRATION_MOTORS) || !tableValid(table)) {
+
+        return false;
+
+    } //endif
+
+    lut = &luts[motor];
+
+    memcpy(&lut->table, table, sizeof(lut->table));
+    slopes(table->forward_us, lut->forward_slope);
+    slopes(table->reverse_us, lut->reverse_slope);
+
+    return true;
+
+} //endfnctn roveCalibrationSet
+
+void roveCalibrationGet(int motor, struct drive_calibration* table) {
+
+    memcpy(table, &luts[motor].table, sizeof(*table));
+
+} //endfnctn roveCalibrationGet
+
+uint16_t roveCalibrationPulse(int motor, int speed) {
+
+    const struct calibration_lut* lut = &luts[motor];
+    const uint16_t* us;
+    const int32_t* slope;
+    int32_t magnitude;
+    int32_t offset;
+    int segment;
+
+    if (speed == 0) {
+
+        return lut->table.neutral_us;
+
+    } //endif
+
+    if (speed > 0) {
+
+        us = lut->table.forward_us;
+        slope = lut->forward_slope;
+        magnitude = speed;
+
+    } else {
+
+        us = lut->table.reverse_us;
+        slope = lut->reverse_slope;
+        magnitude = -speed;
+
+    } //endif
+
+    if (magnitude >= CALIBRATION_FULL_SCALE) {
+
+        return us[CALIBRATION_POINTS - 1];
+
+    } //endif
+
+    // division by a constant: the compiler turns it into a multiply
+    segment = magnitude / CALIBRATION_STEP;
+    offset = magnitude - pointSpeed(segment);
+
+    // rounded to the nearest microsecond, slope can be negative on the reverse side
+    return (uint16_t) (us[segment] + ((slope[segment] * offset + (1 << 15)) >> 16));
+
+} //endfnctn roveCalibrationPulse
+
+static uint32_t checksum(const struct calibration_store* store) {
+
+    const uint8_t* bytes = (const uint8_t*) store;
+    uint32_t sum_a = 0x1234;
+    uint32_t sum_b = 0;
+    size_t i;
+
+    // Fletcher style: catches swapped and zeroed words, which a plain sum does not
+    for (i = 0; i < offsetof(struct calibration_store, checksum); i++) {
+
+        sum_a = (sum_a + bytes[i]) % 65535;
+        sum_b = (sum_b + sum_a) % 65535;
+
+    } //endfor
+
+    return (sum_b << 16) | sum_a;
+
+} //endfnctn checksum
+
+void roveCalibrationStore(struct calibration_store* store) {
+
+    int motor;
+
+    memset(store, 0, sizeof(*store));
+    store->magic = CALIBRATION_MAGIC;
+
+    for (motor = 0; motor < CALIBRATION_MOTORS; motor++) {
+
+        roveCalibrationGet(motor, &store->tables[motor]);
+
+    } //endfor
+
+    store->checksum = checksum(store);
+
+} //endfnctn roveCalibrationStore
+
+bool roveCalibrationRestore(const struct calibration_store* store) {
+
+    int motor;
+
+    if ((store->magic != CALIBRATION_MAGIC) || (store->checksum != checksum(store))) {
+
+        return false;
+
+    } //endif
+
+    for (motor = 0; motor < CALIBRATION_MOTORS; motor++) {
+
+        if (!tableValid(&store->tables[motor])) {
+
+            return false;
+
+        } //endif
+
+    } //endfor
+
+    for (motor = 0; motor < CALIBRATION_MOTORS; motor++) {
+
+        roveCalibrationSet(motor, &store->tables[motor]);
+
+    } //endfor
+
+    return true;
+
+} //endfnctn roveCalibrationRestore
@@ -0,0 +1,156 @@
+// roveClockSync.c MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#include "../roveWareHeaders/roveClockSync.h"
+
+typedef struct clock_sync_sample {
+
+    int32_t offset_us;
+    uint32_t delay_us;
+
+} clock_sync_sample;
+
+static clock_sync_sample sync_window[CLOCK_SYNC_WINDOW];
+static int sync_next = 0;
+static int sync_samples = 0;
+
+static uint8_t sync_seq = 0;
+
+// the request in flight, only its reply is taken
+
+static bool sync_pending = false;
+static uint8_t sync_pending_seq = 0;
+
+// the estimate in use, from the lowest delay sample in the window
+
+static bool sync_valid = false;
+static int32_t sync_offset_us = 0;
+static uint32_t sync_delay_us = 0;
+
+void roveClockSyncReset(void) {
+
+    UInt key = Task_disable();
+
+    sync_next = 0;
+    sync_samples = 0;
+    sync_valid = false;
+    sync_pending = false;
+
+    Task_restore(key);
+
+} //endfnctn roveClockSyncReset
+
+void roveClockSyncBuild(struct clock_sync_struct* request) {
+
+    UInt key = Task_disable();
+
+    request->seq = sync_seq++;
+    request->t1_rover_tx_us = roveGetMicros();
+    request->t2_base_rx_us = 0;
+    request->t3_base_tx_us = 0;
+
+    // a reply to any earlier request is too late to trust its delay
+    sync_pending = true;
+    sync_pending_seq = request->seq;
+
+    Task_restore(key);
+
+} //endfnctn roveClockSyncBuild
+
+void roveClockSyncUpdate(const struct clock_sync_struct* reply) {
+
+    uint32_t t4 = roveGetMicros();
+    uint32_t forward_us;
+    uint32_t backward_us;
+    clock_sync_sample sample;
+    int best;
+    int i;
+    UInt key;
+
+    // each term is a difference of two readings of the same clock or a modular offset,
+    // so the uint32 wraps cancel out
+    sample.delay_us = (t4 - reply->t1_rover_tx_us)
+            - (reply->t3_base_tx_us - reply->t2_base_rx_us);
+
+    // both legs are the offset give or take the delay: halve only their small difference,
+    // so an offset anywhere in the 32 bit range comes out right
+    forward_us = reply->t2_base_rx_us - reply->t1_rover_tx_us;
+    backward_us = reply->t3_base_tx_us - t4;
+    sample.offset_us = (int32_t) (forward_us + (uint32_t) ((int32_t) (backward_us - forward_us) / 2));
+
+    key = Task_disable();
+
+    if (!sync_pending || (reply->seq != sync_pending_seq)) {
+
+        Task_restore(key);
+        return;
+
+    } //endif
+
+    sync_pending = false;
+
+    sync_window[sync_next] = sample;
+    sync_next = (sync_next + 1) % CLOCK_SYNC_WINDOW;
+
+    if (sync_samples < CLOCK_SYNC_WINDOW) {
+
+        sync_samples++;
+
+    } //endif
+
+    best = 0;
+
+    for (i = 1; i < sync_samples; i++) {
+
+        if (sync_window[i].delay_us < sync_window[best].delay_us) {
+
+            best = i;
+
+        } //endif
+
+    } //endfor
+
+    sync_offset_us = sync_window[best].offset_us;
+    sync_delay_us = sync_window[best].delay_us;
+    sync_valid = true;
+
+    Task_restore(key);
+
+} //endfnctn roveClockSyncUpdate
+
+bool roveClockSyncIsValid(void) {
+
+    return sync_valid;
+
+} //endfnctn roveClockSyncIsValid
+
+uint32_t roveClockToBase(uint32_t rover_us) {
+
+    return rover_us + (uint32_t) sync_offset_us;
+
+} //endfnctn roveClockToBase
+
+uint32_t roveClockFromBase(uint32_t base_us) {
+
+    return base_us - (uint32_t) sync_offset_us;
+
+} //endfnctn roveClockFromBase
+
+void roveClockSyncReport(struct clock_sync_telem* report) {
+
+    UInt key = Task_disable();
+
+    report->struct_id = clock_sync_telem_id;
+    report->valid = sync_valid;
+    report->samples = sync_samples;
+    report->offset_us = sync_offset_us;
+    report->delay_us = sync_delay_us;
+
+    Task_restore(key);
+
+} //endfnctn roveClockSyncReport
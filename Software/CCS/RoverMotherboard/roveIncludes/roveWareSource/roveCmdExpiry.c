@@ -0,0 +1,136 @@
+// roveCmdExpiry.c MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#include "../roveWareHeaders/roveCmdExpiry.h"
+
+// CMD_MAX_AGE_MS from main, then whatever COMMAND_METADATA asks for
+
+static uint32_t max_age_us = 0;
+
+static bool class_has_seq[CMD_CLASS_COUNT];
+static uint16_t class_last_seq[CMD_CLASS_COUNT];
+
+static uint32_t accepted = 0;
+static uint32_t dropped_stale = 0;
+static uint32_t dropped_out_of_order = 0;
+static uint32_t unchecked_age = 0;
+static uint32_t late_stops = 0;
+
+// one way latency of stamped commands, base send to actuation
+
+static uint32_t latency_max_us = 0;
+static uint32_t latency_avg_us = 0;
+
+void roveCmdExpiryReset(void) {
+
+    int i;
+
+    for (i = 0; i < CMD_CLASS_COUNT; i++) {
+
+        class_has_seq[i] = false;
+
+    } //endfor
+
+} //endfnctn roveCmdExpiryReset
+
+void roveCmdExpirySetMaxAge(uint16_t max_age_ms) {
+
+    max_age_us = (uint32_t) max_age_ms * 1000;
+
+} //endfnctn roveCmdExpirySetMaxAge
+
+int roveCmdExpiryCheck(const struct cmd_stamp* stamp) {
+
+    int cmd_class = stamp->cmd_class;
+    int result = CMD_ACCEPT;
+    bool newer;
+
+    newer = !class_has_seq[cmd_class]
+            || ((int16_t) (stamp->seq - class_last_seq[cmd_class]) > 0);
+
+    if (!newer) {
+
+        result = CMD_DROP_OUT_OF_ORDER;
+
+    } else if (max_age_us != 0) {
+
+        if (!stamp->age_known) {
+
+            // no clock to judge by yet, the sequence check still applies
+            unchecked_age++;
+
+        } else if (stamp->age_us > (int32_t) max_age_us) {
+
+            result = CMD_DROP_STALE;
+
+        } //endif
+
+    } //endif
+
+    if ((result != CMD_ACCEPT) && stamp->stop) {
+
+        // applied all the same: however late, a stop can only stop the rover, never start it
+        late_stops++;
+        result = CMD_ACCEPT;
+
+    } //endif
+
+    if (result == CMD_DROP_OUT_OF_ORDER) {
+
+        dropped_out_of_order++;
+        return result;
+
+    } //endif
+
+    if (result == CMD_DROP_STALE) {
+
+        dropped_stale++;
+        return result;
+
+    } //endif
+
+    // a late stop never moves the class back to an older sequence number
+    if (newer) {
+
+        class_has_seq[cmd_class] = true;
+        class_last_seq[cmd_class] = stamp->seq;
+
+    } //endif
+
+    accepted++;
+
+    return CMD_ACCEPT;
+
+} //endfnctn roveCmdExpiryCheck
+
+void roveCmdExpiryApplied(uint32_t latency_us) {
+
+    if (latency_us > latency_max_us) {
+
+        latency_max_us = latency_us;
+
+    } //endif
+
+    // running average, 1/16 weight on the newest
+    latency_avg_us = (latency_avg_us == 0) ?
+            latency_us : latency_avg_us - (latency_avg_us >> 4) + (latency_us >> 4);
+
+} //endfnctn roveCmdExpiryApplied
+
+void roveCmdExpiryStats(struct cmd_expiry_stats* stats) {
+
+    stats->max_age_ms = max_age_us / 1000;
+    stats->accepted = accepted;
+    stats->dropped_stale = dropped_stale;
+    stats->dropped_out_of_order = dropped_out_of_order;
+    stats->unchecked_age = unchecked_age;
+    stats->late_stops = late_stops;
+    stats->latency_avg_us = latency_avg_us;
+    stats->latency_max_us = latency_max_us;
+
+} //endfnctn roveCmdExpiryStats
@@ -0,0 +1,90 @@
+// roveCmdQueue.c MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#include "../roveWareHeaders/roveCmdQueue.h"
+
+#include <ti/sysbios/knl/Semaphore.h>
+
+static uint8_t cmd_queue_buffer[CMD_QUEUE_SIZE];
+static struct rove_queue cmd_queue;
+
+static void wakeCmdCntrl(void* arg) {
+
+    // binary semaphore: one post covers any number of queued commands
+    Semaphore_post(fromBaseStationSemaphore);
+
+} //endfnctn wakeCmdCntrl
+
+void roveCmdQueueInit(void) {
+
+    roveQueueInit(&cmd_queue, cmd_queue_buffer, CMD_QUEUE_SIZE, wakeCmdCntrl, NULL);
+
+} //endfnctn roveCmdQueueInit
+
+void roveCmdQueuePostBuffer(int buffer) {
+
+    uint8_t index = buffer;
+
+    while (!roveQueuePush(&cmd_queue, &index, sizeof(index), NULL, 0)) {
+
+        Task_sleep(1);
+
+    } //endwhile
+
+} //endfnctn roveCmdQueuePostBuffer
+
+void roveCmdQueuePost(const base_station_msg_struct* message) {
+
+    int buffer = roveMsgPoolAlloc();
+
+    memcpy(roveMsgPoolMessage(buffer), message, sizeof(*message));
+
+    roveCmdQueuePostBuffer(buffer);
+
+} //endfnctn roveCmdQueuePost
+
+int roveCmdQueuePend(void) {
+
+    uint8_t index;
+
+    if (roveQueuePop(&cmd_queue, &index, sizeof(index), NULL, 0) >= 0) {
+
+        return index;
+
+    } //endif
+
+    Semaphore_pend(fromBaseStationSemaphore, BIOS_WAIT_FOREVER);
+
+    // a command, or a wake with nothing queued
+    if (roveQueuePop(&cmd_queue, &index, sizeof(index), NULL, 0) >= 0) {
+
+        return index;
+
+    } //endif
+
+    return -1;
+
+} //endfnctn roveCmdQueuePend
+
+void roveCmdQueueWake(void) {
+
+    Semaphore_post(fromBaseStationSemaphore);
+
+} //endfnctn roveCmdQueueWake
+
+int roveCmdQueueCount(void) {
+
+    return roveQueueCount(&cmd_queue);
+
+} //endfnctn roveCmdQueueCount
+
+int roveCmdQueueHighWater(void) {
+
+    return roveQueueHighWater(&cmd_queue);
+
+} //endfnctn roveCmdQueueHighWater
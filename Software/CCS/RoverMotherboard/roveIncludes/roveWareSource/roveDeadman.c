@@ -0,0 +1,114 @@
+// roveDeadman.c MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#include "../roveWareHeaders/roveDeadman.h"
+
+#include <stddef.h>
+
+// the tick runs in a Hwi and the feed in a task: the feed writes the deadline before
+// arming, so the Hwi never sees an armed group with a stale deadline
+
+struct deadman_group {
+
+    volatile bool armed;
+    volatile bool tripped;
+    volatile uint32_t deadline_ms;
+    uint32_t window_ms;
+    uint32_t trips;
+    void (*neutral)(void);
+
+};
+
+static struct deadman_group deadman_groups[DEADMAN_GROUP_COUNT];
+
+// only written by roveDeadmanTick, wraps after 49 days which the deadline compare handles
+
+static volatile uint32_t deadman_now_ms = 0;
+
+void roveDeadmanInit(int group, uint32_t window_ms, void (*neutral)(void)) {
+
+    struct deadman_group* deadman = &deadman_groups[group];
+
+    deadman->armed = false;
+    deadman->tripped = false;
+    deadman->deadline_ms = 0;
+    deadman->window_ms = window_ms;
+    deadman->trips = 0;
+    deadman->neutral = neutral;
+
+} //endfnctn roveDeadmanInit
+
+void roveDeadmanSetWindow(int group, uint32_t window_ms) {
+
+    deadman_groups[group].window_ms = window_ms;
+
+    if (window_ms == 0) {
+
+        deadman_groups[group].armed = false;
+
+    } //endif
+
+} //endfnctn roveDeadmanSetWindow
+
+void roveDeadmanFeed(int group) {
+
+    struct deadman_group* deadman = &deadman_groups[group];
+
+    if (deadman->window_ms == 0) {
+
+        return;
+
+    } //endif
+
+    deadman->deadline_ms = deadman_now_ms + deadman->window_ms;
+    deadman->tripped = false;
+    deadman->armed = true;
+
+} //endfnctn roveDeadmanFeed
+
+void roveDeadmanTick(uint32_t elapsed_ms) {
+
+    struct deadman_group* deadman;
+    int group;
+
+    deadman_now_ms += elapsed_ms;
+
+    for (group = 0; group < DEADMAN_GROUP_COUNT; group++) {
+
+        deadman = &deadman_groups[group];
+
+        if (deadman->armed
+                && ((int32_t) (deadman_now_ms - deadman->deadline_ms) >= 0)) {
+
+            deadman->armed = false;
+            deadman->tripped = true;
+            deadman->trips++;
+
+            if (deadman->neutral != NULL) {
+
+                deadman->neutral();
+
+            } //endif
+
+        } //endif
+
+    } //endfor
+
+} //endfnctn roveDeadmanTick
+
+bool roveDeadmanIsTripped(int group) {
+
+    return deadman_groups[group].tripped;
+
+} //endfnctn roveDeadmanIsTripped
+
+uint32_t roveDeadmanTrips(int group) {
+
+    return deadman_groups[group].trips;
+
+} //endfnctn roveDeadmanTrips
@@ -0,0 +1,341 @@
+// roveDiscovery.c MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#include "../roveWareHeaders/roveDiscovery.h"
+
+#include <ti/sysbios/knl/Clock.h>
+#include <ti/sysbios/knl/Semaphore.h>
+#include <ti/sysbios/knl/Task.h>
+
+// give us access to the uart handles defined at the global scope in main
+
+extern UART_Handle uart4;
+extern UART_Handle uart5;
+extern UART_Handle uart7;
+
+// the jacks behind each uart's mux, in deviceWrite's numbering
+// jack 12 selects the same mux input as jack 9, so it is left out rather than found twice
+
+static const uint8_t uart7_jacks[] = { 7, 8 };
+static const uint8_t uart5_jacks[] = { 9, 10, 11, 13 };
+static const uint8_t uart4_jacks[] = { 14, 15, 16, 17 };
+
+struct discovery_lane {
+
+    UART_Handle* uart;
+    const uint8_t* jacks;
+    int count;
+    bool done;
+
+};
+
+#define DISCOVERY_LANES 3
+
+static struct discovery_lane lanes[DISCOVERY_LANES] = {
+
+    { &uart7, uart7_jacks, sizeof(uart7_jacks), false },
+    { &uart5, uart5_jacks, sizeof(uart5_jacks), false },
+    { &uart4, uart4_jacks, sizeof(uart4_jacks), false }
+
+};
+
+// the struct ids each known device owns, for routing
+
+struct discovery_device {
+
+    uint8_t device_id;
+    uint8_t last_id;
+
+};
+
+static const struct discovery_device devices[] = {
+
+    { wrist_clock_wise, drill_forward },
+    { PTZ_Cam_id_0, PTZ_Cam_id_0 },
+    { PTZ_Cam_id_1, PTZ_Cam_id_1 },
+    { PTZ_Cam_id_2, PTZ_Cam_id_2 },
+    { PTZ_Cam_id_3, PTZ_Cam_id_3 }
+
+};
+
+#define DISCOVERY_DEVICES (sizeof(devices) / sizeof(devices[0]))
+
+// start bytes, size, dev_identify_reply, checksum
+
+#define DISCOVERY_REPLY_FRAME (3 + sizeof(struct dev_identify_reply) + 1)
+
+static uint8_t found[DISCOVERY_JACKS];
+
+static uint8_t routes[256];
+
+static uint16_t scan_ms = 0;
+
+static Semaphore_Handle lanes_done;
+
+// set once the scan is past DISCOVERY_TIMEOUT_MS, lanes stop before their next jack
+
+static volatile bool scan_abort = false;
+
+static uint8_t parseReply(const char* frame, int bytes_read) {
+
+    const struct dev_identify_reply* reply;
+
+    if (bytes_read <= 0) {
+
+        return DISCOVERY_SILENT;
+
+    } //endif
+
+    reply = (const struct dev_identify_reply*) (frame + 3);
+
+    if ((bytes_read != DISCOVERY_REPLY_FRAME) || ((uint8_t) frame[0] != 0x06)
+            || ((uint8_t) frame[1] != 0x85)
+            || (frame[2] != sizeof(struct dev_identify_reply))
+            || ((uint8_t) frame[DISCOVERY_REPLY_FRAME - 1]
+                    != calcCheckSum(reply, sizeof(struct dev_identify_reply)))
+            || (reply->struct_id != dev_identify_reply_id)
+            || (reply->device_id == DISCOVERY_SILENT)
+            || (reply->device_id >= DISCOVERY_NOT_PROBED)) {
+
+        return DISCOVERY_BAD_REPLY;
+
+    } //endif
+
+    return reply->device_id;
+
+} //endfnctn parseReply
+
+static Void discoveryLane(UArg arg0, UArg arg1) {
+
+    struct discovery_lane* lane = &lanes[arg0];
+    struct mobo_identify_req request = { mobo_identify_req_id };
+    char frame[sizeof(request) + SERIAL_FRAME_OVERHEAD];
+    char reply[DISCOVERY_REPLY_FRAME];
+    int frame_size;
+    int bytes_read;
+    int i;
+
+    // a device not known yet can only be asked in the frame every device understands
+    frame_size = buildSerialStructLegacy(&request, frame);
+
+    for (i = 0; (i < lane->count) && !scan_abort; i++) {
+
+        // deviceWrite leaves the mux on this jack for the reply
+        deviceWrite(lane->jacks[i], frame, frame_size);
+
+        bytes_read = UART_read_nonblocking(*lane->uart, reply, DISCOVERY_REPLY_FRAME,
+                DISCOVERY_REPLY_TIMEOUT_MS);
+
+        found[lane->jacks[i] - DISCOVERY_FIRST_JACK] = parseReply(reply, bytes_read);
+
+    } //endfor
+
+    // jacks left when aborted stay DISCOVERY_NOT_PROBED
+    lane->done = (i == lane->count);
+    Semaphore_post(lanes_done);
+
+} //endfnctn discoveryLane
+
+static const struct discovery_device* knownDevice(uint8_t device_id) {
+
+    int i;
+
+    for (i = 0; i < DISCOVERY_DEVICES; i++) {
+
+        if (devices[i].device_id == device_id) {
+
+            return &devices[i];
+
+        } //endif
+
+    } //endfor
+
+    return NULL;
+
+} //endfnctn knownDevice
+
+static void route(int jack, uint8_t device_id) {
+
+    const struct discovery_device* device = knownDevice(device_id);
+    int last_id = (device != NULL) ? device->last_id : device_id;
+    int id;
+
+    for (id = device_id; id <= last_id; id++) {
+
+        if (routes[id] != DISCOVERY_NO_JACK) {
+
+            roveLog(LOG_DISCOVERY_DUPLICATE, id, routes[id], jack);
+            continue;
+
+        } //endif
+
+        routes[id] = jack;
+
+    } //endfor
+
+} //endfnctn route
+
+void roveDiscoveryScan(void) {
+
+    Task_Params laneParams;
+    Task_Handle laneTasks[DISCOVERY_LANES];
+    Error_Block eb;
+    uint32_t start = Clock_getTicks();
+    uint32_t elapsed;
+    int probed = 0;
+    int started = 0;
+    int exited;
+    int jack;
+    int lane;
+
+    memset(routes, DISCOVERY_NO_JACK, sizeof(routes));
+    memset(found, DISCOVERY_NOT_PROBED, sizeof(found));
+
+    // nothing goes out on the jacks, getDeviceJack keeps to its fixed jacks
+    if (!DISCOVERY_ENABLED) {
+
+        return;
+
+    } //endif
+
+    scan_abort = false;
+
+    Error_init(&eb);
+    lanes_done = Semaphore_create(0, NULL, &eb);
+
+    for (lane = 0; lane < DISCOVERY_LANES; lane++) {
+
+        Task_Params_init(&laneParams);
+        laneParams.stackSize = 1024;
+        laneParams.priority = DISCOVERY_LANE_TASK_PRIORITY;
+        laneParams.arg0 = lane;
+        laneParams.instance->name = "roveDiscoveryLane";
+
+        lanes[lane].done = false;
+        laneTasks[lane] = Task_create((Task_FuncPtr) discoveryLane, &laneParams, &eb);
+
+        if (laneTasks[lane] == NULL) {
+
+            roveLog(LOG_DISCOVERY_LANE_FAILED, lane, 0, 0);
+            continue;
+
+        } //endif
+
+        started++;
+        probed += lanes[lane].count;
+
+    } //endfor
+
+    for (exited = 0; exited < started; exited++) {
+
+        elapsed = Clock_getTicks() - start;
+
+        if ((elapsed >= DISCOVERY_TIMEOUT_MS)
+                || !Semaphore_pend(lanes_done, DISCOVERY_TIMEOUT_MS - elapsed)) {
+
+            break;
+
+        } //endif
+
+    } //endfor
+
+    // past the deadline: the lanes still running finish the jack they are on, at most one
+    // DISCOVERY_REPLY_TIMEOUT_MS, and stop. Nothing else may use the uarts until they have
+    scan_abort = true;
+
+    for (; exited < started; exited++) {
+
+        Semaphore_pend(lanes_done, BIOS_WAIT_FOREVER);
+
+    } //endfor
+
+    scan_ms = Clock_getTicks() - start;
+
+    for (lane = 0; lane < DISCOVERY_LANES; lane++) {
+
+        if (laneTasks[lane] == NULL) {
+
+            continue;
+
+        } //endif
+
+        // it has posted, let it run off the end of discoveryLane before freeing its stack
+        while (Task_getMode(laneTasks[lane]) != Task_Mode_TERMINATED) {
+
+            Task_sleep(1);
+
+        } //endwhile
+
+        Task_delete(&laneTasks[lane]);
+
+        if (!lanes[lane].done) {
+
+            roveLog(LOG_DISCOVERY_LANE_TIMEOUT, lane, 0, 0);
+
+        } //endif
+
+        // whatever the lane got through before it was stopped is good
+        for (jack = 0; jack < lanes[lane].count; jack++) {
+
+            if ((found[lanes[lane].jacks[jack] - DISCOVERY_FIRST_JACK] != DISCOVERY_SILENT)
+                    && (found[lanes[lane].jacks[jack] - DISCOVERY_FIRST_JACK]
+                            != DISCOVERY_BAD_REPLY)
+                    && (found[lanes[lane].jacks[jack] - DISCOVERY_FIRST_JACK]
+                            != DISCOVERY_NOT_PROBED)) {
+
+                route(lanes[lane].jacks[jack],
+                        found[lanes[lane].jacks[jack] - DISCOVERY_FIRST_JACK]);
+
+            } //endif
+
+        } //endfor
+
+    } //endfor
+
+    Semaphore_delete(&lanes_done);
+
+    roveLog(LOG_DISCOVERY_SCAN, probed, scan_ms, probed * (DISCOVERY_REPLY_TIMEOUT_MS + 1));
+
+    for (jack = 0; jack < DISCOVERY_JACKS; jack++) {
+
+        switch (found[jack]) {
+
+        case DISCOVERY_SILENT:
+            roveLog(LOG_DISCOVERY_SILENT, jack + DISCOVERY_FIRST_JACK, 0, 0);
+            break;
+
+        case DISCOVERY_NOT_PROBED:
+            break;
+
+        case DISCOVERY_BAD_REPLY:
+            roveLog(LOG_DISCOVERY_BAD_REPLY, jack + DISCOVERY_FIRST_JACK, 0, 0);
+            break;
+
+        default:
+            roveLog(LOG_DISCOVERY_FOUND, jack + DISCOVERY_FIRST_JACK, found[jack], 0);
+            break;
+
+        } //endswitch
+
+    } //endfor
+
+} //endfnctn roveDiscoveryScan
+
+int roveDiscoveryJack(uint8_t struct_id) {
+
+    return routes[struct_id];
+
+} //endfnctn roveDiscoveryJack
+
+void roveDiscoveryReport(struct discovery_telem* report) {
+
+    report->struct_id = discovery_telem_id;
+    report->scan_ms = scan_ms;
+    memcpy(report->device_id, found, sizeof(report->device_id));
+
+} //endfnctn roveDiscoveryReport
@@ -0,0 +1,190 @@
+// roveFragment.c MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#include "../roveWareHeaders/roveFragment.h"
+
+#include <stddef.h>
+#include <string.h>
+
+// message bytes in fragment index of a total_length message
+
+static int fragmentBytes(uint8_t index, uint16_t total_length) {
+
+    uint32_t offset = (uint32_t) index * FRAGMENT_DATA_SIZE;
+
+    if ((total_length - offset) < FRAGMENT_DATA_SIZE) {
+
+        return total_length - offset;
+
+    } //endif
+
+    return FRAGMENT_DATA_SIZE;
+
+} //endfnctn fragmentBytes
+
+int roveFragmentCount(uint16_t total_length) {
+
+    int count = (total_length + FRAGMENT_DATA_SIZE - 1) / FRAGMENT_DATA_SIZE;
+
+    if (count > FRAGMENT_MAX_COUNT) {
+
+        return 0;
+
+    } //endif
+
+    return count;
+
+} //endfnctn roveFragmentCount
+
+int roveFragmentPrepare(struct fragment_struct* fragment, uint8_t struct_id, uint8_t destination,
+        uint8_t message_id, uint8_t index, uint16_t total_length) {
+
+    fragment->struct_id = struct_id;
+    fragment->destination = destination;
+    fragment->message_id = message_id;
+    fragment->index = index;
+    fragment->total_length = total_length;
+
+    memset(fragment->data, 0, sizeof(fragment->data));
+
+    return fragmentBytes(index, total_length);
+
+} //endfnctn roveFragmentPrepare
+
+int roveFragmentSplit(struct fragment_struct* fragment, uint8_t struct_id, uint8_t message_id,
+        uint8_t index, const void* message, uint16_t total_length) {
+
+    const uint8_t* bytes = (const uint8_t*) message;
+    int length;
+
+    length = roveFragmentPrepare(fragment, struct_id, bytes[0], message_id, index, total_length);
+
+    memcpy(fragment->data, bytes + (uint32_t) index * FRAGMENT_DATA_SIZE, length);
+
+    return length;
+
+} //endfnctn roveFragmentSplit
+
+void roveFragmentCountSent(struct fragment_stats* stats, const struct fragment_struct* fragment) {
+
+    stats->fragments_sent++;
+    stats->bytes_sent += fragmentBytes(fragment->index, fragment->total_length);
+
+    if ((fragment->index + 1) == roveFragmentCount(fragment->total_length)) {
+
+        stats->messages_sent++;
+
+    } //endif
+
+} //endfnctn roveFragmentCountSent
+
+void roveFragmentReassemblyInit(struct fragment_reassembly* reassembly, uint8_t* buffer,
+        uint16_t size, uint32_t timeout_ms, struct fragment_stats* stats) {
+
+    memset(reassembly, 0, sizeof(*reassembly));
+
+    reassembly->buffer = buffer;
+    reassembly->size = size;
+    reassembly->timeout_ms = timeout_ms;
+    reassembly->stats = stats;
+
+} //endfnctn roveFragmentReassemblyInit
+
+// the partial message goes, its fragments counted as dropped
+
+static void abandon(struct fragment_reassembly* reassembly) {
+
+    if (reassembly->active) {
+
+        reassembly->stats->dropped += reassembly->next;
+        reassembly->active = false;
+
+    } //endif
+
+} //endfnctn abandon
+
+bool roveFragmentExpire(struct fragment_reassembly* reassembly, uint32_t now_ms) {
+
+    if (!reassembly->active || ((now_ms - reassembly->last_ms) <= reassembly->timeout_ms)) {
+
+        return false;
+
+    } //endif
+
+    reassembly->stats->timeouts++;
+    abandon(reassembly);
+
+    return true;
+
+} //endfnctn roveFragmentExpire
+
+int roveFragmentAccept(struct fragment_reassembly* reassembly,
+        const struct fragment_struct* fragment, uint32_t now_ms) {
+
+    int count = roveFragmentCount(fragment->total_length);
+
+    reassembly->stats->fragments_received++;
+
+    roveFragmentExpire(reassembly, now_ms);
+
+    if ((count == 0) || (fragment->index >= count)) {
+
+        reassembly->stats->dropped++;
+        return FRAGMENT_DROPPED;
+
+    } //endif
+
+    if (fragment->index == 0) {
+
+        // a new message: whatever was left of the last one is not coming
+        abandon(reassembly);
+
+        if (fragment->total_length > reassembly->size) {
+
+            reassembly->stats->dropped++;
+            return FRAGMENT_DROPPED;
+
+        } //endif
+
+        reassembly->active = true;
+        reassembly->destination = fragment->destination;
+        reassembly->message_id = fragment->message_id;
+        reassembly->total_length = fragment->total_length;
+        reassembly->next = 0;
+
+    } else if (!reassembly->active || (fragment->message_id != reassembly->message_id)
+            || (fragment->index != reassembly->next)
+            || (fragment->total_length != reassembly->total_length)
+            || (fragment->destination != reassembly->destination)) {
+
+        // out of order, or the rest of a message already thrown away
+        abandon(reassembly);
+        reassembly->stats->dropped++;
+        return FRAGMENT_DROPPED;
+
+    } //endif
+
+    memcpy(reassembly->buffer + (uint32_t) fragment->index * FRAGMENT_DATA_SIZE, fragment->data,
+            fragmentBytes(fragment->index, fragment->total_length));
+
+    reassembly->next++;
+    reassembly->last_ms = now_ms;
+
+    if (reassembly->next < count) {
+
+        return FRAGMENT_PENDING;
+
+    } //endif
+
+    reassembly->active = false;
+    reassembly->stats->messages_received++;
+    reassembly->stats->bytes_received += reassembly->total_length;
+
+    return FRAGMENT_COMPLETE;
+
+} //endfnctn roveFragmentAccept
@@ -0,0 +1,79 @@
+// roveFragmentLink.c MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#include "../roveWareHeaders/roveFragmentLink.h"
+
+// received counters belong to roveTelemCntrl, sent counters to roveCmdCntrl
+
+static struct fragment_stats stats;
+
+static uint8_t reassembly_buffer[FRAGMENT_MAX_MESSAGE];
+static struct fragment_reassembly reassembly;
+
+// roveTelemCntrl pushes, roveTcpSender pops
+
+static uint8_t to_base_buffer[FRAGMENT_QUEUE_SIZE];
+static struct rove_queue to_base;
+
+void roveFragmentLinkInit(void) {
+
+    roveFragmentReassemblyInit(&reassembly, reassembly_buffer, sizeof(reassembly_buffer),
+            FRAGMENT_TIMEOUT_MS, &stats);
+
+    // roveTcpSender wakes often enough on its own, see SEND_KEEPALIVE_DELAY_TICKS
+    roveQueueInit(&to_base, to_base_buffer, FRAGMENT_QUEUE_SIZE, NULL, NULL);
+
+} //endfnctn roveFragmentLinkInit
+
+void roveFragmentLinkReceive(const char* fragment) {
+
+    struct fragment_struct received;
+
+    // the uart buffer has no alignment to speak of
+    memcpy(&received, fragment, sizeof(received));
+
+    if (roveFragmentAccept(&reassembly, &received, Clock_getTicks()) != FRAGMENT_COMPLETE) {
+
+        return;
+
+    } //endif
+
+    if (!roveQueuePush(&to_base, NULL, 0, reassembly.buffer, reassembly.total_length)) {
+
+        roveLog(LOG_FRAGMENT_QUEUE_FULL, reassembly.total_length, reassembly.destination, 0);
+
+    } //endif
+
+} //endfnctn roveFragmentLinkReceive
+
+int roveFragmentLinkTake(char message[FRAGMENT_MAX_MESSAGE]) {
+
+    return roveQueuePop(&to_base, NULL, 0, message, FRAGMENT_MAX_MESSAGE);
+
+} //endfnctn roveFragmentLinkTake
+
+void roveFragmentLinkSent(const struct fragment_struct* fragment) {
+
+    roveFragmentCountSent(&stats, fragment);
+
+} //endfnctn roveFragmentLinkSent
+
+void roveFragmentLinkReport(struct fragment_telem* report) {
+
+    report->struct_id = fragment_telem_id;
+    report->messages_sent = stats.messages_sent;
+    report->messages_received = stats.messages_received;
+    report->bytes_sent = stats.bytes_sent;
+    report->bytes_received = stats.bytes_received;
+    report->fragments_sent = stats.fragments_sent;
+    report->fragments_received = stats.fragments_received;
+    report->dropped = stats.dropped;
+    report->timeouts = stats.timeouts;
+    report->queue_full = roveQueueFull(&to_base);
+
+} //endfnctn roveFragmentLinkReport
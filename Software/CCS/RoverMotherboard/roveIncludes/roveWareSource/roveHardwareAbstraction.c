@@ -8,15 +8,57 @@
 
 #include "../roveWareHeaders/roveHardwareAbstraction.h"
 #include <ti/sysbios/knl/Task.h>
+#include <ti/sysbios/hal/Hwi.h>
+
+#include <driverlib/sysctl.h>
+#include <driverlib/eeprom.h>
+
+#define DRIVE_PWM_GEN_BITS (PWM_GEN_0_BIT | PWM_GEN_1_BIT | PWM_GEN_2_BIT | PWM_GEN_3_BIT)
+
+// motor_0 ... motor_5 in DriveMotorStage order
+
+static const uint32_t drive_pwm_outputs[DRIVE_MOTOR_COUNT] = { PWM_OUT_1, PWM_OUT_2,
+        PWM_OUT_3, PWM_OUT_4, PWM_OUT_5, PWM_OUT_6 };
+
+static const uint32_t drive_pwm_generators[DRIVE_MOTOR_COUNT] = { PWM_GEN_0,
+        PWM_GEN_1, PWM_GEN_1, PWM_GEN_2, PWM_GEN_2, PWM_GEN_3 };
+
+static const uint16_t drive_period_us[DRIVE_MOTOR_COUNT] = DRIVE_PWM_PERIOD_US;
+
+static const uint8_t drive_esc_protocol[DRIVE_MOTOR_COUNT] = DRIVE_ESC_PROTOCOL;
+
+// Q12 pwm clock counts per calibrated microsecond, protocol divider included. Worked out
+// from the generator period once the driver has set it: the generators share one pwm
+// clock divider, so the longest frame decides the resolution of them all
+
+#define DRIVE_PULSE_SCALE_SHIFT 12
+
+static uint32_t drive_pulse_scale[DRIVE_MOTOR_COUNT];
+
+static uint32_t drive_staged_counts[DRIVE_MOTOR_COUNT];
+static uint8_t drive_staged_mask = 0;
+
+// last speed staged for each motor, so a new calibration table can be applied on the spot
+
+static int drive_speed[DRIVE_MOTOR_COUNT];
 
 //TODO Configure Patch Panel Jacks to Physical Devices (In Hardware FIRST)
 
 int getDeviceJack(int device) {
 
+    // wherever roveDiscovery found it at boot, before the fixed jacks below
+    int jack = roveDiscoveryJack(device);
+
+    if (jack != DISCOVERY_NO_JACK) {
+
+        return jack;
+
+    } //endif
+
     switch (device) {
     case 0:
         //Tried to get jack for an null device
-        printf("getDeviceJack passed null device %d\n", device);
+        roveLog(LOG_HAL_NULL_DEVICE, device, 0, 0);
         return -1;
 
  /*   case test_device_id:
@@ -53,7 +95,7 @@ int getDeviceJack(int device) {
 
     default:
         //Tried to get jack for an \ invalid device
-        printf("getDeviceJack passed invalid device %d\n", device);
+        roveLog(LOG_HAL_INVALID_DEVICE, device, 0, 0);
         return -1;
 
     } //endswitch (device)
@@ -108,7 +150,7 @@ void digitalWrite(int pin, int val) {
             break;
         default:
             //Tried to write to invalid device
-            printf("DigitalWrite passed invalid pin %d\n", pin);
+            roveLog(LOG_HAL_INVALID_PIN, pin, val, 0);
             return;
         }	//endswitch
 
@@ -148,7 +190,7 @@ void digitalWrite(int pin, int val) {
             break;
         default:
             //Tried to write to invalid device
-            printf("DigitalWrite passed invalid pin %d\n", pin);
+            roveLog(LOG_HAL_INVALID_PIN, pin, val, 0);
             return;
 
         }	//endswitch
@@ -188,10 +230,12 @@ void pwmWrite(PWM_Handle pin, int duty_microseconds) {
 
     PWM_setDuty(pin, duty_microseconds);
 
-}	//endfnctn pwmWrite
+    // drive generators run in global sync mode, the new duty waits for this
+    PWMSyncUpdate(PWM0_BASE, DRIVE_PWM_GEN_BITS);
 
+}	//endfnctn pwmWrite
 
-void DriveMotor(PWM_Handle motor, int speed)
+static int driveMicroseconds(int speed)
 {
 	//Scaling
 	int microseconds;
@@ -204,16 +248,309 @@ void DriveMotor(PWM_Handle motor, int speed)
     if (microseconds < 1000) //Lower bound on motor pulse width
         microseconds = 1000;
 
+	return microseconds;
+
+} //endfnct driveMicroseconds
+
+void DriveMotor(PWM_Handle motor, int speed)
+{
+	PROFILE_BEGIN(PROFILE_DRIVE_MOTOR);
+
 	//Writing
-	pwmWrite(motor, microseconds);
+	pwmWrite(motor, driveMicroseconds(speed));
+
+	PROFILE_END(PROFILE_DRIVE_MOTOR);
 	return;
 
 } //endfnct DriveMotor
 
+PWM_Handle roveDrivePWMInit(int motor) {
+
+    // PWM_config index 0 is PWM_OUT_0, the drive motors follow it
+    return rovePWMInit(motor + 1, drive_period_us[motor]);
+
+} //endfnctn roveDrivePWMInit
+
+void rovePWMSyncInit(void) {
+
+    int motor;
+
+    for (motor = 0; motor < DRIVE_MOTOR_COUNT; motor++) {
+
+        // one generator, one period: the second output would silently run at the first one's frame
+        if ((motor > 0) && (drive_pwm_generators[motor] == drive_pwm_generators[motor - 1])
+                && (drive_period_us[motor] != drive_period_us[motor - 1])) {
+
+            System_abort("DRIVE_PWM_PERIOD_US differs on a shared generator\n");
+
+        } //endif
+
+        // the longest calibrated pulse has to end inside the frame
+        if (CALIBRATION_MAX_US / drive_esc_protocol[motor] >= drive_period_us[motor]) {
+
+            System_abort("DRIVE_PWM_PERIOD_US too short for the ESC pulse\n");
+
+        } //endif
+
+        drive_pulse_scale[motor] = (PWMGenPeriodGet(PWM0_BASE, drive_pwm_generators[motor])
+                << DRIVE_PULSE_SCALE_SHIFT)
+                / ((uint32_t) drive_period_us[motor] * drive_esc_protocol[motor]);
+
+    } //endfor
+
+    PWMSyncUpdate(PWM0_BASE, DRIVE_PWM_GEN_BITS);
+
+} //endfnctn rovePWMSyncInit
+
+void DriveMotorStage(int motor, int speed) {
+
+    PROFILE_BEGIN(PROFILE_DRIVE_STAGE);
+
+    drive_speed[motor] = speed;
+    drive_staged_counts[motor] = (roveCalibrationPulse(motor, speed) * drive_pulse_scale[motor]
+            + (1 << (DRIVE_PULSE_SCALE_SHIFT - 1))) >> DRIVE_PULSE_SCALE_SHIFT;
+    drive_staged_mask |= (1 << motor);
+
+    PROFILE_END(PROFILE_DRIVE_STAGE);
+
+} //endfnctn DriveMotorStage
+
+void DriveMotorCommit(void) {
+
+    int motor;
+    UInt key;
+
+    PROFILE_BEGIN(PROFILE_DRIVE_COMMIT);
+
+    // the deadman Hwi also drives these outputs, keep its writes out of a half done batch
+
+    key = Hwi_disable();
+
+    for (motor = 0; motor < DRIVE_MOTOR_COUNT; motor++) {
+
+        if (drive_staged_mask & (1 << motor)) {
+
+            PWMPulseWidthSet(PWM0_BASE, drive_pwm_outputs[motor],
+                    drive_staged_counts[motor]);
+
+        } //endif
+
+    } //endfor
+
+    drive_staged_mask = 0;
+
+    PWMSyncUpdate(PWM0_BASE, DRIVE_PWM_GEN_BITS);
+
+    Hwi_restore(key);
+
+    PROFILE_END(PROFILE_DRIVE_COMMIT);
+
+} //endfnctn DriveMotorCommit
+
+void roveCalibrationLoad(void) {
+
+    struct calibration_store store;
+
+    roveCalibrationReset();
+
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_EEPROM0);
+
+    while (!SysCtlPeripheralReady(SYSCTL_PERIPH_EEPROM0)) {
+
+    } //endwhile
+
+    if (EEPROMInit() != EEPROM_INIT_OK) {
+
+        roveLogEvent(LOG_HAL_EEPROM_FAILED);
+        return;
+
+    } //endif
+
+    EEPROMRead((uint32_t*) &store, CALIBRATION_EEPROM_ADDRESS, sizeof(store));
+
+    // erased EEPROM reads all ones and fails the magic check: first boot keeps the defaults
+    if (!roveCalibrationRestore(&store)) {
+
+        roveLogEvent(LOG_HAL_NO_CALIBRATION);
+
+    } //endif
+
+} //endfnctn roveCalibrationLoad
+
+bool roveCalibrationSave(void) {
+
+    struct calibration_store store;
+
+    roveCalibrationStore(&store);
+
+    return EEPROMProgram((uint32_t*) &store, CALIBRATION_EEPROM_ADDRESS, sizeof(store)) == 0;
+
+} //endfnctn roveCalibrationSave
+
+bool roveCalibrationApply(int motor, const struct drive_calibration* table) {
+
+    bool applied;
+    UInt key;
+
+    // the profile Swi and the deadman Hwi both stage pulse widths from these tables
+    key = Hwi_disable();
+
+    applied = roveCalibrationSet(motor, table);
+
+    if (applied) {
+
+        DriveMotorStage(motor, drive_speed[motor]);
+        DriveMotorCommit();
+
+    } //endif
+
+    Hwi_restore(key);
+
+    return applied;
+
+} //endfnctn roveCalibrationApply
+
+void roveDriveProfileInit(void) {
+
+    struct speed_control_config speed_control = { SPEED_CONTROL_KP_Q16, SPEED_CONTROL_KI_Q16,
+            SPEED_CONTROL_KD_Q16, SPEED_CONTROL_KFF_Q16, SPEED_CONTROL_FEEDBACK_TIMEOUT_TICKS,
+            SPEED_CONTROL_WINDING_MOHM, SPEED_CONTROL_PACK_MV };
+    int motor;
+
+    roveSpeedControlConfigure(&speed_control);
+
+    for (motor = 0; motor < DRIVE_MOTOR_COUNT; motor++) {
+
+        roveMotionProfileConfigure(motor, MOTION_ACCEL_LIMIT, MOTION_JERK_LIMIT,
+                MOTION_PROFILE_RATE_HZ);
+
+    } //endfor
+
+} //endfnctn roveDriveProfileInit
+
+Void roveMotionProfileTick(UArg arg) {
+
+    int16_t speed;
+    bool changed;
+    bool moved = false;
+    int motor;
+    UInt key;
+
+    PROFILE_BEGIN(PROFILE_MOTION_TICK);
+
+    for (motor = 0; motor < DRIVE_MOTOR_COUNT; motor++) {
+
+        // the deadman Hwi halts motors, keep it from landing in the middle of a step
+        key = Hwi_disable();
+
+        changed = roveMotionProfileStep(motor, &speed);
+
+        // the loop runs every tick, the profile output is its setpoint
+        if (SPEED_CONTROL_CLOSED_LOOP) {
+
+            changed = roveSpeedControlStep(motor, speed, &speed);
+
+        } //endif
+
+        if (changed) {
+
+            DriveMotorStage(motor, speed);
+            moved = true;
+
+        } //endif
+
+        Hwi_restore(key);
+
+    } //endfor
+
+    if (moved) {
+
+        DriveMotorCommit();
+
+    } //endif
+
+    PROFILE_END(PROFILE_MOTION_TICK);
+
+} //endfnctn roveMotionProfileTick
+
+// deadman neutral functions run in the deadmanTimer Hwi: the commit only touches the
+// generator registers, so the drive sides are stopped right there, without a ramp
+
+static void deadmanNeutral(int first_motor) {
+
+    int motor;
+
+    for (motor = first_motor; motor < first_motor + KINEMATICS_SIDE_COUNT; motor++) {
+
+        roveMotionProfileHalt(motor);
+        roveSpeedControlHalt(motor);
+        DriveMotorStage(motor, 0);
+
+    } //endfor
+
+    DriveMotorCommit();
+
+} //endfnctn deadmanNeutral
+
+static void deadmanLeftNeutral(void) {
+
+    deadmanNeutral(KINEMATICS_LEFT_FIRST);
+
+} //endfnctn deadmanLeftNeutral
+
+static void deadmanRightNeutral(void) {
+
+    deadmanNeutral(KINEMATICS_RIGHT_FIRST);
+
+} //endfnctn deadmanRightNeutral
+
+// the arm is stopped over its uart, which only roveCmdCntrl writes: it is woken to send the stop
+
+static volatile bool deadman_arm_stop = false;
+
+static void deadmanArmNeutral(void) {
+
+    deadman_arm_stop = true;
+    roveCmdQueueWake();
+
+} //endfnctn deadmanArmNeutral
+
+void roveDeadmanInitGroups(void) {
+
+    roveDeadmanInit(DEADMAN_LEFT_DRIVE, DEADMAN_WINDOW_MS, deadmanLeftNeutral);
+    roveDeadmanInit(DEADMAN_RIGHT_DRIVE, DEADMAN_WINDOW_MS, deadmanRightNeutral);
+    roveDeadmanInit(DEADMAN_ARM, DEADMAN_WINDOW_MS, deadmanArmNeutral);
+
+} //endfnctn roveDeadmanInitGroups
+
+Void roveDeadmanTimerIsr(UArg arg) {
+
+    roveDeadmanTick(DEADMAN_TICK_MS);
+
+} //endfnctn roveDeadmanTimerIsr
+
+bool roveDeadmanArmStopTake(void) {
+
+    UInt key;
+    bool due;
+
+    key = Hwi_disable();
+
+    due = deadman_arm_stop;
+    deadman_arm_stop = false;
+
+    Hwi_restore(key);
+
+    return due;
+
+} //endfnctn roveDeadmanArmStopTake
+
 int deviceWrite(int rs485jack, char* buffer, int bytes_to_write) {
 
     int bytes_wrote;
 
+    PROFILE_BEGIN(PROFILE_DEVICE_WRITE);
+
     // give us access to the uart handles defined at the global scope in main
 
     //extern UART_Handle uart0;
@@ -235,9 +572,7 @@ int deviceWrite(int rs485jack, char* buffer, int bytes_to_write) {
     case 0:
         break;
     case 1 ... 6:
-     printf(
-                "deviceWrite was called with a deprecated jack! Pin %d is now used for PWM!\n",
-                rs485jack);
+        roveLog(LOG_HAL_DEPRECATED_JACK, rs485jack, 0, 0);
         break;
         /*
          case 1:
@@ -338,7 +673,7 @@ int deviceWrite(int rs485jack, char* buffer, int bytes_to_write) {
         break;
     default:
         //Tried to write to invalid device
-        printf("DeviceWrite passed invalid device %d\n", rs485jack);
+        roveLog(LOG_HAL_INVALID_JACK, rs485jack, 0, 0);
         return -1;
         //etc.
     }    //end switch(rs485jack)
@@ -347,19 +682,19 @@ int deviceWrite(int rs485jack, char* buffer, int bytes_to_write) {
 
     ms_delay(1);
 
+    PROFILE_END(PROFILE_DEVICE_WRITE);
+
     return bytes_wrote;
 
 }		//endfnctn deviceWrite
 
 Void readIntTask(UArg arg0, UArg arg1) {
-	System_printf("ReadIntTask going to sleep for %d ticks\n", (int)arg1);
-  System_flush();
+    roveLog(LOG_HAL_READ_SLEEP, (int) arg1, 0, 0);
     Task_sleep((int) arg1);
 
     UART_readCancel((UART_Handle) arg0);
 
-    System_printf("Canceled uart read\n");
-    System_flush();
+    roveLogEvent(LOG_HAL_READ_CANCELED);
     while (1) // wait for task to be deleted by task that created it
     {
         Task_sleep(10000);
@@ -379,12 +714,12 @@ int UART_read_nonblocking(UART_Handle uart, char* buffer, int bytes_to_read,
     readInterruptTaskParams.priority = -1;
     readInterruptTaskParams.arg0 = (UArg) uart;
     readInterruptTaskParams.arg1 = (UArg) timeout;
+    readInterruptTaskParams.instance->name = "readIntTask";
 
     readInterruptTask = Task_create((Task_FuncPtr) readIntTask,
             &readInterruptTaskParams, &eb);
     if (readInterruptTask == NULL) {
-        System_printf("Failed to create Task in UART_read_nonblocking!\n");
-        System_flush();
+        roveLogEvent(LOG_HAL_READ_TASK_FAILED);
     }
 
     Task_setPri(readInterruptTask, RECV_UART_NONBLOCK_TASK_PRIORITY);
@@ -541,7 +876,7 @@ int deviceRead(int rs485jack, char* buffer, int bytes_to_read, int timeout) {
         break;
     default:
         //Tried to write to invalid device
-        printf("DeviceWrite passed invalid device! We only use GPS_ON_MOB %d\n", rs485jack);
+        roveLog(LOG_HAL_INVALID_READ_JACK, rs485jack, 0, 0);
         return -1;
         //etc.
 
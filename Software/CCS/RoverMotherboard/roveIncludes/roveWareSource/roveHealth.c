@@ -0,0 +1,128 @@
+// roveHealth.c MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#include "../roveWareHeaders/roveHealth.h"
+
+#include <ti/sysbios/hal/Hwi.h>
+#include <ti/sysbios/utils/Load.h>
+#include <xdc/runtime/Memory.h>
+
+static struct task_health_telem tasks[HEALTH_MAX_TASKS];
+static int task_count = 0;
+static int tasks_seen = 0;
+
+// tenths of a percent
+
+static uint16_t loadOf(const Load_Stat* stat) {
+
+    if (stat->totalTime == 0) {
+
+        return 0;
+
+    } //endif
+
+    return (uint16_t) (((uint64_t) stat->threadTime * 1000) / stat->totalTime);
+
+} //endfnctn loadOf
+
+static void readTask(Task_Handle task) {
+
+    struct task_health_telem* health;
+    Task_Stat stat;
+    Load_Stat load;
+    const char* name;
+
+    tasks_seen++;
+
+    if (task_count >= HEALTH_MAX_TASKS) {
+
+        return;
+
+    } //endif
+
+    health = &tasks[task_count];
+
+    Task_stat(task, &stat);
+
+    health->struct_id = task_health_telem_id;
+    health->task = task_count;
+    health->priority = stat.priority;
+    health->load = Load_getTaskLoad(task, &load) ? loadOf(&load) : 0;
+    health->stack_size = stat.stackSize;
+    health->stack_peak = stat.used;
+
+    name = (task == Task_getIdleTask()) ? "idle" : Task_Handle_name(task);
+    memset(health->name, 0, sizeof(health->name));
+
+    if (name != NULL) {
+
+        strncpy(health->name, name, sizeof(health->name));
+
+    } //endif
+
+    task_count++;
+
+} //endfnctn readTask
+
+int roveHealthReport(struct system_health_telem* report) {
+
+    Memory_Stats heap;
+    Hwi_StackInfo hwiStack;
+    Load_Stat swi;
+    Task_Handle task;
+    UInt key;
+    int i;
+
+    // no task can be created or deleted while we walk the lists
+    key = Task_disable();
+
+    task_count = 0;
+    tasks_seen = 0;
+
+    // the cfg tasks and idle, then everything made with Task_create
+    for (i = 0; i < Task_Object_count(); i++) {
+
+        readTask(Task_Object_get(NULL, i));
+
+    } //endfor
+
+    for (task = Task_Object_first(); task != NULL; task = Task_Object_next(task)) {
+
+        readTask(task);
+
+    } //endfor
+
+    Task_restore(key);
+
+    Memory_getStats(NULL, &heap);
+    Hwi_getStackInfo(&hwiStack, TRUE);
+
+    report->struct_id = system_health_telem_id;
+    report->cpu_load = Load_getCPULoad() * 10;
+    report->swi_load = Load_getGlobalSwiLoad(&swi) ? loadOf(&swi) : 0;
+    report->heap_free = heap.totalFreeSize;
+    report->heap_largest_free = heap.largestFreeSize;
+    report->hwi_stack_size = hwiStack.hwiStackSize;
+    report->hwi_stack_peak = hwiStack.hwiStackPeak;
+    report->command_queue_count = roveCmdQueueCount();
+    report->command_queue_high_water = roveCmdQueueHighWater();
+    report->telem_queue_high_water = roveTelemQueueHighWater();
+    report->tasks = tasks_seen;
+    report->msg_pool_in_use = roveMsgPoolInUse();
+    report->msg_pool_high_water = roveMsgPoolHighWater();
+    report->msg_pool_exhausted = roveMsgPoolExhausted();
+
+    return task_count;
+
+} //endfnctn roveHealthReport
+
+void roveHealthTaskReport(int task, struct task_health_telem* report) {
+
+    memcpy(report, &tasks[task], sizeof(*report));
+
+} //endfnctn roveHealthTaskReport
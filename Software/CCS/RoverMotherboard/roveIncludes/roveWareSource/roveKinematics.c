@@ -0,0 +1,120 @@
+// roveKinematics.c MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#include "../roveWareHeaders/roveKinematics.h"
+
+#include <string.h>
+
+// zeroed until configured: no direction, no output
+
+static struct kinematics_config kinematics;
+
+void roveKinematicsConfigure(const struct kinematics_config* config) {
+
+    memcpy(&kinematics, config, sizeof(kinematics));
+
+} //endfnctn roveKinematicsConfigure
+
+static int32_t trimWheel(int wheel, int32_t forward) {
+
+    // 64 bit product: a small max wheel speed can push forward well past full scale
+    return (int32_t) (((int64_t) forward * kinematics.trim_q12[wheel])
+            / KINEMATICS_TRIM_ONE);
+
+} //endfnctn trimWheel
+
+void roveKinematicsMix(const int32_t forward[KINEMATICS_WHEEL_COUNT],
+        int16_t wheel[KINEMATICS_WHEEL_COUNT]) {
+
+    int32_t trimmed[KINEMATICS_WHEEL_COUNT];
+    int32_t largest = 0;
+    int32_t magnitude;
+    int i;
+
+    for (i = 0; i < KINEMATICS_WHEEL_COUNT; i++) {
+
+        trimmed[i] = trimWheel(i, forward[i]);
+
+        magnitude = (trimmed[i] < 0) ? -trimmed[i] : trimmed[i];
+
+        if (magnitude > largest) {
+
+            largest = magnitude;
+
+        } //endif
+
+    } //endfor
+
+    for (i = 0; i < KINEMATICS_WHEEL_COUNT; i++) {
+
+        // one common factor for every wheel keeps the ratio between them, and with it the curvature
+        if (largest > KINEMATICS_FULL_SCALE) {
+
+            trimmed[i] = (int32_t) (((int64_t) trimmed[i] * KINEMATICS_FULL_SCALE)
+                    / largest);
+
+        } //endif
+
+        wheel[i] = (int16_t) (trimmed[i] * kinematics.direction[i]);
+
+    } //endfor
+
+} //endfnctn roveKinematicsMix
+
+void roveKinematicsTwist(int32_t linear_mm_s, int32_t angular_mrad_s,
+        int16_t wheel[KINEMATICS_WHEEL_COUNT]) {
+
+    int32_t forward[KINEMATICS_WHEEL_COUNT];
+    int32_t turn_mm_s;
+    int32_t right;
+    int32_t left;
+    int i;
+
+    if (kinematics.max_wheel_speed_mm_s == 0) {
+
+        memset(wheel, 0, KINEMATICS_WHEEL_COUNT * sizeof(wheel[0]));
+        return;
+
+    } //endif
+
+    // mrad/s * mm / 2000 is the tangential speed of each side in mm/s
+    turn_mm_s = (angular_mrad_s * kinematics.track_width_mm) / 2000;
+
+    right = ((linear_mm_s + turn_mm_s) * KINEMATICS_FULL_SCALE)
+            / kinematics.max_wheel_speed_mm_s;
+    left = ((linear_mm_s - turn_mm_s) * KINEMATICS_FULL_SCALE)
+            / kinematics.max_wheel_speed_mm_s;
+
+    for (i = 0; i < KINEMATICS_SIDE_COUNT; i++) {
+
+        forward[KINEMATICS_RIGHT_FIRST + i] = right;
+        forward[KINEMATICS_LEFT_FIRST + i] = left;
+
+    } //endfor
+
+    roveKinematicsMix(forward, wheel);
+
+} //endfnctn roveKinematicsTwist
+
+int16_t roveKinematicsWheel(int wheel, int32_t forward) {
+
+    int32_t trimmed = trimWheel(wheel, forward);
+
+    if (trimmed > KINEMATICS_FULL_SCALE) {
+
+        trimmed = KINEMATICS_FULL_SCALE;
+
+    } else if (trimmed < -KINEMATICS_FULL_SCALE) {
+
+        trimmed = -KINEMATICS_FULL_SCALE;
+
+    } //endif
+
+    return (int16_t) (trimmed * kinematics.direction[wheel]);
+
+} //endfnctn roveKinematicsWheel
@@ -0,0 +1,194 @@
+// roveLinkStats.c MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#include "../roveWareHeaders/roveLinkStats.h"
+
+// ring of the most recent rtts in microseconds
+
+static uint32_t rtt_window[LINK_RTT_WINDOW];
+static int rtt_next = 0;
+static int rtt_samples = 0;
+
+// smoothed rtt and mean deviation, same gains as TCP (RFC 6298): 1/8 and 1/4
+
+static uint32_t srtt_us = 0;
+static uint32_t rttvar_us = 0;
+
+static uint16_t next_seq = 0;
+static uint16_t last_echo_seq = 0;
+static bool echo_seen = false;
+static uint16_t heartbeats_lost = 0;
+
+static bool heartbeat_sent = false;
+static uint32_t last_echo_us = 0;
+
+static uint16_t telem_sent = 0;
+
+void roveLinkStatsReset(void) {
+
+    UInt key = Task_disable();
+
+    rtt_next = 0;
+    rtt_samples = 0;
+    srtt_us = 0;
+    rttvar_us = 0;
+    echo_seen = false;
+    heartbeats_lost = 0;
+    heartbeat_sent = false;
+    last_echo_us = roveGetMicros();
+    telem_sent = 0;
+
+    Task_restore(key);
+
+} //endfnctn roveLinkStatsReset
+
+void roveLinkHeartbeatBuild(struct heartbeat_struct* heartbeat) {
+
+    heartbeat->seq = next_seq++;
+    heartbeat->rover_tx_us = roveGetMicros();
+    heartbeat->base_rx_us = 0;
+    heartbeat->base_tx_us = 0;
+
+    // the timeout runs from the first heartbeat after a (re)connect
+    if (!heartbeat_sent) {
+
+        last_echo_us = heartbeat->rover_tx_us;
+        heartbeat_sent = true;
+
+    } //endif
+
+} //endfnctn roveLinkHeartbeatBuild
+
+void roveLinkHeartbeatEcho(const struct heartbeat_struct* heartbeat) {
+
+    uint32_t now = roveGetMicros();
+    uint32_t rtt = (now - heartbeat->rover_tx_us)
+            - (heartbeat->base_tx_us - heartbeat->base_rx_us);
+    uint32_t error;
+    UInt key;
+
+    key = Task_disable();
+
+    // late or duplicated echo, already accounted as lost
+    if (echo_seen && (int16_t) (heartbeat->seq - last_echo_seq) <= 0) {
+
+        Task_restore(key);
+        return;
+
+    } //endif
+
+    if (echo_seen) {
+
+        heartbeats_lost += (uint16_t) (heartbeat->seq - last_echo_seq - 1);
+
+    } //endif
+
+    last_echo_seq = heartbeat->seq;
+    last_echo_us = now;
+
+    if (!echo_seen) {
+
+        srtt_us = rtt;
+        rttvar_us = rtt / 2;
+        echo_seen = true;
+
+    } else {
+
+        error = (rtt > srtt_us) ? (rtt - srtt_us) : (srtt_us - rtt);
+        rttvar_us = rttvar_us - (rttvar_us >> 2) + (error >> 2);
+        srtt_us = srtt_us - (srtt_us >> 3) + (rtt >> 3);
+
+    } //endif
+
+    rtt_window[rtt_next] = rtt;
+    rtt_next = (rtt_next + 1) % LINK_RTT_WINDOW;
+
+    if (rtt_samples < LINK_RTT_WINDOW) {
+
+        rtt_samples++;
+
+    } //endif
+
+    Task_restore(key);
+
+} //endfnctn roveLinkHeartbeatEcho
+
+bool roveLinkIsDead(void) {
+
+    // heartbeats off, or a base station that never echoed: it doesn't speak heartbeat, leave it to TCP
+    return LINK_HEARTBEAT_ENABLED && heartbeat_sent && echo_seen
+            && ((roveGetMicros() - last_echo_us) > (HEARTBEAT_TIMEOUT_MS * 1000));
+
+} //endfnctn roveLinkIsDead
+
+void roveLinkTelemSent(void) {
+
+    telem_sent++;
+
+} //endfnctn roveLinkTelemSent
+
+uint32_t roveLinkSmoothedRtt(void) {
+
+    return srtt_us;
+
+} //endfnctn roveLinkSmoothedRtt
+
+void roveLinkStatsReport(struct link_stats_telem* report) {
+
+    uint32_t sorted[LINK_RTT_WINDOW];
+    uint32_t value;
+    int count;
+    int i, j;
+    UInt key;
+
+    key = Task_disable();
+
+    count = rtt_samples;
+    memcpy(sorted, rtt_window, count * sizeof(sorted[0]));
+
+    report->struct_id = link_stats_telem_id;
+    report->samples = count;
+    report->srtt_us = srtt_us;
+    report->rttvar_us = rttvar_us;
+    report->heartbeats_lost = heartbeats_lost;
+    report->telem_sent = telem_sent;
+
+    Task_restore(key);
+
+    // insertion sort, the window is small and this only runs once a second
+    for (i = 1; i < count; i++) {
+
+        value = sorted[i];
+
+        for (j = i; (j > 0) && (sorted[j - 1] > value); j--) {
+
+            sorted[j] = sorted[j - 1];
+
+        } //endfor
+
+        sorted[j] = value;
+
+    } //endfor
+
+    if (count == 0) {
+
+        report->p50_us = 0;
+        report->p90_us = 0;
+        report->p99_us = 0;
+        report->max_us = 0;
+
+    } else {
+
+        report->p50_us = sorted[(count * 50) / 100];
+        report->p90_us = sorted[(count * 90) / 100];
+        report->p99_us = sorted[(count * 99) / 100];
+        report->max_us = sorted[count - 1];
+
+    } //endif
+
+} //endfnctn roveLinkStatsReport
@@ -0,0 +1,137 @@
+// roveLog.c MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#include "../roveWareHeaders/roveLog.h"
+
+#include <stddef.h>
+
+#define LOG_RING_MASK (LOG_RING_SIZE - 1)
+
+#define LOG_TAG(place, event) ((uint16_t) ((((place) & 0xFF) << 8) | (event)))
+
+static volatile struct log_entry ring[LOG_RING_SIZE];
+
+// places handed out, a writer may still be filling in the newest ones
+
+static volatile uint32_t written = 0;
+
+static volatile bool requested = false;
+
+static uint32_t (*log_clock)(void) = NULL;
+static uint32_t (*log_lock)(void) = NULL;
+static void (*log_unlock)(uint32_t key) = NULL;
+
+static uint32_t now(void) {
+
+    return (log_clock != NULL) ? log_clock() : 0;
+
+} //endfnctn now
+
+void roveLogInit(uint32_t (*clock)(void), uint32_t (*lock)(void), void (*unlock)(uint32_t key)) {
+
+    log_clock = clock;
+    log_lock = lock;
+    log_unlock = unlock;
+
+} //endfnctn roveLogInit
+
+void roveLog(uint8_t event, int16_t arg0, int16_t arg1, int16_t arg2) {
+
+    volatile struct log_entry* entry;
+    uint32_t place;
+    uint32_t key = 0;
+
+    // only taking the place needs to be atomic, every writer then has its own entry
+    if (log_lock != NULL) {
+
+        key = log_lock();
+
+    } //endif
+
+    place = written++;
+
+    if (log_unlock != NULL) {
+
+        log_unlock(key);
+
+    } //endif
+
+    entry = &ring[place & LOG_RING_MASK];
+
+    entry->us = now();
+    entry->arg[0] = arg0;
+    entry->arg[1] = arg1;
+    entry->arg[2] = arg2;
+    entry->tag = LOG_TAG(place, event);
+
+} //endfnctn roveLog
+
+void roveLogSnapshot(struct log_report* report, struct log_entry entries[LOG_RING_SIZE]) {
+
+    uint32_t first;
+    uint32_t last;
+    uint32_t oldest;
+    uint32_t place;
+    int kept = 0;
+
+    last = written;
+    first = (last > LOG_RING_SIZE) ? last - LOG_RING_SIZE : 0;
+
+    for (place = first; place < last; place++) {
+
+        entries[place - first] = ring[place & LOG_RING_MASK];
+
+    } //endfor
+
+    // a place handed out while we copied may have overwritten one we copied
+    oldest = written;
+    oldest = (oldest > LOG_RING_SIZE) ? oldest - LOG_RING_SIZE : 0;
+
+    report->now_us = now();
+    report->first = (oldest > first) ? oldest : first;
+    report->written = last;
+    report->entry_size = sizeof(struct log_entry);
+
+    // oldest first, dropping entries a writer had not finished. No event is 0, so a zero tag
+    // is a place never written, which would otherwise pass for place 0
+    for (place = first; place < last; place++) {
+
+        if ((place < oldest) || ((entries[place - first].tag >> 8) != (place & 0xFF))
+                || ((entries[place - first].tag & 0xFF) == 0)) {
+
+            continue;
+
+        } //endif
+
+        entries[kept++] = entries[place - first];
+
+    } //endfor
+
+    report->entries = kept;
+
+} //endfnctn roveLogSnapshot
+
+void roveLogRequest(void) {
+
+    requested = true;
+
+} //endfnctn roveLogRequest
+
+bool roveLogTakeRequest(void) {
+
+    if (!requested) {
+
+        return false;
+
+    } //endif
+
+    requested = false;
+
+    return true;
+
+} //endfnctn roveLogTakeRequest
@@ -0,0 +1,170 @@
+// roveMotionProfile.c MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#include "../roveWareHeaders/roveMotionProfile.h"
+
+// all Q16 DriveMotor units, accel per tick and jerk per tick per tick. accel is always the
+// speed change of the last tick, so bounding each change of it by jerk_limit bounds the jerk
+
+struct motion_profile {
+
+    int32_t target;
+    int32_t speed;
+    int32_t accel;
+    int32_t accel_limit;
+    int32_t jerk_limit;
+    int16_t output;
+
+};
+
+static struct motion_profile profiles[MOTION_PROFILE_MOTORS];
+
+static int32_t absolute(int32_t value) {
+
+    return (value < 0) ? -value : value;
+
+} //endfnctn absolute
+
+void roveMotionProfileConfigure(int motor, uint32_t accel_limit,
+        uint32_t jerk_limit, uint32_t rate_hz) {
+
+    struct motion_profile* profile = &profiles[motor];
+
+    profile->accel_limit = (int32_t) (((uint64_t) accel_limit << 16) / rate_hz);
+    profile->jerk_limit = (int32_t) ((((uint64_t) jerk_limit << 16) / rate_hz)
+            / rate_hz);
+
+    if ((accel_limit != 0) && (profile->jerk_limit == 0)) {
+
+        profile->jerk_limit = 1;
+
+    } //endif
+
+} //endfnctn roveMotionProfileConfigure
+
+void roveMotionProfileSetTarget(int motor, int16_t speed) {
+
+    profiles[motor].target = (int32_t) speed << 16;
+
+} //endfnctn roveMotionProfileSetTarget
+
+void roveMotionProfileHalt(int motor) {
+
+    struct motion_profile* profile = &profiles[motor];
+
+    profile->target = 0;
+    profile->speed = 0;
+    profile->accel = 0;
+    profile->output = 0;
+
+} //endfnctn roveMotionProfileHalt
+
+bool roveMotionProfileStep(int motor, int16_t* output) {
+
+    struct motion_profile* profile = &profiles[motor];
+    int32_t error = profile->target - profile->speed;
+    int32_t jerk = profile->jerk_limit;
+    int32_t stop_accel;
+    int32_t wanted;
+    int16_t previous = profile->output;
+
+    if (profile->accel_limit == 0) {
+
+        profile->speed = profile->target;
+        profile->accel = 0;
+
+    } else if ((error == 0) && (profile->accel == 0)) {
+
+        // settled, nothing to do: the usual case between commands
+
+    } else if ((absolute(error) <= jerk) && (absolute(error - profile->accel) <= jerk)) {
+
+        // reaches the target this tick one jerk step from the last accel, and the next
+        // tick's accel of 0 is one jerk step from this one
+        profile->speed = profile->target;
+        profile->accel = error;
+
+    } else {
+
+        // ramping accel a down to 0 one jerk step j at a time covers a (a + j) / 2j more speed,
+        // so the most accel that still stops on the target is (sqrt(j^2 + 8 j e) - j) / 2
+        stop_accel = (int32_t) ((roveIsqrt64((uint64_t) jerk * jerk
+                + 8 * (uint64_t) jerk * absolute(error)) - jerk) / 2);
+
+        if (stop_accel > profile->accel_limit) {
+
+            stop_accel = profile->accel_limit;
+
+        } //endif
+
+        wanted = (error < 0) ? -stop_accel : stop_accel;
+
+        if (wanted > profile->accel + jerk) {
+
+            profile->accel += jerk;
+
+        } else if (wanted < profile->accel - jerk) {
+
+            profile->accel -= jerk;
+
+        } else {
+
+            profile->accel = wanted;
+
+        } //endif
+
+        profile->speed += profile->accel;
+
+    } //endif
+
+    // round to the nearest DriveMotor unit
+    profile->output = (int16_t) ((profile->speed + (1 << 15)) >> 16);
+    *output = profile->output;
+
+    return profile->output != previous;
+
+} //endfnctn roveMotionProfileStep
+
+int32_t roveMotionProfileSpeed(int motor) {
+
+    return profiles[motor].speed;
+
+} //endfnctn roveMotionProfileSpeed
+
+uint32_t roveIsqrt64(uint64_t value) {
+
+    uint64_t root = 0;
+    uint64_t bit = (uint64_t) 1 << 62;
+
+    // digit by digit, two bits of value per bit of root
+    while (bit > value) {
+
+        bit >>= 2;
+
+    } //endwhile
+
+    while (bit != 0) {
+
+        if (value >= root + bit) {
+
+            value -= root + bit;
+            root = (root >> 1) + bit;
+
+        } else {
+
+            root >>= 1;
+
+        } //endif
+
+        bit >>= 2;
+
+    } //endwhile
+
+    return (uint32_t) root;
+
+} //endfnctn roveIsqrt64
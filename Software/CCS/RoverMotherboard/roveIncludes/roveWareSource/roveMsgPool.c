@@ -0,0 +1,127 @@
+// roveMsgPool.c MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#include "../roveWareHeaders/roveMsgPool.h"
+
+#include <ti/sysbios/hal/Hwi.h>
+
+// the headroom sits right in front of the id, so a frame is one contiguous run of bytes
+
+struct msg_buffer {
+
+    char headroom[MSG_FRAME_HEADER];
+    base_station_msg_struct message;
+
+}__attribute__((packed));
+
+static struct msg_buffer pool[MSG_POOL_SIZE];
+
+// indices of the free buffers, the top of the stack is the next one handed out
+
+static uint8_t free_buffers[MSG_POOL_SIZE];
+static int free_count = 0;
+
+static int high_water = 0;
+static uint32_t exhausted = 0;
+
+void roveMsgPoolInit(void) {
+
+    int i;
+
+    for (i = 0; i < MSG_POOL_SIZE; i++) {
+
+        free_buffers[i] = i;
+
+    } //endfor
+
+    free_count = MSG_POOL_SIZE;
+
+} //endfnctn roveMsgPoolInit
+
+static int take(void) {
+
+    int buffer = -1;
+    UInt key;
+
+    key = Hwi_disable();
+
+    if (free_count > 0) {
+
+        buffer = free_buffers[--free_count];
+
+        if ((MSG_POOL_SIZE - free_count) > high_water) {
+
+            high_water = MSG_POOL_SIZE - free_count;
+
+        } //endif
+
+    } else {
+
+        exhausted++;
+
+    } //endif
+
+    Hwi_restore(key);
+
+    return buffer;
+
+} //endfnctn take
+
+int roveMsgPoolAlloc(void) {
+
+    int buffer;
+
+    while ((buffer = take()) < 0) {
+
+        Task_sleep(1);
+
+    } //endwhile
+
+    return buffer;
+
+} //endfnctn roveMsgPoolAlloc
+
+void roveMsgPoolFree(int buffer) {
+
+    UInt key;
+
+    key = Hwi_disable();
+    free_buffers[free_count++] = buffer;
+    Hwi_restore(key);
+
+} //endfnctn roveMsgPoolFree
+
+base_station_msg_struct* roveMsgPoolMessage(int buffer) {
+
+    return &pool[buffer].message;
+
+} //endfnctn roveMsgPoolMessage
+
+char* roveMsgPoolHeadroom(int buffer) {
+
+    return pool[buffer].headroom;
+
+} //endfnctn roveMsgPoolHeadroom
+
+int roveMsgPoolInUse(void) {
+
+    return MSG_POOL_SIZE - free_count;
+
+} //endfnctn roveMsgPoolInUse
+
+int roveMsgPoolHighWater(void) {
+
+    return high_water;
+
+} //endfnctn roveMsgPoolHighWater
+
+uint32_t roveMsgPoolExhausted(void) {
+
+    return exhausted;
+
+} //endfnctn roveMsgPoolExhausted
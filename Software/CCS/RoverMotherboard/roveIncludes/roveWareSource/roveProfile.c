@@ -0,0 +1,118 @@
+// roveProfile.c MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#include "../roveWareHeaders/roveProfile.h"
+
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/hal/Hwi.h>
+#include <xdc/runtime/Types.h>
+
+// DEMCR.TRCENA powers the DWT, DWT_CTRL.CYCCNTENA starts the counter
+
+#define PROFILE_DEMCR (*((volatile uint32_t*) 0xE000EDFC))
+#define PROFILE_DEMCR_TRCENA (1 << 24)
+
+#define PROFILE_DWT_CTRL (*((volatile uint32_t*) 0xE0001000))
+#define PROFILE_DWT_CTRL_CYCCNTENA 1
+
+struct profile_probe {
+
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+
+};
+
+static struct profile_probe probes[PROFILE_PROBES];
+
+static volatile bool requested = false;
+
+void roveProfileInit(void) {
+
+    memset(probes, 0, sizeof(probes));
+
+    PROFILE_DEMCR |= PROFILE_DEMCR_TRCENA;
+    PROFILE_CYCLE_COUNTER = 0;
+    PROFILE_DWT_CTRL |= PROFILE_DWT_CTRL_CYCCNTENA;
+
+} //endfnctn roveProfileInit
+
+void roveProfileRecord(int probe, uint32_t cycles) {
+
+    struct profile_probe* entry = &probes[probe];
+    UInt key;
+
+    // a few stores, short enough to keep every thread out
+    key = Hwi_disable();
+
+    if ((entry->count == 0) || (cycles < entry->min)) {
+
+        entry->min = cycles;
+
+    } //endif
+
+    if (cycles > entry->max) {
+
+        entry->max = cycles;
+
+    } //endif
+
+    entry->total += cycles;
+    entry->count++;
+
+    Hwi_restore(key);
+
+} //endfnctn roveProfileRecord
+
+void roveProfileReport(struct profile_report* report) {
+
+    struct profile_probe entry;
+    Types_FreqHz freq;
+    UInt key;
+    int probe;
+
+    BIOS_getCpuFreq(&freq);
+
+    report->cpu_hz = freq.lo;
+    report->probes = PROFILE_PROBES;
+
+    for (probe = 0; probe < PROFILE_PROBES; probe++) {
+
+        key = Hwi_disable();
+        entry = probes[probe];
+        Hwi_restore(key);
+
+        report->probe[probe].count = entry.count;
+        report->probe[probe].min = entry.min;
+        report->probe[probe].max = entry.max;
+        report->probe[probe].mean = (entry.count > 0) ? (uint32_t) (entry.total / entry.count) : 0;
+
+    } //endfor
+
+} //endfnctn roveProfileReport
+
+void roveProfileRequest(void) {
+
+    requested = true;
+
+} //endfnctn roveProfileRequest
+
+bool roveProfileTakeRequest(void) {
+
+    if (!requested) {
+
+        return false;
+
+    } //endif
+
+    requested = false;
+
+    return true;
+
+} //endfnctn roveProfileTakeRequest
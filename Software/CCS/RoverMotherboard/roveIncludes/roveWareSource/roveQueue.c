@@ -0,0 +1,178 @@
+// roveQueue.c MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#include "../roveWareHeaders/roveQueue.h"
+
+#include <stddef.h>
+#include <string.h>
+
+// the record has to be in the ring before the index that hands it over moves. One core on the
+// rover, so only the compiler could reorder them; a host test runs real threads on several
+
+#if defined(__TI_COMPILER_VERSION__)
+#define QUEUE_BARRIER() __asm(" dmb")
+#else
+#define QUEUE_BARRIER() __sync_synchronize()
+#endif
+
+#define QUEUE_LENGTH_SIZE 2
+
+static void copyIn(struct rove_queue* queue, uint32_t at, const void* data, uint32_t length) {
+
+    uint32_t offset = at & (queue->size - 1);
+    uint32_t first = queue->size - offset;
+
+    if (length == 0) {
+
+        return;
+
+    } //endif
+
+    if (first > length) {
+
+        first = length;
+
+    } //endif
+
+    memcpy(queue->buffer + offset, data, first);
+    memcpy(queue->buffer, (const uint8_t*) data + first, length - first);
+
+} //endfnctn copyIn
+
+static void copyOut(const struct rove_queue* queue, uint32_t at, void* data, uint32_t length) {
+
+    uint32_t offset = at & (queue->size - 1);
+    uint32_t first = queue->size - offset;
+
+    if (length == 0) {
+
+        return;
+
+    } //endif
+
+    if (first > length) {
+
+        first = length;
+
+    } //endif
+
+    memcpy(data, queue->buffer + offset, first);
+    memcpy((uint8_t*) data + first, queue->buffer, length - first);
+
+} //endfnctn copyOut
+
+void roveQueueInit(struct rove_queue* queue, uint8_t* buffer, uint32_t size,
+        void (*wakeup)(void* arg), void* wakeup_arg) {
+
+    memset(queue, 0, sizeof(*queue));
+
+    queue->buffer = buffer;
+    queue->size = size;
+    queue->wakeup = wakeup;
+    queue->wakeup_arg = wakeup_arg;
+
+} //endfnctn roveQueueInit
+
+bool roveQueuePush(struct rove_queue* queue, const void* header, uint16_t header_length,
+        const void* body, uint16_t body_length) {
+
+    uint32_t head = queue->head;
+    uint16_t length = header_length + body_length;
+    uint32_t waiting;
+
+    if ((queue->size - (head - queue->tail)) < (uint32_t) (QUEUE_LENGTH_SIZE + length)) {
+
+        queue->full++;
+        return false;
+
+    } //endif
+
+    copyIn(queue, head, &length, QUEUE_LENGTH_SIZE);
+    copyIn(queue, head + QUEUE_LENGTH_SIZE, header, header_length);
+    copyIn(queue, head + QUEUE_LENGTH_SIZE + header_length, body, body_length);
+
+    // counted before it is visible, so the consumer can never have popped more than this
+    queue->pushed++;
+
+    QUEUE_BARRIER();
+
+    queue->head = head + QUEUE_LENGTH_SIZE + length;
+
+    waiting = queue->pushed - queue->popped;
+
+    if (waiting > queue->high_water) {
+
+        queue->high_water = waiting;
+
+    } //endif
+
+    if (queue->wakeup != NULL) {
+
+        queue->wakeup(queue->wakeup_arg);
+
+    } //endif
+
+    return true;
+
+} //endfnctn roveQueuePush
+
+int roveQueuePop(struct rove_queue* queue, void* header, uint16_t header_length, void* body,
+        uint16_t body_max) {
+
+    uint32_t tail = queue->tail;
+    uint16_t length;
+    uint16_t rest;
+
+    if (queue->head == tail) {
+
+        return -1;
+
+    } //endif
+
+    // the head we just read covers the whole record
+    QUEUE_BARRIER();
+
+    copyOut(queue, tail, &length, QUEUE_LENGTH_SIZE);
+
+    if (header_length > length) {
+
+        header_length = length;
+
+    } //endif
+
+    rest = length - header_length;
+
+    copyOut(queue, tail + QUEUE_LENGTH_SIZE, header, header_length);
+    copyOut(queue, tail + QUEUE_LENGTH_SIZE + header_length, body, (rest < body_max) ? rest : body_max);
+
+    QUEUE_BARRIER();
+
+    queue->tail = tail + QUEUE_LENGTH_SIZE + length;
+    queue->popped++;
+
+    return rest;
+
+} //endfnctn roveQueuePop
+
+int roveQueueCount(const struct rove_queue* queue) {
+
+    return queue->pushed - queue->popped;
+
+} //endfnctn roveQueueCount
+
+uint32_t roveQueueHighWater(const struct rove_queue* queue) {
+
+    return queue->high_water;
+
+} //endfnctn roveQueueHighWater
+
+uint32_t roveQueueFull(const struct rove_queue* queue) {
+
+    return queue->full;
+
+} //endfnctn roveQueueFull
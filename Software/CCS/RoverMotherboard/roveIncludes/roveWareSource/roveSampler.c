@@ -0,0 +1,226 @@
+// roveSampler.c MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#include "../roveWareHeaders/roveSampler.h"
+
+#include <ti/sysbios/family/arm/m3/Hwi.h>
+#include <xdc/runtime/Types.h>
+
+#include "driverlib/sysctl.h"
+#include "driverlib/timer.h"
+#include "inc/hw_ints.h"
+
+#define SAMPLER_RING_MASK (SAMPLER_RING_SIZE - 1)
+
+#define SAMPLER_TIMER_PERIPH SYSCTL_PERIPH_TIMER7
+#define SAMPLER_TIMER_BASE TIMER7_BASE
+#define SAMPLER_TIMER_INT INT_TIMER7A
+
+// EXC_RETURN bit 2: the interrupted code was on the process stack, which BIOS gives to tasks
+
+#define SAMPLER_EXC_RETURN_PSP 0x4
+
+// stacked frame: r0 r1 r2 r3 r12 lr pc xpsr
+
+#define SAMPLER_FRAME_PC 6
+#define SAMPLER_FRAME_XPSR 7
+#define SAMPLER_IPSR_MASK 0x1FF
+
+// the interrupt handler is the only writer of head, roveSamplerTake the only writer of tail
+
+static volatile struct sampler_sample ring[SAMPLER_RING_SIZE];
+static volatile uint32_t head = 0;
+static volatile uint32_t tail = 0;
+static volatile uint32_t dropped = 0;
+
+static volatile bool requested = false;
+
+void roveSamplerIsr(void);
+
+void roveSamplerRecord(uint32_t* frame, uint32_t exc_return);
+
+// the interrupted program counter is on whichever stack was in use when the timer fired, so
+// the vector goes here first: frame pointer in r0, EXC_RETURN in r1, and roveSamplerRecord
+// returns from the interrupt for us
+
+__asm("	.sect \".text\"");
+__asm("	.thumb");
+__asm("	.global roveSamplerIsr");
+__asm("	.global roveSamplerRecord");
+__asm("roveSamplerIsr: .asmfunc");
+__asm("	tst lr, #4");
+__asm("	ite eq");
+__asm("	mrseq r0, msp");
+__asm("	mrsne r0, psp");
+__asm("	mov r1, lr");
+__asm("	b roveSamplerRecord");
+__asm("	.endasmfunc");
+
+void roveSamplerRecord(uint32_t* frame, uint32_t exc_return) {
+
+    volatile struct sampler_sample* sample;
+    uint32_t place = head;
+
+    TimerIntClear(SAMPLER_TIMER_BASE, TIMER_TIMA_TIMEOUT);
+
+    if ((place - tail) >= SAMPLER_RING_SIZE) {
+
+        dropped++;
+        return;
+
+    } //endif
+
+    sample = &ring[place & SAMPLER_RING_MASK];
+
+    sample->pc = frame[SAMPLER_FRAME_PC];
+
+    // Task_self only reads the scheduler's current task, the one BIOS call safe from here
+    if (exc_return & SAMPLER_EXC_RETURN_PSP) {
+
+        sample->task = (uint32_t) Task_self();
+
+    } else {
+
+        sample->task = frame[SAMPLER_FRAME_XPSR] & SAMPLER_IPSR_MASK;
+
+    } //endif
+
+    head = place + 1;
+
+} //endfnctn roveSamplerRecord
+
+void roveSamplerInit(void) {
+
+    Types_FreqHz freq;
+
+    BIOS_getCpuFreq(&freq);
+
+    SysCtlPeripheralEnable(SAMPLER_TIMER_PERIPH);
+
+    while (!SysCtlPeripheralReady(SAMPLER_TIMER_PERIPH)) {
+
+    } //endwhile
+
+    TimerConfigure(SAMPLER_TIMER_BASE, TIMER_CFG_PERIODIC);
+    TimerLoadSet(SAMPLER_TIMER_BASE, TIMER_A, (freq.lo / SAMPLER_RATE_HZ) - 1);
+
+    // priority 0 is above Hwi.disablePriority, the dispatcher never sees this interrupt
+    Hwi_plug(SAMPLER_TIMER_INT, (Void*) roveSamplerIsr);
+    Hwi_setPriority(SAMPLER_TIMER_INT, 0);
+
+    TimerIntEnable(SAMPLER_TIMER_BASE, TIMER_TIMA_TIMEOUT);
+    Hwi_enableInterrupt(SAMPLER_TIMER_INT);
+    TimerEnable(SAMPLER_TIMER_BASE, TIMER_A);
+
+} //endfnctn roveSamplerInit
+
+static int readTasks(struct sampler_task tasks[HEALTH_MAX_TASKS]) {
+
+    Task_Handle task;
+    const char* name;
+    int count = 0;
+    int i;
+
+    // the cfg tasks and idle, then everything made with Task_create
+    for (i = 0; (i < Task_Object_count()) && (count < HEALTH_MAX_TASKS); i++) {
+
+        task = Task_Object_get(NULL, i);
+        tasks[count].handle = (uint32_t) task;
+        name = (task == Task_getIdleTask()) ? "idle" : Task_Handle_name(task);
+        memset(tasks[count].name, 0, sizeof(tasks[count].name));
+
+        if (name != NULL) {
+
+            strncpy(tasks[count].name, name, sizeof(tasks[count].name));
+
+        } //endif
+
+        count++;
+
+    } //endfor
+
+    for (task = Task_Object_first(); (task != NULL) && (count < HEALTH_MAX_TASKS); task = Task_Object_next(task)) {
+
+        tasks[count].handle = (uint32_t) task;
+        name = Task_Handle_name(task);
+        memset(tasks[count].name, 0, sizeof(tasks[count].name));
+
+        if (name != NULL) {
+
+            strncpy(tasks[count].name, name, sizeof(tasks[count].name));
+
+        } //endif
+
+        count++;
+
+    } //endfor
+
+    return count;
+
+} //endfnctn readTasks
+
+void roveSamplerTake(struct sampler_report* report, struct sampler_task tasks[HEALTH_MAX_TASKS],
+        struct sampler_sample samples[SAMPLER_BATCH]) {
+
+    uint32_t first = tail;
+    uint32_t count = head - first;
+    uint32_t i;
+    UInt key;
+
+    if (count > SAMPLER_BATCH) {
+
+        count = SAMPLER_BATCH;
+
+    } //endif
+
+    for (i = 0; i < count; i++) {
+
+        samples[i] = ring[(first + i) & SAMPLER_RING_MASK];
+
+    } //endfor
+
+    // hand the slots back only once they are copied
+    tail = first + count;
+
+    // no task can be created or deleted while we walk the lists
+    key = Task_disable();
+    report->tasks = readTasks(tasks);
+    Task_restore(key);
+
+    report->rate_hz = SAMPLER_RATE_HZ;
+    report->taken = head + dropped;
+    report->dropped = dropped;
+    report->samples = count;
+
+} //endfnctn roveSamplerTake
+
+int roveSamplerPending(void) {
+
+    return head - tail;
+
+} //endfnctn roveSamplerPending
+
+void roveSamplerRequest(void) {
+
+    requested = true;
+
+} //endfnctn roveSamplerRequest
+
+bool roveSamplerTakeRequest(void) {
+
+    if (!requested) {
+
+        return false;
+
+    } //endif
+
+    requested = false;
+
+    return true;
+
+} //endfnctn roveSamplerTakeRequest
@@ -0,0 +1,158 @@
+// roveSpeedControl.c MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#include "../roveWareHeaders/roveSpeedControl.h"
+
+#include <string.h>
+
+// integral and derivative terms are Q16 DriveMotor units
+
+struct speed_control_wheel {
+
+    int32_t integral;
+    int32_t derivative;
+    int32_t measured;
+    int32_t previous_measured;
+    uint16_t feedback_age;
+    bool fresh;
+    bool closed;
+    int16_t output;
+
+};
+
+static struct speed_control_config control;
+
+static struct speed_control_wheel wheels[SPEED_CONTROL_WHEELS];
+
+#define FULL_SCALE_Q16 ((int32_t) SPEED_CONTROL_FULL_SCALE << 16)
+
+static int32_t clamp(int64_t value, int32_t limit) {
+
+    if (value > limit) {
+
+        return limit;
+
+    } else if (value < -limit) {
+
+        return -limit;
+
+    } //endif
+
+    return (int32_t) value;
+
+} //endfnctn clamp
+
+void roveSpeedControlConfigure(const struct speed_control_config* config) {
+
+    memcpy(&control, config, sizeof(control));
+    memset(wheels, 0, sizeof(wheels));
+
+} //endfnctn roveSpeedControlConfigure
+
+void roveSpeedControlHalt(int wheel) {
+
+    memset(&wheels[wheel], 0, sizeof(wheels[wheel]));
+
+} //endfnctn roveSpeedControlHalt
+
+void roveSpeedControlFeedback(int wheel, int32_t speed) {
+
+    struct speed_control_wheel* state = &wheels[wheel];
+
+    state->measured = speed;
+    state->feedback_age = 0;
+    state->fresh = true;
+
+} //endfnctn roveSpeedControlFeedback
+
+void roveSpeedControlCurrent(int wheel, int32_t current_ma) {
+
+    int32_t command = wheels[wheel].output;
+    int32_t drop;
+
+    if (control.pack_mv == 0) {
+
+        return;
+
+    } //endif
+
+    // mA * mohm is uV, over the pack in mV is DriveMotor units. The current sensor reads a
+    // magnitude, the drop is taken off in the direction the wheel is being driven
+    drop = (int32_t) (((int64_t) (current_ma < 0 ? -current_ma : current_ma) * control.winding_mohm)
+            / control.pack_mv);
+
+    roveSpeedControlFeedback(wheel, (command < 0) ? command + drop : command - drop);
+
+} //endfnctn roveSpeedControlCurrent
+
+bool roveSpeedControlStep(int wheel, int16_t setpoint, int16_t* output) {
+
+    struct speed_control_wheel* state = &wheels[wheel];
+    int16_t previous = state->output;
+    int32_t error;
+    int64_t proportional;
+    int64_t feedforward;
+    int64_t sum;
+
+    if (state->fresh) {
+
+        // derivative on the measurement, once per new sample: no kick on a setpoint step and
+        // no spike from a measurement held over many ticks
+        state->derivative = (state->closed) ? (int32_t) ((int64_t) control.kd_q16
+                * (state->previous_measured - state->measured)) : 0;
+        state->previous_measured = state->measured;
+        state->fresh = false;
+        state->closed = true;
+
+    } else if (state->closed && (++state->feedback_age >= control.feedback_timeout_ticks)) {
+
+        // feedback went quiet: open loop, and start clean when it comes back
+        state->integral = 0;
+        state->derivative = 0;
+        state->closed = false;
+
+    } //endif
+
+    if (!state->closed) {
+
+        state->output = setpoint;
+        *output = setpoint;
+
+        return state->output != previous;
+
+    } //endif
+
+    error = setpoint - state->measured;
+
+    proportional = (int64_t) control.kp_q16 * error;
+    feedforward = (int64_t) control.kff_q16 * setpoint;
+
+    // integrate only when it would not push further into a limit the output is already on
+    if (!((previous >= SPEED_CONTROL_FULL_SCALE) && (error > 0))
+            && !((previous <= -SPEED_CONTROL_FULL_SCALE) && (error < 0))) {
+
+        state->integral = clamp((int64_t) state->integral + (int64_t) control.ki_q16 * error,
+                FULL_SCALE_Q16);
+
+    } //endif
+
+    sum = feedforward + proportional + state->integral + state->derivative;
+
+    // round to the nearest DriveMotor unit
+    state->output = (int16_t) ((clamp(sum, FULL_SCALE_Q16) + (1 << 15)) >> 16);
+    *output = state->output;
+
+    return state->output != previous;
+
+} //endfnctn roveSpeedControlStep
+
+bool roveSpeedControlIsClosed(int wheel) {
+
+    return wheels[wheel].closed;
+
+} //endfnctn roveSpeedControlIsClosed
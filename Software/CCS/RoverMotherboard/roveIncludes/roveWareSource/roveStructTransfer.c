@@ -8,63 +8,229 @@
 
 #include "../roveWareHeaders/roveStructTransfer.h"
 
-// rove struct transfer to fill a buffer with a rove transfer frame
-int buildSerialStructMessage(void* my_struct, char* buffer) {
+#include <ti/sysbios/hal/Hwi.h>
+
+#include "driverlib/crc.h"
+#include "driverlib/sysctl.h"
+
+static void buildSerialHeader(char* frame, uint8_t version, uint8_t size) {
 
-    uint8_t size;
     uint8_t start_byte1 = 0x06;
-    uint8_t start_byte2 = 0x85;
+
+    frame[0] = start_byte1;
+    frame[1] = version;
+    frame[2] = size;
+
+} //end fnctn buildSerialHeader
+
+// Post: the checksum or CRC for version written right after the struct, returns its bytes
+
+static int putSerialTrailer(char* my_struct, uint8_t version, uint8_t size) {
+
+    uint16_t crc;
+
+    if (version == SERIAL_FRAME_CRC16) {
+
+        crc = calcCrc16(my_struct, size);
+        my_struct[size] = crc >> 8;
+        my_struct[size + 1] = crc & 0xFF;
+        return 2;
+
+    } //endif
+
+    my_struct[size] = calcCheckSum(my_struct, size);
+    return 1;
+
+} //end fnctn putSerialTrailer
+
+static int buildSerialStruct(void* my_struct, char* buffer, uint8_t version) {
+
+    int size;
     uint8_t checkSum;
+    int i;
+    char byte;
 
     int totalSize = -1;
 
+    PROFILE_BEGIN(PROFILE_BUILD_SERIAL);
+
     size = getStructSize(((struct rovecom_id_cast*) my_struct)->struct_id);
 
     if (size <= 0) {
 
-        printf(
-                "Error in function: buildSerialStructMessage() - struct size is not valid");
+        roveLog(LOG_STRUCT_BAD_SIZE, ((struct rovecom_id_cast*) my_struct)->struct_id, 0, 0);
         return -1;
 
     } //endif
 
-    // checkSum = size;
+    buildSerialHeader(buffer, version, size);
 
-    buffer[0] = start_byte1;
-    buffer[1] = start_byte2;
-    buffer[2] = size;
+    if (version == SERIAL_FRAME_CRC16) {
 
-    // copy the struct into the buffer starting at byte 3
-    memcpy(buffer + 3, my_struct, size);
+        memcpy(buffer + MSG_FRAME_HEADER, my_struct, size);
+        totalSize = MSG_FRAME_HEADER + size
+                + putSerialTrailer(buffer + MSG_FRAME_HEADER, version, size);
 
-    checkSum = calcCheckSum(my_struct, size);
+    } else {
 
-    // 3 for two start bytes and size byte plus size of struct to get final position
-    buffer[3 + size] = checkSum;
+        // copy the struct in after the header and checksum it in the same pass
+        checkSum = size;
 
-    totalSize = 3 + size + 1;
+        for (i = 0; i < size; i++) {
+
+            byte = ((char*) my_struct)[i];
+            buffer[MSG_FRAME_HEADER + i] = byte;
+            checkSum ^= byte;
+
+        } //endfor
+
+        buffer[MSG_FRAME_HEADER + size] = checkSum;
+
+        totalSize = MSG_FRAME_HEADER + size + 1;
+
+    } //endif
+
+    PROFILE_END(PROFILE_BUILD_SERIAL);
 
     return totalSize;
 
+} //end fnctn buildSerialStruct
+
+// rove struct transfer to fill a buffer with a rove transfer frame
+int buildSerialStructMessage(void* my_struct, char* buffer) {
+
+    return buildSerialStruct(my_struct, buffer, SERIAL_FRAME_VERSION);
+
 } //end fnctn buildSerialStructMessage
 
+int buildSerialStructLegacy(void* my_struct, char* buffer) {
+
+    return buildSerialStruct(my_struct, buffer, SERIAL_FRAME_XOR);
+
+} //end fnctn buildSerialStructLegacy
+
+int buildSerialStructInPlace(char* frame) {
+
+    int size;
+    char* my_struct = frame + MSG_FRAME_HEADER;
+
+    int totalSize = -1;
+
+    PROFILE_BEGIN(PROFILE_BUILD_SERIAL);
+
+    size = getStructSize(((struct rovecom_id_cast*) my_struct)->struct_id);
+
+    if (size <= 0) {
+
+        roveLog(LOG_STRUCT_BAD_SIZE, ((struct rovecom_id_cast*) my_struct)->struct_id, 0, 0);
+        return -1;
+
+    } //endif
+
+    // the struct is already where it goes: write the header in front and the trailer after
+    buildSerialHeader(frame, SERIAL_FRAME_VERSION, size);
+    totalSize = MSG_FRAME_HEADER + size + putSerialTrailer(my_struct, SERIAL_FRAME_VERSION, size);
+
+    PROFILE_END(PROFILE_BUILD_SERIAL);
+
+    return totalSize;
+
+} //end fnctn buildSerialStructInPlace
+
 uint8_t calcCheckSum(const void* my_struct, uint8_t size) {
 
-    uint8_t checkSum = size;
-    uint8_t i;
+    uint8_t checkSum;
+
+    PROFILE_BEGIN(PROFILE_CALC_CHECKSUM);
 
-    for (i = 0; i < size; i++)
-        checkSum ^= *((char*) my_struct + i);
+    checkSum = roveChecksumXor(my_struct, size, size);
+
+    PROFILE_END(PROFILE_CALC_CHECKSUM);
 
     return checkSum;
 
 } //end fnctn
 
+void initSerialCrc(void) {
+
+    if (SERIAL_CRC_HARDWARE) {
+
+        initSerialCrcHardware();
+
+    } //endif
+
+} //end fnctn initSerialCrc
+
+void initSerialCrcHardware(void) {
+
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_CCM0);
+
+    while (!SysCtlPeripheralReady(SYSCTL_PERIPH_CCM0)) {
+
+    } //endwhile
+
+} //end fnctn initSerialCrcHardware
+
+uint16_t calcCrc16Hardware(const void* my_struct, uint8_t size) {
+
+    const uint8_t* bytes = (const uint8_t*) my_struct;
+    uint32_t word;
+    uint32_t crc;
+    UInt key;
+    int i;
+
+    // one CRC module for every task: configure and feed it in one go
+    key = Hwi_disable();
+
+    CRCConfigSet(CCM0_BASE, CRC_CFG_INIT_SEED | CRC_CFG_TYPE_P1021 | CRC_CFG_SIZE_8BIT);
+    CRCSeedSet(CCM0_BASE, CHECKSUM_CRC16_SEED);
+
+    // in 8 bit mode the module takes the low byte of each word written, so one word per byte
+    word = size;
+    crc = CRCDataProcess(CCM0_BASE, &word, 1, false);
+
+    for (i = 0; i < size; i++) {
+
+        word = bytes[i];
+        crc = CRCDataProcess(CCM0_BASE, &word, 1, false);
+
+    } //endfor
+
+    Hwi_restore(key);
+
+    return (uint16_t) crc;
+
+} //end fnctn calcCrc16Hardware
+
+uint16_t calcCrc16(const void* my_struct, uint8_t size) {
+
+    uint16_t crc;
+
+    PROFILE_BEGIN(PROFILE_CALC_CRC);
+
+    if (SERIAL_CRC_HARDWARE) {
+
+        crc = calcCrc16Hardware(my_struct, size);
+
+    } else {
+
+        crc = roveChecksumCrc16(&size, 1, CHECKSUM_CRC16_SEED);
+        crc = roveChecksumCrc16(my_struct, size, crc);
+
+    } //endif
+
+    PROFILE_END(PROFILE_CALC_CRC);
+
+    return crc;
+
+} //end fnctn calcCrc16
+
 bool recvSerialStructMessage(int deviceJack, char* buffer) {
 
     uint8_t rx_len = 0;
     uint8_t startByte = 0x06;
     uint8_t secondByte = 0x85;
+    int trailer = 1;
 
     int bytesRead = 0;
     char receiveBuffer[40];
@@ -96,6 +262,11 @@ bool recvSerialStructMessage(int deviceJack, char* buffer) {
 //		System_flush();
 
         if ((bytesRead = deviceRead(deviceJack, receiveBuffer, 1, 500)) == 1) {
+            // either frame version is accepted, whatever SERIAL_FRAME_VERSION sends
+            if (receiveBuffer[0] == SERIAL_FRAME_CRC16) {
+                secondByte = SERIAL_FRAME_CRC16;
+                trailer = 2;
+            } //endif
             if (receiveBuffer[0] != secondByte) {
                 return false;
             } else {
@@ -121,16 +292,25 @@ bool recvSerialStructMessage(int deviceJack, char* buffer) {
     } //end if (rx_len == 0)
 
     if (rx_len > 0) {
-        bytesRead = deviceRead(deviceJack, receiveBuffer, rx_len + 1, 2000);
-        //rx_len + 1 for the checksum byte at the end
-        if (bytesRead != (rx_len + 1))
+        bytesRead = deviceRead(deviceJack, receiveBuffer, rx_len + trailer, 2000);
+        //rx_len + 1 for the checksum byte at the end, + 2 for a CRC
+        if (bytesRead != (rx_len + trailer))
             return false;
 
-        uint8_t calcCS = calcCheckSum(receiveBuffer, rx_len);
+        if (trailer == 2) {
+            uint16_t calcCRC = calcCrc16(receiveBuffer, rx_len);
 
-        if (calcCS != receiveBuffer[rx_len]) {
-            // Checksum error
-            return false;
+            if ((((uint8_t) receiveBuffer[rx_len] << 8) | (uint8_t) receiveBuffer[rx_len + 1]) != calcCRC) {
+                // CRC error
+                return false;
+            } //end if
+        } else {
+            uint8_t calcCS = calcCheckSum(receiveBuffer, rx_len);
+
+            if (calcCS != receiveBuffer[rx_len]) {
+                // Checksum error
+                return false;
+            } //end if
         } //end if
 
         memcpy(buffer, receiveBuffer, rx_len);
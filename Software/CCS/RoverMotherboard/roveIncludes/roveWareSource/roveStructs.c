@@ -8,6 +8,8 @@
 
 #include "../roveWareHeaders/roveStructs.h"
 
+#include <stddef.h>
+
 int getStructSize(char structId) {
 
     switch (structId) {
@@ -18,6 +20,15 @@ int getStructSize(char structId) {
     case motor_right_id:
         return sizeof(struct motor_control_struct);
 
+    case six_wheel_drive_id:
+        return sizeof(struct six_wheel_drive_struct);
+
+    case twist_drive_id:
+        return sizeof(struct twist_drive_struct);
+
+    case drive_calibration_id:
+        return sizeof(struct drive_calibration_command);
+
     case PTZ_Cam_id_0...PTZ_Cam_id_10:
     		return sizeof(struct PTZ_Cam_Ctrl);
 
@@ -43,9 +54,70 @@ int getStructSize(char structId) {
     case gps_telem_reply:
             return sizeof(struct gps_telem);
 
+    case telem_policy_telem_id:
+            return sizeof(struct telem_policy_telem);
+
+    case link_stats_telem_id:
+            return sizeof(struct link_stats_telem);
+
+    case clock_sync_telem_id:
+            return sizeof(struct clock_sync_telem);
+
+    case command_expiry_telem_id:
+            return sizeof(struct command_expiry_telem);
+
+    case wheel_feedback_telem_id:
+            return sizeof(struct wheel_feedback_telem);
+
+    case discovery_telem_id:
+            return sizeof(struct discovery_telem);
+
+    case system_health_telem_id:
+            return sizeof(struct system_health_telem);
+
+    case task_health_telem_id:
+            return sizeof(struct task_health_telem);
+
+    case fragment_telem_id:
+            return sizeof(struct fragment_telem);
+
+    case fragment_id:
+            return sizeof(struct fragment_struct);
+
+    case mobo_identify_req_id:
+            return sizeof(struct mobo_identify_req);
+
+    case dev_identify_reply_id:
+            return sizeof(struct dev_identify_reply);
+
     } //endswitch:		(structId)
 
     return -1;
 
 } //endfnctn getStructSize(char structId)
 
+
+// every field of gps_telem after struct_id, in struct order. The base station decodes with the
+// same table, see Software/Tests/TelemetryCodec/telem_codec.py
+
+static const struct telem_field gps_telem_fields[] = {
+
+    { offsetof(struct gps_telem, fix), 1 },
+    { offsetof(struct gps_telem, fix_quality), 1 },
+    { offsetof(struct gps_telem, satellites), 1 },
+    { offsetof(struct gps_telem, latitude_fixed), 4 },
+    { offsetof(struct gps_telem, longitude_fixed), 4 },
+    { offsetof(struct gps_telem, altitude), 4 },
+    { offsetof(struct gps_telem, speed), 4 },
+    { offsetof(struct gps_telem, angle), 4 },
+
+};
+
+void initTelemCodecStreams(void) {
+
+    roveTelemCodecInit(ROVER_TELEM_DELTA, TELEM_KEYFRAME_INTERVAL);
+
+    roveTelemCodecAddStream(gps_telem_reply, sizeof(struct gps_telem), gps_telem_fields,
+            sizeof(gps_telem_fields) / sizeof(gps_telem_fields[0]), TELEM_DELTA_ENCODE_GPS);
+
+} //endfnctn initTelemCodecStreams
@@ -0,0 +1,248 @@
+// roveTelemCodec.c MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#include "../roveWareHeaders/roveTelemCodec.h"
+
+#include <stddef.h>
+#include <string.h>
+
+// per struct_id encoder state
+
+typedef struct telem_stream {
+
+    uint8_t struct_id;
+    uint8_t size;
+    bool enabled;
+    const struct telem_field* fields;
+    uint8_t field_count;
+
+    // history for the delta, only valid once a keyframe has gone out
+    bool has_history;
+    uint8_t seq;
+    uint8_t frames_since_keyframe;
+    char last_sample[TELEM_DELTA_MAX_SAMPLE];
+
+} telem_stream;
+
+static telem_stream telem_streams[TELEM_DELTA_MAX_STREAMS];
+static int telem_stream_count = 0;
+
+static uint8_t telem_message_type;
+static uint8_t telem_keyframe_interval;
+
+static telem_stream* findStream(uint8_t struct_id) {
+
+    int i;
+
+    for (i = 0; i < telem_stream_count; i++) {
+
+        if (telem_streams[i].struct_id == struct_id) {
+
+            return &telem_streams[i];
+
+        } //endif
+
+    } //endfor
+
+    return NULL;
+
+} //endfnctn findStream
+
+// fields are little endian on both the TM4C and the base station
+
+static uint32_t readField(const char* sample, const struct telem_field* field) {
+
+    const uint8_t* bytes = (const uint8_t*) sample + field->offset;
+    uint32_t value = 0;
+    int i;
+
+    for (i = field->width - 1; i >= 0; i--) {
+
+        value = (value << 8) | bytes[i];
+
+    } //endfor
+
+    return value;
+
+} //endfnctn readField
+
+void roveTelemCodecInit(uint8_t message_type, uint8_t keyframe_interval) {
+
+    memset(telem_streams, 0, sizeof(telem_streams));
+    telem_stream_count = 0;
+
+    telem_message_type = message_type;
+    telem_keyframe_interval = keyframe_interval;
+
+} //endfnctn roveTelemCodecInit
+
+bool roveTelemCodecAddStream(uint8_t struct_id, uint8_t size, const struct telem_field* fields,
+        uint8_t field_count, bool enabled) {
+
+    telem_stream* stream;
+
+    if ((telem_stream_count >= TELEM_DELTA_MAX_STREAMS) || (size > TELEM_DELTA_MAX_SAMPLE)
+            || (findStream(struct_id) != NULL)) {
+
+        return false;
+
+    } //endif
+
+    stream = &telem_streams[telem_stream_count++];
+
+    stream->struct_id = struct_id;
+    stream->size = size;
+    stream->enabled = enabled;
+    stream->fields = fields;
+    stream->field_count = field_count;
+    stream->has_history = false;
+
+    return true;
+
+} //endfnctn roveTelemCodecAddStream
+
+bool roveTelemCodecIsEnabled(uint8_t struct_id) {
+
+    telem_stream* stream = findStream(struct_id);
+
+    return (stream != NULL) && stream->enabled;
+
+} //endfnctn roveTelemCodecIsEnabled
+
+bool roveTelemCodecEnable(uint8_t struct_id, bool enable) {
+
+    telem_stream* stream = findStream(struct_id);
+
+    if (stream == NULL) {
+
+        return false;
+
+    } //endif
+
+    // start the stream over with a keyframe either way
+    stream->has_history = false;
+    stream->enabled = enable;
+
+    return true;
+
+} //endfnctn roveTelemCodecEnable
+
+void roveTelemCodecResync(void) {
+
+    int i;
+
+    for (i = 0; i < telem_stream_count; i++) {
+
+        telem_streams[i].has_history = false;
+
+    } //endfor
+
+} //endfnctn roveTelemCodecResync
+
+int roveTelemEncode(const void* telem_struct, char* frame) {
+
+    uint8_t struct_id = *(const uint8_t*) telem_struct;
+    telem_stream* stream = findStream(struct_id);
+    const char* sample = (const char*) telem_struct;
+    uint8_t* payload = (uint8_t*) frame + TELEM_DELTA_HEADER_SIZE;
+    int payload_len = 0;
+    int size;
+    int i;
+
+    if ((stream == NULL) || !stream->enabled) {
+
+        return -1;
+
+    } //endif
+
+    size = stream->size;
+
+    frame[0] = telem_message_type;
+    frame[1] = struct_id;
+    frame[2] = stream->seq++;
+
+    if (!stream->has_history
+            || (stream->frames_since_keyframe >= telem_keyframe_interval)) {
+
+        // keyframe: raw struct, identical to what ROVER_TELEM carries
+        frame[3] = TELEM_DELTA_KEYFRAME;
+        memcpy(payload, sample, size);
+        payload_len = size;
+
+        stream->frames_since_keyframe = 0;
+        stream->has_history = true;
+
+    } else {
+
+        frame[3] = 0;
+
+        for (i = 0; i < stream->field_count; i++) {
+
+            // unsigned subtract wraps the same way on both ends, the decoder truncates to field width
+            uint32_t delta = readField(sample, &stream->fields[i])
+                    - readField(stream->last_sample, &stream->fields[i]);
+
+            payload_len += roveVarintWrite((int32_t) delta, payload + payload_len);
+
+        } //endfor
+
+        stream->frames_since_keyframe++;
+
+    } //endif
+
+    frame[4] = payload_len;
+
+    memcpy(stream->last_sample, sample, size);
+
+    return TELEM_DELTA_HEADER_SIZE + payload_len;
+
+} //endfnctn roveTelemEncode
+
+int roveVarintWrite(int32_t value, uint8_t* buffer) {
+
+    // zigzag: 0, -1, 1, -2 ... become 0, 1, 2, 3 ...
+    uint32_t folded = ((uint32_t) value << 1) ^ (uint32_t) (value >> 31);
+    int count = 0;
+
+    while (folded >= 0x80) {
+
+        buffer[count++] = (uint8_t) (folded | 0x80);
+        folded >>= 7;
+
+    } //endwhile
+
+    buffer[count++] = (uint8_t) folded;
+
+    return count;
+
+} //endfnctn roveVarintWrite
+
+int roveVarintRead(const uint8_t* buffer, int bytes_available, int32_t* value) {
+
+    uint32_t folded = 0;
+    int shift = 0;
+    int count = 0;
+
+    while (count < bytes_available && count < 5) {
+
+        folded |= (uint32_t) (buffer[count] & 0x7F) << shift;
+        shift += 7;
+
+        if (!(buffer[count++] & 0x80)) {
+
+            *value = (int32_t) ((folded >> 1) ^ (~(folded & 1) + 1));
+            return count;
+
+        } //endif
+
+    } //endwhile
+
+    // truncated or over long varint
+    return -1;
+
+} //endfnctn roveVarintRead
@@ -0,0 +1,313 @@
+// roveTelemPolicy.c MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#include "../roveWareHeaders/roveTelemPolicy.h"
+
+typedef struct telem_policy {
+
+    uint8_t telem_id;
+    uint8_t mode;
+    uint8_t decimation;
+    uint16_t max_rate_dhz;
+
+    // derived from max_rate_dhz, 0 is unlimited
+    uint32_t min_interval_ticks;
+
+    uint8_t decimation_count;
+    bool has_sent;
+    uint32_t last_sent_tick;
+
+    bool holding;
+    uint8_t held_size;
+    char held[MAX_TELEM_SIZE];
+
+    uint32_t received;
+    uint32_t forwarded;
+    uint32_t dropped;
+    uint32_t merged;
+
+} telem_policy;
+
+// filled in order of first appearance, telem_policy_count entries are in use
+
+static telem_policy telem_policies[TELEM_POLICY_MAX_IDS];
+static int telem_policy_count = 0;
+
+static void setRate(telem_policy* policy, uint16_t max_rate_dhz) {
+
+    policy->max_rate_dhz = max_rate_dhz;
+
+    // rate is in tenths of a hertz, Clock ticks are milliseconds
+    if (max_rate_dhz == 0) {
+
+        policy->min_interval_ticks = 0;
+
+    } else {
+
+        policy->min_interval_ticks = 10000 / max_rate_dhz;
+
+    } //endif
+
+} //endfnctn setRate
+
+// Pre: caller holds Task_disable()
+
+static telem_policy* findPolicy(uint8_t telem_id, bool create) {
+
+    int i;
+    telem_policy* policy;
+
+    for (i = 0; i < telem_policy_count; i++) {
+
+        if (telem_policies[i].telem_id == telem_id) {
+
+            return &telem_policies[i];
+
+        } //endif
+
+    } //endfor
+
+    if (!create || (telem_policy_count >= TELEM_POLICY_MAX_IDS)) {
+
+        return NULL;
+
+    } //endif
+
+    policy = &telem_policies[telem_policy_count++];
+    memset(policy, 0, sizeof(*policy));
+
+    policy->telem_id = telem_id;
+    policy->mode = TELEM_POLICY_DEFAULT_MODE;
+    policy->decimation = 1;
+    setRate(policy, TELEM_POLICY_DEFAULT_RATE_DHZ);
+
+    return policy;
+
+} //endfnctn findPolicy
+
+static bool rateAllows(telem_policy* policy, uint32_t now) {
+
+    return !policy->has_sent || (policy->min_interval_ticks == 0)
+            || ((now - policy->last_sent_tick) >= policy->min_interval_ticks);
+
+} //endfnctn rateAllows
+
+int roveTelemPolicyFilter(const char* telem) {
+
+    uint8_t telem_id = ((struct rovecom_id_cast*) telem)->struct_id;
+    int size = getStructSize(telem_id);
+    uint32_t now = Clock_getTicks();
+    int result = TELEM_POLICY_FORWARD;
+    telem_policy* policy;
+    UInt key;
+
+    // no struct size, or one too big to hold: nothing could send it, and it takes no table slot
+    if ((size <= 0) || (size > MAX_TELEM_SIZE)) {
+
+        return TELEM_POLICY_DROP;
+
+    } //endif
+
+    key = Task_disable();
+
+    policy = findPolicy(telem_id, true);
+
+    if (policy == NULL) {
+
+        // table full: unmanaged ids pass straight through
+        Task_restore(key);
+        return TELEM_POLICY_FORWARD;
+
+    } //endif
+
+    policy->received++;
+
+    if (++policy->decimation_count < policy->decimation) {
+
+        policy->dropped++;
+        result = TELEM_POLICY_DROP;
+
+    } else {
+
+        policy->decimation_count = 0;
+
+        if (rateAllows(policy, now)) {
+
+            // a fresh sample always beats whatever was being held
+            if (policy->holding) {
+
+                policy->holding = false;
+                policy->merged++;
+
+            } //endif
+
+            policy->has_sent = true;
+            policy->last_sent_tick = now;
+            policy->forwarded++;
+
+        } else if (policy->mode == TELEM_POLICY_KEEP_LATEST) {
+
+            if (policy->holding) {
+
+                policy->merged++;
+
+            } //endif
+
+            memcpy(policy->held, telem, size);
+            policy->held_size = size;
+            policy->holding = true;
+            result = TELEM_POLICY_HOLD;
+
+        } else {
+
+            policy->dropped++;
+            result = TELEM_POLICY_DROP;
+
+        } //endif
+
+    } //endif
+
+    Task_restore(key);
+
+    return result;
+
+} //endfnctn roveTelemPolicyFilter
+
+bool roveTelemPolicyTakeDue(char* buffer) {
+
+    uint32_t now = Clock_getTicks();
+    telem_policy* policy;
+    UInt key;
+    int i;
+
+    key = Task_disable();
+
+    for (i = 0; i < telem_policy_count; i++) {
+
+        policy = &telem_policies[i];
+
+        if (policy->holding && rateAllows(policy, now)) {
+
+            memcpy(buffer, policy->held, policy->held_size);
+
+            policy->holding = false;
+            policy->has_sent = true;
+            policy->last_sent_tick = now;
+            policy->forwarded++;
+
+            Task_restore(key);
+            return true;
+
+        } //endif
+
+    } //endfor
+
+    Task_restore(key);
+
+    return false;
+
+} //endfnctn roveTelemPolicyTakeDue
+
+void roveTelemPolicyFlush(void) {
+
+    char telem[MAX_TELEM_SIZE];
+
+    while (roveTelemPolicyTakeDue(telem)) {
+
+        roveTelemQueuePost(telem);
+
+    } //endwhile
+
+} //endfnctn roveTelemPolicyFlush
+
+bool roveTelemPolicyModeValid(uint8_t mode) {
+
+    return (mode == TELEM_POLICY_DROP_EXCESS) || (mode == TELEM_POLICY_KEEP_LATEST)
+            || (mode == TELEM_POLICY_QUERY);
+
+} //endfnctn roveTelemPolicyModeValid
+
+bool roveTelemPolicyApply(const struct telem_policy_command* command) {
+
+    telem_policy* policy;
+    UInt key;
+
+    if (!roveTelemPolicyModeValid(command->mode)) {
+
+        return false;
+
+    } //endif
+
+    if (command->mode == TELEM_POLICY_QUERY) {
+
+        return true;
+
+    } //endif
+
+    key = Task_disable();
+
+    policy = findPolicy(command->telem_id, true);
+
+    if (policy == NULL) {
+
+        Task_restore(key);
+        return false;
+
+    } //endif
+
+    policy->mode = command->mode;
+    policy->decimation = (command->decimation == 0) ? 1 : command->decimation;
+    policy->decimation_count = 0;
+    setRate(policy, command->max_rate_dhz);
+
+    // nothing ever flushes the hold slot in drop excess mode
+    if (policy->mode != TELEM_POLICY_KEEP_LATEST) {
+
+        policy->holding = false;
+
+    } //endif
+
+    Task_restore(key);
+
+    roveTelemCodecEnable(command->telem_id, command->delta_encode);
+
+    return true;
+
+} //endfnctn roveTelemPolicyApply
+
+bool roveTelemPolicyReport(uint8_t telem_id, struct telem_policy_telem* report) {
+
+    telem_policy* policy;
+    UInt key;
+
+    key = Task_disable();
+
+    policy = findPolicy(telem_id, false);
+
+    if (policy == NULL) {
+
+        Task_restore(key);
+        return false;
+
+    } //endif
+
+    report->struct_id = telem_policy_telem_id;
+    report->telem_id = telem_id;
+    report->mode = policy->mode;
+    report->decimation = policy->decimation;
+    report->max_rate_dhz = policy->max_rate_dhz;
+    report->received = policy->received;
+    report->forwarded = policy->forwarded;
+    report->dropped = policy->dropped;
+    report->merged = policy->merged;
+
+    Task_restore(key);
+
+    return true;
+
+} //endfnctn roveTelemPolicyReport
@@ -0,0 +1,158 @@
+// roveTelemQueue.c MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#include "../roveWareHeaders/roveTelemQueue.h"
+
+#include <ti/sysbios/hal/Hwi.h>
+#include <ti/sysbios/knl/Semaphore.h>
+
+// head is the next slot to write, the oldest sample sits count slots behind it
+
+static char telem_slots[TELEM_QUEUE_DEPTH][MAX_TELEM_SIZE];
+static uint32_t telem_captured_us[TELEM_QUEUE_DEPTH];
+static int telem_head = 0;
+static int telem_count = 0;
+
+// set by a reconnect while samples are waiting, cleared once the backlog has drained
+
+static bool telem_newest_first = false;
+
+static int telem_high_water = 0;
+static uint32_t telem_overflows = 0;
+
+void roveTelemQueuePost(const char* telem) {
+
+    int size = getStructSize(((struct rovecom_id_cast*) telem)->struct_id);
+    uint32_t now = roveGetMicros();
+    UInt key;
+
+    // unknown id, or a struct that would run past its slot
+    if ((size <= 0) || (size > MAX_TELEM_SIZE)) {
+
+        return;
+
+    } //endif
+
+    key = Hwi_disable();
+
+    memcpy(telem_slots[telem_head], telem, size);
+    telem_captured_us[telem_head] = now;
+    telem_head = (telem_head + 1) % TELEM_QUEUE_DEPTH;
+
+    if (telem_count == TELEM_QUEUE_DEPTH) {
+
+        // ring full: the slot just written held the oldest sample, the next oldest is now first out
+        telem_overflows++;
+
+    } else {
+
+        telem_count++;
+
+        if (telem_count > telem_high_water) {
+
+            telem_high_water = telem_count;
+
+        } //endif
+
+    } //endif
+
+    Hwi_restore(key);
+
+    // binary semaphore: one post covers any number of queued samples
+    Semaphore_post(toBaseStationSemaphore);
+
+} //endfnctn roveTelemQueuePost
+
+static bool takeNext(char* telem, uint32_t* captured_us) {
+
+    int next;
+    UInt key;
+
+    key = Hwi_disable();
+
+    if (telem_count == 0) {
+
+        telem_newest_first = false;
+
+        Hwi_restore(key);
+        return false;
+
+    } //endif
+
+    if (telem_newest_first) {
+
+        // backlog from before a reconnect: newest first, taken back off the head
+        telem_head = (telem_head + TELEM_QUEUE_DEPTH - 1) % TELEM_QUEUE_DEPTH;
+        next = telem_head;
+
+    } else {
+
+        next = (telem_head + TELEM_QUEUE_DEPTH - telem_count) % TELEM_QUEUE_DEPTH;
+
+    } //endif
+
+    memcpy(telem, telem_slots[next], MAX_TELEM_SIZE);
+    *captured_us = telem_captured_us[next];
+
+    telem_count--;
+
+    if (telem_count == 0) {
+
+        telem_newest_first = false;
+
+    } //endif
+
+    Hwi_restore(key);
+
+    return true;
+
+} //endfnctn takeNext
+
+bool roveTelemQueuePend(char* telem, uint32_t* captured_us, UInt timeout) {
+
+    while (!takeNext(telem, captured_us)) {
+
+        if (!Semaphore_pend(toBaseStationSemaphore, timeout)) {
+
+            return false;
+
+        } //endif
+
+    } //endwhile
+
+    return true;
+
+} //endfnctn roveTelemQueuePend
+
+void roveTelemQueueReconnect(void) {
+
+    UInt key = Hwi_disable();
+
+    telem_newest_first = (telem_count > 0);
+
+    Hwi_restore(key);
+
+} //endfnctn roveTelemQueueReconnect
+
+int roveTelemQueueCount(void) {
+
+    return telem_count;
+
+} //endfnctn roveTelemQueueCount
+
+int roveTelemQueueHighWater(void) {
+
+    return telem_high_water;
+
+} //endfnctn roveTelemQueueHighWater
+
+uint32_t roveTelemQueueOverflows(void) {
+
+    return telem_overflows;
+
+} //endfnctn roveTelemQueueOverflows
@@ -8,6 +8,9 @@
 
 #include "../roveWareHeaders/roveTiming.h"
 
+#include <xdc/runtime/Timestamp.h>
+#include <xdc/runtime/Types.h>
+
 //encapsulates the system control call to delay a given number of milliseconds
 
 void ms_delay(int milliseconds) {
@@ -15,3 +18,25 @@ void ms_delay(int milliseconds) {
     SysCtlDelay(milliseconds * (SysCtlClockGet() / 100));
 
 } //endfnctn ms_delay( int milliseconds )
+
+uint32_t roveGetMicros(void) {
+
+    static uint32_t ticks_per_us = 0;
+    Types_Timestamp64 now;
+    Types_FreqHz freq;
+    uint64_t ticks;
+
+    // the timestamp frequency is fixed once BIOS is up, only ask for it once
+    if (ticks_per_us == 0) {
+
+        Timestamp_getFreq(&freq);
+        ticks_per_us = freq.lo / 1000000;
+
+    } //endif
+
+    Timestamp_get64(&now);
+    ticks = ((uint64_t) now.hi << 32) | now.lo;
+
+    return (uint32_t) (ticks / ticks_per_us);
+
+} //endfnctn roveGetMicros
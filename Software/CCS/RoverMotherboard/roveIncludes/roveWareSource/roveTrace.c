@@ -0,0 +1,140 @@
+// roveTrace.c MST MRDT 2015
+//
+// Owen Chiaventone omc8db@mst.edu
+//
+// Connor Walsh cwd8d@mst.edu
+//
+// Judah Schad jrs6w7@mst.edu
+
+#include "../roveWareHeaders/roveTrace.h"
+
+#include <xdc/runtime/Timestamp.h>
+#include <xdc/runtime/Types.h>
+
+#define TRACE_RING_MASK (TRACE_RING_SIZE - 1)
+
+// a writer fills the slot before it moves the head, a reader never trusts a slot the head
+// has come back around to
+
+static volatile uint32_t rings[TRACE_STAGES][TRACE_RING_SIZE];
+static volatile uint32_t heads[TRACE_STAGES];
+
+static volatile bool requested = false;
+
+uint32_t roveTraceStart(void) {
+
+    return Timestamp_get32();
+
+} //endfnctn roveTraceStart
+
+void roveTraceStage(int stage, uint32_t start) {
+
+    uint32_t head = heads[stage];
+
+    rings[stage][head & TRACE_RING_MASK] = Timestamp_get32() - start;
+    heads[stage] = head + 1;
+
+} //endfnctn roveTraceStage
+
+static int bucket(uint32_t us) {
+
+    int b = 0;
+
+    while ((us > 1) && (b < TRACE_BUCKETS - 1)) {
+
+        us >>= 1;
+        b++;
+
+    } //endwhile
+
+    return b;
+
+} //endfnctn bucket
+
+void roveTraceReport(struct trace_report* report) {
+
+    static uint32_t ticks_per_us = 0;
+    static uint32_t copy[TRACE_RING_SIZE];
+    Types_FreqHz freq;
+    struct trace_stage_report* summary;
+    uint32_t first;
+    uint32_t last;
+    uint32_t oldest;
+    uint32_t i;
+    uint32_t us;
+    int stage;
+
+    if (ticks_per_us == 0) {
+
+        Timestamp_getFreq(&freq);
+        ticks_per_us = freq.lo / 1000000;
+
+    } //endif
+
+    memset(report, 0, sizeof(*report));
+    report->stages = TRACE_STAGES;
+    report->buckets = TRACE_BUCKETS;
+
+    for (stage = 0; stage < TRACE_STAGES; stage++) {
+
+        summary = &report->stage[stage];
+
+        last = heads[stage];
+        first = (last > TRACE_RING_SIZE) ? last - TRACE_RING_SIZE : 0;
+
+        for (i = first; i < last; i++) {
+
+            copy[i & TRACE_RING_MASK] = rings[stage][i & TRACE_RING_MASK];
+
+        } //endfor
+
+        // anything the writer lapped while we copied is gone, the slot at the head included
+        oldest = heads[stage];
+        oldest = (oldest >= TRACE_RING_SIZE) ? oldest - TRACE_RING_SIZE + 1 : 0;
+
+        if (oldest > first) {
+
+            first = (oldest < last) ? oldest : last;
+
+        } //endif
+
+        summary->samples = last;
+        summary->window = last - first;
+
+        for (i = first; i < last; i++) {
+
+            us = copy[i & TRACE_RING_MASK] / ticks_per_us;
+
+            if (us > summary->max_us) {
+
+                summary->max_us = us;
+
+            } //endif
+
+            summary->histogram[bucket(us)]++;
+
+        } //endfor
+
+    } //endfor
+
+} //endfnctn roveTraceReport
+
+void roveTraceRequest(void) {
+
+    requested = true;
+
+} //endfnctn roveTraceRequest
+
+bool roveTraceTakeRequest(void) {
+
+    if (!requested) {
+
+        return false;
+
+    } //endif
+
+    requested = false;
+
+    return true;
+
+} //endfnctn roveTraceTakeRequest
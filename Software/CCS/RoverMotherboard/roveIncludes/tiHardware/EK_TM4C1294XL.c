@@ -411,18 +411,24 @@ void EK_TM4C1294XL_initI2C(void)
 
 PWMTiva_Object pwmTivaObjects[EK_TM4C1294XL_PWMCOUNT];
 
+#define DRIVE_PWM_GEN_MODE (PWM_GEN_MODE_DOWN | PWM_GEN_MODE_DBG_RUN \
+        | PWM_GEN_MODE_SYNC | PWM_GEN_MODE_GEN_SYNC_GLOBAL)
+
 /* PWM configuration structure */
 const PWMTiva_HWAttrs pwmTivaHWAttrs[EK_TM4C1294XL_PWMCOUNT] = {
     {PWM0_BASE, PWM_OUT_0, PWM_GEN_MODE_DOWN | PWM_GEN_MODE_DBG_RUN}
 
     //Judah Thinks add the below 1-6:
 
-    ,{PWM0_BASE, PWM_OUT_1, PWM_GEN_MODE_DOWN | PWM_GEN_MODE_DBG_RUN}
-    ,{PWM0_BASE, PWM_OUT_2, PWM_GEN_MODE_DOWN | PWM_GEN_MODE_DBG_RUN}
-    ,{PWM0_BASE, PWM_OUT_3, PWM_GEN_MODE_DOWN | PWM_GEN_MODE_DBG_RUN}
-    ,{PWM0_BASE, PWM_OUT_4, PWM_GEN_MODE_DOWN | PWM_GEN_MODE_DBG_RUN}
-    ,{PWM0_BASE, PWM_OUT_5, PWM_GEN_MODE_DOWN | PWM_GEN_MODE_DBG_RUN}
-    ,{PWM0_BASE, PWM_OUT_6, PWM_GEN_MODE_DOWN | PWM_GEN_MODE_DBG_RUN}
+    //drive motors: compare and load writes are held until PWMSyncUpdate() so all six
+    //outputs change on the same period boundary (see DriveMotorCommit)
+
+    ,{PWM0_BASE, PWM_OUT_1, DRIVE_PWM_GEN_MODE}
+    ,{PWM0_BASE, PWM_OUT_2, DRIVE_PWM_GEN_MODE}
+    ,{PWM0_BASE, PWM_OUT_3, DRIVE_PWM_GEN_MODE}
+    ,{PWM0_BASE, PWM_OUT_4, DRIVE_PWM_GEN_MODE}
+    ,{PWM0_BASE, PWM_OUT_5, DRIVE_PWM_GEN_MODE}
+    ,{PWM0_BASE, PWM_OUT_6, DRIVE_PWM_GEN_MODE}
 
 };
 
@@ -39,13 +39,11 @@ Void roveTcpHandler(UArg arg0, UArg arg1) {
 
     //the task loops for ever and only exits from BIOS_start, on error state
 
-    printf("roveTCPHandler 		init! \n");
-    printf("\n");
-    printf("\n");
+    roveLogEvent(LOG_TCP_INIT);
 
     while (FOREVER) {
 
-        printf("Attempting to connect\n");
+        roveLogEvent(LOG_TCP_CONNECTING);
 
         attemptToConnect(&RED_socket);
 
@@ -54,13 +52,15 @@ Void roveTcpHandler(UArg arg0, UArg arg1) {
 
             //Spawn sending thread
 
-            printf("Spawning roveTcpSender\n");
+            roveLogEvent(LOG_TCP_SPAWN_SENDER);
 
 			Error_init(&eb);
 			Task_Params_init(&taskParams);
 			taskParams.arg0 = (UArg) (RED_socket.socketFileDescriptor);
+			//Sender frames and reports are static, the stack only holds its counters and call frames
 			taskParams.stackSize = 1280;
 			taskParams.priority = -1;
+			taskParams.instance->name = "roveTcpSender";
 			taskHandle = Task_create((Task_FuncPtr) roveTcpSender, &taskParams,
 					&eb);
 			//Check to see if memory could not be allocated for the task
@@ -72,14 +72,13 @@ Void roveTcpHandler(UArg arg0, UArg arg1) {
 
             //Check to see if memory could not be allocated for the task
             if (taskHandle == NULL) {
-                printf(
-                        "Error: Failed to create new roveTcpSender Task\n");
+                roveLogEvent(LOG_TCP_SENDER_FAILED);
 
             }//end if taskHandle
 
         }//end if isConnected
 
-        printf("Finished attempt. Result: ");
+        roveLog(LOG_TCP_CONNECT_RESULT, RED_socket.isConnected, 0, 0);
 
         // loop to recieve cmds and send telem from and to the base station: if socket breaks, loop breaks and we attempt to reconnect
 
@@ -98,12 +97,21 @@ Void roveTcpHandler(UArg arg0, UArg arg1) {
                     break;
 
                 case SYNCHRONIZE_STATUS:
+
+                    parseSynchronizeMessage(&RED_socket);
+
                     break;
 
                 case COMMAND_METADATA:
+
+                    parseCommandMetadataMessage(&RED_socket);
+
                     break;
 
                 case TELEM_METADATA:
+
+                    parseTelemMetadataMessage(&RED_socket);
+
                     break;
 
                 case ERROR_METADATA:
@@ -115,7 +123,13 @@ Void roveTcpHandler(UArg arg0, UArg arg1) {
                     //printf("Got rover command. Passing control.\n");
                     //System_flush;
 
-                    parseRoverCommandMessage(&RED_socket);
+                    parseRoverCommandMessage(&RED_socket, false);
+
+                    break;
+
+                case ROVER_COMMAND_STAMPED:
+
+                    parseRoverCommandMessage(&RED_socket, true);
 
                     break;
 
@@ -125,18 +139,34 @@ Void roveTcpHandler(UArg arg0, UArg arg1) {
                 case ROVER_ERROR:
                     break;
 
+                case ROVER_HEARTBEAT:
+
+                    parseHeartbeatMessage(&RED_socket);
+
+                    break;
+
+                case ROVER_DIAGNOSTIC:
+
+                    parseDiagnosticMessage(&RED_socket);
+
+                    break;
+
+                case ROVER_LONG_MESSAGE:
+
+                    parseLongMessage(&RED_socket);
+
+                    break;
+
                     // defined {
                 case JSON_START_BYTE:
 
-                    printf(
-                            "Got JSON start byte. Error, unable to Parse\n");
+                    roveLogEvent(LOG_TCP_JSON);
 
                     break;
 
                 default:
 
-                    printf("Command identifier not recognized: %c\n",
-                            messageType);
+                    roveLog(LOG_TCP_UNKNOWN_TYPE, messageType, 0, 0);
 
                     break;
 
@@ -144,14 +174,14 @@ Void roveTcpHandler(UArg arg0, UArg arg1) {
 
             } else {
 
-                printf("Connection has been closed\n");
+                roveLogEvent(LOG_TCP_CLOSED);
 
 
             }			//endif roveRecv
 
         }						//endwhile isConnected
 
-		printf("Connection Lost\n\n");
+		roveLogEvent(LOG_TCP_LOST);
 
 		emergencyStop();
 		// if execution reaches this point, then the connection has broken and we will attempt a new socket
@@ -165,7 +195,7 @@ Void roveTcpHandler(UArg arg0, UArg arg1) {
 
     fdCloseSession((void*) TaskSelf());
 
-    printf("Tcp Handler Task Error: Forced Exit\n");
+    roveLogEvent(LOG_TCP_EXIT);
 
 
     //exit Task
@@ -180,25 +210,102 @@ Void roveTcpSender(UArg arg0, UArg arg1) {
 	RED_socket.socketFileDescriptor = arg0;
 	RED_socket.isConnected = true;
 	char message_type[] = {ROVER_TELEM};
+	char stamped_type[] = {ROVER_TELEM_STAMPED};
+	//Frames and reports are static, like the diagnostics below, so the sender fits its 1280 byte stack
+	static base_station_msg_struct toBaseTelem;
+	static char deltaFrame[TELEM_DELTA_MAX_FRAME];
+	char heartbeat_type[] = {ROVER_HEARTBEAT};
+	char synchronize_type[] = {SYNCHRONIZE_STATUS};
+	char diagnostic_header[] = {ROVER_DIAGNOSTIC, DIAGNOSTIC_TRACE};
+	char log_header[] = {ROVER_DIAGNOSTIC, DIAGNOSTIC_LOG};
+	uint16_t diagnosticSize;
+	static struct trace_report traceReport;
+	static struct log_report logReport;
+	static struct log_entry logEntries[LOG_RING_SIZE];
+	char profile_header[] = {ROVER_DIAGNOSTIC, DIAGNOSTIC_PROFILE};
+	static struct profile_report profileReport;
+	char samples_header[] = {ROVER_DIAGNOSTIC, DIAGNOSTIC_SAMPLES};
+	static struct sampler_report samplerReport;
+	static struct sampler_task samplerTasks[HEALTH_MAX_TASKS];
+	static struct sampler_sample samplerSamples[SAMPLER_BATCH];
+	static struct heartbeat_struct heartbeat;
+	static struct clock_sync_struct syncRequest;
+	static struct link_stats_telem linkStats;
+	static struct clock_sync_telem clockStats;
+	static struct command_expiry_telem commandStats;
+	static struct fragment_telem fragmentStats;
+	char long_message_type[] = {ROVER_LONG_MESSAGE};
+	static char longMessage[FRAGMENT_MAX_MESSAGE];
+	int longSize;
+	uint16_t longLength;
+	static struct discovery_telem discovery;
+	static struct system_health_telem health;
+	static struct task_health_telem taskHealth;
+	int healthTasks;
+	int nextHealthTask = 0;
+	int task;
+	uint32_t capturedMicros;
+	uint32_t baseStamp;
+	uint32_t lastHeartbeatTick = 0;
+	uint32_t lastSyncTick = 0;
+	uint32_t lastLinkStatsTick = 0;
+	uint32_t lastHealthTick = 0;
+	uint32_t now;
+	int deltaFrameSize;
 
 	fdOpenSession(TaskSelf());
 	fdShare(RED_socket.socketFileDescriptor);
-	base_station_msg_struct toBaseTelem;
 	//Setup
 
-	//Loop: Wait on mailbox, send keepalive otherwise
+	//New base station connection: every delta encoded stream restarts with a keyframe
+	roveTelemCodecResync();
+	roveLinkStatsReset();
+	roveClockSyncReset();
+	roveCmdExpiryReset();
+
+	//Telemetry queued while the link was down goes out newest first
+	roveTelemQueueReconnect();
+
+	//What the boot scan found on each jack, once per connection
+	if (DISCOVERY_ENABLED)
+	{
+		roveDiscoveryReport(&discovery);
+		roveTelemQueuePost((char *) &discovery);
+	}
+
+	//Loop: Wait on telemetry queue, send keepalive otherwise
 	while (RED_socket.isConnected) {
-		//Check if there's data in the outgoing mailbox. This will block for a number of system ticks.
-		if (Mailbox_pend(toBaseStationMailbox, &toBaseTelem,SEND_KEEPALIVE_DELAY_TICKS))
+		//Check if there's data in the outgoing queue, oldest first once any backlog is out. This will block for a number of system ticks.
+		if (roveTelemQueuePend((char *) &toBaseTelem, &capturedMicros, SEND_KEEPALIVE_DELAY_TICKS))
 		{
 
-			//Send the message type
-			roveSend(&RED_socket, message_type, 1);
+			if (roveTelemCodecIsEnabled(toBaseTelem.id))
+			{
+				//Message type is already in the frame
+				deltaFrameSize = roveTelemEncode(&toBaseTelem, deltaFrame);
+				roveSend(&RED_socket, deltaFrame, deltaFrameSize);
+
+			} else if (TELEM_TIMESTAMPS && roveClockSyncIsValid())
+			{
+				//Capture time on the base station clock, so it can tell how old the sample is
+				baseStamp = roveClockToBase(capturedMicros);
+
+				roveSend(&RED_socket, stamped_type, 1);
+				roveSend(&RED_socket, (char *) &baseStamp, sizeof(baseStamp));
+				roveSend(&RED_socket, (char *) &toBaseTelem,
+						getStructSize(toBaseTelem.id));
+
+			} else
+			{
+				//Send the message type
+				roveSend(&RED_socket, message_type, 1);
+
+				//Send the message contents
+				roveSend(&RED_socket, (char *) &toBaseTelem,
+						getStructSize(toBaseTelem.id));
 
-			//Send the message contents
-			roveSend(&RED_socket, (char *) &toBaseTelem,
-					getStructSize(toBaseTelem.id));
-			printf("Sent data\n");
+			}//end if
+			roveLinkTelemSent();
 
 		} else //Nothing to go out
 		{
@@ -206,9 +313,162 @@ Void roveTcpSender(UArg arg0, UArg arg1) {
 
 		}//end if
 
+		//Held back telemetry whose rate window opened while its device was quiet
+		roveTelemPolicyFlush();
+
+		now = Clock_getTicks();
+
+		if (LINK_HEARTBEAT_ENABLED && ((now - lastHeartbeatTick) >= HEARTBEAT_PERIOD_MS))
+		{
+			roveLinkHeartbeatBuild(&heartbeat);
+			roveSend(&RED_socket, heartbeat_type, 1);
+			roveSend(&RED_socket, (char *) &heartbeat, sizeof(heartbeat));
+			lastHeartbeatTick = now;
+
+		}//end if
+
+		if (CLOCK_SYNC_ENABLED && ((now - lastSyncTick) >= CLOCK_SYNC_PERIOD_MS))
+		{
+			roveClockSyncBuild(&syncRequest);
+			roveSend(&RED_socket, synchronize_type, 1);
+			roveSend(&RED_socket, (char *) &syncRequest, sizeof(syncRequest));
+			lastSyncTick = now;
+
+		}//end if
+
+		if ((now - lastLinkStatsTick) >= LINK_STATS_PERIOD_MS)
+		{
+			if (LINK_HEARTBEAT_ENABLED)
+			{
+				roveLinkStatsReport(&linkStats);
+				roveTelemQueuePost((char *) &linkStats);
+
+			}//end if
+			if (CLOCK_SYNC_ENABLED)
+			{
+				roveClockSyncReport(&clockStats);
+				roveTelemQueuePost((char *) &clockStats);
+
+			}//end if
+			if (CMD_EXPIRY_TELEM_ENABLED)
+			{
+				commandExpiryReport(&commandStats);
+				roveTelemQueuePost((char *) &commandStats);
+
+			}//end if
+			if (FRAGMENT_LINK_ENABLED)
+			{
+				roveFragmentLinkReport(&fragmentStats);
+				roveTelemQueuePost((char *) &fragmentStats);
+
+			}//end if
+			lastLinkStatsTick = now;
+
+		}//end if
+
+		if (HEALTH_ENABLED && ((now - lastHealthTick) >= HEALTH_PERIOD_MS))
+		{
+			healthTasks = roveHealthReport(&health);
+			roveTelemQueuePost((char *) &health);
+
+			//A few tasks each time round, every task at once would crowd out the other telemetry
+			for (task = 0; (task < HEALTH_TASKS_PER_PERIOD) && (task < healthTasks); task++)
+			{
+				if (nextHealthTask >= healthTasks)
+				{
+					nextHealthTask = 0;
+
+				}//end if
+
+				roveHealthTaskReport(nextHealthTask++, &taskHealth);
+				roveTelemQueuePost((char *) &taskHealth);
+
+			}//end for
+
+			lastHealthTick = now;
+
+		}//end if
+
+		//Device messages too long for one struct, put back together by roveTelemCntrl
+		while ((longSize = roveFragmentLinkTake(longMessage)) >= 0)
+		{
+			longLength = longSize;
+			roveSend(&RED_socket, long_message_type, 1);
+			roveSend(&RED_socket, (char *) &longLength, sizeof(longLength));
+			roveSend(&RED_socket, longMessage, longSize);
+
+		}//end while
+
+		//The base station asked for the command latency trace
+		if (roveTraceTakeRequest())
+		{
+			roveTraceReport(&traceReport);
+			diagnosticSize = sizeof(traceReport);
+			roveSend(&RED_socket, diagnostic_header, sizeof(diagnostic_header));
+			roveSend(&RED_socket, (char *) &diagnosticSize, sizeof(diagnosticSize));
+			roveSend(&RED_socket, (char *) &traceReport, sizeof(traceReport));
+
+		}//end if
+
+		//The base station asked for the event log, see Software/Tests/RoveLog
+		if (roveLogTakeRequest())
+		{
+			roveLogSnapshot(&logReport, logEntries);
+			diagnosticSize = sizeof(logReport) + logReport.entries * sizeof(struct log_entry);
+			roveSend(&RED_socket, log_header, sizeof(log_header));
+			roveSend(&RED_socket, (char *) &diagnosticSize, sizeof(diagnosticSize));
+			roveSend(&RED_socket, (char *) &logReport, sizeof(logReport));
+			roveSend(&RED_socket, (char *) logEntries,
+					logReport.entries * sizeof(struct log_entry));
+
+		}//end if
+
+		//The base station asked for the function timings, all zero unless PROFILE_ENABLED
+		if (roveProfileTakeRequest())
+		{
+			roveProfileReport(&profileReport);
+			diagnosticSize = sizeof(profileReport);
+			roveSend(&RED_socket, profile_header, sizeof(profile_header));
+			roveSend(&RED_socket, (char *) &diagnosticSize, sizeof(diagnosticSize));
+			roveSend(&RED_socket, (char *) &profileReport, sizeof(profileReport));
+
+		}//end if
+
+		//The base station asked for the program counter samples, none unless SAMPLER_ENABLED.
+		//Always one answer, then as many more as it takes to empty the ring
+		if (roveSamplerTakeRequest())
+		{
+			do
+			{
+				roveSamplerTake(&samplerReport, samplerTasks, samplerSamples);
+				diagnosticSize = sizeof(samplerReport)
+						+ samplerReport.tasks * sizeof(struct sampler_task)
+						+ samplerReport.samples * sizeof(struct sampler_sample);
+				roveSend(&RED_socket, samples_header, sizeof(samples_header));
+				roveSend(&RED_socket, (char *) &diagnosticSize, sizeof(diagnosticSize));
+				roveSend(&RED_socket, (char *) &samplerReport, sizeof(samplerReport));
+				roveSend(&RED_socket, (char *) samplerTasks,
+						samplerReport.tasks * sizeof(struct sampler_task));
+				roveSend(&RED_socket, (char *) samplerSamples,
+						samplerReport.samples * sizeof(struct sampler_sample));
+
+			} while (RED_socket.isConnected && (samplerReport.samples == SAMPLER_BATCH));
+
+		}//end if
+
+		//Socket still open but the base station stopped answering: shut it down so
+		//roveTcpHandler's recv fails right away and it stops the motors and reconnects
+		if (roveLinkIsDead())
+		{
+			roveLog(LOG_SENDER_LINK_DEAD, HEARTBEAT_TIMEOUT_MS, 0, 0);
+			shutdown(RED_socket.socketFileDescriptor, SHUT_RDWR);
+			RED_socket.isConnected = false;
+
+		}//end if
+
 	}//end while
 
-	printf("SendTask has detected a closed connection. Cleaning up\n");
+	roveLogEvent(LOG_SENDER_CLOSED);
 	//Cleanup: Connection has broken
 	fdClose(RED_socket.socketFileDescriptor);
 	fdCloseSession((void*) TaskSelf());
@@ -294,8 +554,7 @@ static bool attemptToConnect(struct NetworkConnection* connection) {
 
     if (connection->socketFileDescriptor == -1) {
 
-        printf("Failed Socket() create serverfd (src = socket()) (%d)\n",
-                fdError());
+        roveLog(LOG_TCP_SOCKET_FAILED, fdError(), 0, 0);
 
 
     }			//endif:	(serverfd == -1)
@@ -327,13 +586,13 @@ static bool attemptToConnect(struct NetworkConnection* connection) {
 
 			connection->isConnected = false;
 			error_code = fdError();
-			printf("Fderror: %d\n", error_code);
+			roveLog(LOG_TCP_CONNECT_FAILED, error_code, 0, 0);
 
 			//We're not in an error state if RED actively rejected us
 			if(error_code == ETIMEDOUT)
 			{
     		Watchdog_clear(watchdog);
-    		printf("Watchdog cleared - attemptToConnect\n");
+    		roveLogEvent(LOG_TCP_WATCHDOG_CLEARED);
 
 			}
 			return false;
@@ -350,47 +609,336 @@ static bool attemptToConnect(struct NetworkConnection* connection) {
 
 }	//endfnctn attemptToConnect(struct NetworkConnection* connection)
 
-static bool parseRoverCommandMessage(struct NetworkConnection* connection) {
+static bool parseRoverCommandMessage(struct NetworkConnection* connection,
+        bool stamped) {
 
     int size;
-    static base_station_msg_struct messagebuffer;
+    int buffer;
+    base_station_msg_struct* messagebuffer;
+    struct command_stamp_struct stamp;
+    uint32_t trace_start;
+
+    PROFILE_BEGIN(PROFILE_PARSE_COMMAND);
 
     //printf("Entering parseRoverCommandMessage\n");
 
-    // get type of message
-    if (!roveRecv(connection, &(messagebuffer.id), 1)) {
+    // the message type byte was just read, the trace runs from here. The command is received
+    // straight into a pool buffer and goes to roveCmdCntrl by index, never copied
+
+    buffer = roveMsgPoolAlloc();
+    messagebuffer = roveMsgPoolMessage(buffer);
+
+    messagebuffer->trace_start = roveTraceStart();
+
+    // ROVER_COMMAND_STAMPED puts the sequence number and send time ahead of the command
+
+    messagebuffer->flags = CMD_FLAG_TRACED;
+    messagebuffer->seq = 0;
+    messagebuffer->sent_us = 0;
+
+    if (stamped) {
+
+        if (roveRecv(connection, (char*) &stamp, sizeof(stamp)) == -1) {
+
+            roveMsgPoolFree(buffer);
+            return false;
 
+        }	//endif
+
+        messagebuffer->flags |= CMD_FLAG_STAMPED;
+        messagebuffer->seq = stamp.seq;
+        messagebuffer->sent_us = stamp.sent_us;
+
+    }	//endif
+
+    // get type of message. roveRecv returns -1 on failure, never 0
+    if (roveRecv(connection, &(messagebuffer->id), 1) == -1) {
+
+        roveMsgPoolFree(buffer);
         return false;
 
     }	//endif
 
     // get size of message. Subtract one because we already got the ID byte
-    size = getStructSize((char) messagebuffer.id) - 1;
+    size = getStructSize((char) messagebuffer->id) - 1;
 
     //TODO 169-D remove the address operator for second paramenter to return char* instead of char**
 
-	if(size <= 0)
+	if(size < 0)
 	{
-		printf("Invalid struct ID recieved: %d, skipping", messagebuffer.id);
+		roveLog(LOG_TCP_BAD_STRUCT_ID, messagebuffer->id, 0, 0);
+
+		// nothing to read it into, and roveCmdCntrl must never get it
+		roveMsgPoolFree(buffer);
+		return false;
 
 	}
 
 	//TODO 169-D remove the address operator for second paramenter to return char* instead of char**
 
     // get message contents
-    if (!roveRecv(connection, &(messagebuffer.value), size)) {
+    if ((size > 0) && (roveRecv(connection, messagebuffer->value, size) == -1)) {
 
+        roveMsgPoolFree(buffer);
         return false;
 
     }					//endif
 
     //printf("Recieved data. Posting to mailbox\n");
 
+    roveTraceStage(TRACE_RECV, messagebuffer->trace_start);
+
+    // hand the buffer to roveCmdCntrl, which frees it: nothing in it is ours after this
+
+    trace_start = messagebuffer->trace_start;
+
+    roveCmdQueuePostBuffer(buffer);
+
+    roveTraceStage(TRACE_POST, trace_start);
+
+    PROFILE_END(PROFILE_PARSE_COMMAND);
+
+    return true;
+
+}	//endfnctn parseRoverCommandMessage(struct NetworkConnection* connection, bool stamped)
+
+static void commandExpiryReport(struct command_expiry_telem* report) {
+
+    struct cmd_expiry_stats stats;
+
+    roveCmdExpiryStats(&stats);
+
+    report->struct_id = command_expiry_telem_id;
+    report->max_age_ms = stats.max_age_ms;
+    report->accepted = stats.accepted;
+    report->dropped_stale = stats.dropped_stale;
+    report->dropped_out_of_order = stats.dropped_out_of_order;
+    report->unchecked_age = stats.unchecked_age;
+    report->latency_avg_us = stats.latency_avg_us;
+    report->latency_max_us = stats.latency_max_us;
+    report->late_stops = stats.late_stops;
+
+}	//endfnctn commandExpiryReport(struct command_expiry_telem* report)
+
+static bool parseCommandMetadataMessage(struct NetworkConnection* connection) {
+
+    struct command_expiry_command command;
+    struct command_expiry_telem reply;
+
+    if (roveRecv(connection, (char*) &command, sizeof(command)) == -1) {
+
+        return false;
+
+    }	//endif
+
+    roveCmdExpirySetMaxAge(command.max_age_ms);
+
+    // answer with the max age now in force and the drop counters
+
+    commandExpiryReport(&reply);
+    roveTelemQueuePost((char*) &reply);
+
+    return true;
+
+}	//endfnctn parseCommandMetadataMessage(struct NetworkConnection* connection)
+
+static bool parseTelemMetadataMessage(struct NetworkConnection* connection) {
+
+    struct telem_policy_command command;
+    base_station_msg_struct reply;
+
+    if (roveRecv(connection, (char*) &command, sizeof(command)) == -1) {
+
+        return false;
+
+    }	//endif
+
+    if (!roveTelemPolicyModeValid(command.mode)) {
+
+        roveLog(LOG_TCP_BAD_POLICY_MODE, command.telem_id, command.mode, 0);
+
+    } else if (!roveTelemPolicyApply(&command)) {
+
+        roveLog(LOG_TCP_POLICY_FULL, command.telem_id, 0, 0);
+
+    }	//endif
+
+    // answer with the policy now in force and its drop / merge counters
+
+    if (roveTelemPolicyReport(command.telem_id,
+            (struct telem_policy_telem*) &reply)) {
+
+        roveTelemQueuePost((char*) &reply);
+
+    }	//endif
+
+    return true;
+
+}	//endfnctn parseTelemMetadataMessage(struct NetworkConnection* connection)
+
+static bool parseHeartbeatMessage(struct NetworkConnection* connection) {
+
+    struct heartbeat_struct heartbeat;
+
+    if (roveRecv(connection, (char*) &heartbeat, sizeof(heartbeat)) == -1) {
+
+        return false;
+
+    }	//endif
+
+    roveLinkHeartbeatEcho(&heartbeat);
+
+    return true;
+
+}	//endfnctn parseHeartbeatMessage(struct NetworkConnection* connection)
+
+static bool parseDiagnosticMessage(struct NetworkConnection* connection) {
+
+    char kind;
+
+    if (roveRecv(connection, &kind, 1) == -1) {
+
+        return false;
+
+    }	//endif
+
+    // answered by roveTcpSender, the only task that writes to the socket
+
+    if (kind == DIAGNOSTIC_TRACE) {
+
+        roveTraceRequest();
+
+    } else if (kind == DIAGNOSTIC_LOG) {
+
+        roveLogRequest();
+
+    } else if (kind == DIAGNOSTIC_PROFILE) {
+
+        roveProfileRequest();
+
+    } else if (kind == DIAGNOSTIC_SAMPLES) {
+
+        roveSamplerRequest();
+
+    } else {
+
+        roveLog(LOG_TCP_UNKNOWN_DIAGNOSTIC, kind, 0, 0);
+
+    }	//endif
+
+    return true;
+
+}	//endfnctn parseDiagnosticMessage(struct NetworkConnection* connection)
+
+static bool parseSynchronizeMessage(struct NetworkConnection* connection) {
+
+    struct clock_sync_struct reply;
+
+    if (roveRecv(connection, (char*) &reply, sizeof(reply)) == -1) {
+
+        return false;
+
+    }	//endif
+
+    roveClockSyncUpdate(&reply);
+
+    return true;
+
+}	//endfnctn parseSynchronizeMessage(struct NetworkConnection* connection)
+
+static bool parseLongMessage(struct NetworkConnection* connection) {
+
+    static uint8_t message_id = 0;
+
+    uint16_t total_length;
+    uint8_t destination;
+    char skipped[FRAGMENT_DATA_SIZE];
+    int count;
+    int index;
+    int length;
+    int buffer;
+    base_station_msg_struct* messagebuffer;
+    struct fragment_struct* fragment;
+    char* data;
+
+    if (roveRecv(connection, (char*) &total_length, sizeof(total_length)) == -1) {
+
+        return false;
+
+    }	//endif
+
+    count = roveFragmentCount(total_length);
+
+    if (count == 0) {
+
+        roveLog(LOG_TCP_BAD_LONG_MESSAGE, total_length, 0, 0);
+
+        // read past it so the next message type lines up
+        while (total_length > 0) {
+
+            length = (total_length < sizeof(skipped)) ? total_length : sizeof(skipped);
+
+            if (roveRecv(connection, skipped, length) == -1) {
+
+                return false;
+
+            }	//endif
+
+            total_length -= length;
+
+        }	//endwhile
+
+        return false;
+
+    }	//endif
+
+    // the struct id routes every fragment, so it is read before the first one is made
+
+    if (roveRecv(connection, (char*) &destination, 1) == -1) {
+
+        return false;
+
+    }	//endif
+
+    message_id++;
+
+    // each fragment is read straight into a pool buffer and goes to roveCmdCntrl by index.
+    // A long message can outrun the pool, roveMsgPoolAlloc then waits for roveCmdCntrl
+
+    for (index = 0; index < count; index++) {
+
+        buffer = roveMsgPoolAlloc();
+        messagebuffer = roveMsgPoolMessage(buffer);
+        fragment = (struct fragment_struct*) messagebuffer;
+
+        length = roveFragmentPrepare(fragment, fragment_id, destination, message_id, index,
+                total_length);
+
+        data = (char*) fragment->data;
+
+        if (index == 0) {
+
+            *data++ = destination;
+            length--;
+
+        }	//endif
+
+        if ((length > 0) && (roveRecv(connection, data, length) == -1)) {
+
+            roveMsgPoolFree(buffer);
+            return false;
+
+        }	//endif
+
+        // never stamped or traced
+        messagebuffer->flags = 0;
+        messagebuffer->seq = 0;
+        messagebuffer->sent_us = 0;
 
-    // post message to maibox. The mailbox is defined as a global by the config script
+        roveCmdQueuePostBuffer(buffer);
 
-    Mailbox_post(fromBaseStationMailbox, &messagebuffer, BIOS_WAIT_FOREVER);
+    }	//endfor
 
     return true;
 
-}	//endfnctn parseRoverCommandMessage(struct NetworkConnection* connection)
+}	//endfnctn parseLongMessage(struct NetworkConnection* connection)
@@ -11,7 +11,7 @@
 //
 // recieves telemetry from Devices in roveCom protocol via uart
 //
-// sends telemetry to TCPHandler via roveCom protocol using TI.Mailbox.from objecm
+// sends telemetry to TCPHandler via roveCom protocol using the roveTelemQueue, which never blocks
 //
 // BIOS_start in main inits this as the roveTelemCntrlTask Thread
 //
@@ -21,6 +21,38 @@
 
 #include "roveIncludes/roveWareHeaders/roveTelemCntrl.h"
 
+#include <ti/sysbios/knl/Swi.h>
+
+// wheel speed feedback from a device, handed to the loops in the profile Swi all at once
+
+static void speedFeedback(const char* message) {
+
+    struct wheel_feedback_telem feedback;
+    int motor;
+    UInt key;
+
+    memcpy(&feedback, message, sizeof(feedback));
+
+    key = Swi_disable();
+
+    for (motor = 0; motor < DRIVE_MOTOR_COUNT; motor++) {
+
+        if (feedback.kind == WHEEL_FEEDBACK_CURRENT) {
+
+            roveSpeedControlCurrent(motor, (int32_t) feedback.value[motor] * 10);
+
+        } else {
+
+            roveSpeedControlFeedback(motor, feedback.value[motor]);
+
+        } //endif
+
+    } //endfor
+
+    Swi_restore(key);
+
+} //endfnctn speedFeedback
+
 Void roveTelemCntrl(UArg arg0, UArg arg1) {
 
     const uint8_t FOREVER = 1;
@@ -29,19 +61,46 @@ Void roveTelemCntrl(UArg arg0, UArg arg1) {
 
     int deviceJack;
 
+    // the only jack read: deviceRead blocks on GPS_ON_MOB and has no reads for the others, so
+    // wheel_feedback_telem and any other telemetry has to come in on this jack with the GPS
     deviceJack = GPS_ON_MOB;
 
     while (FOREVER) {
 
         while(!recvSerialStructMessage(deviceJack, messageBuffer));
 
-        Mailbox_post(toBaseStationMailbox, messageBuffer, BIOS_WAIT_FOREVER);
+        if (SPEED_CONTROL_CLOSED_LOOP && (messageBuffer[0] == wheel_feedback_telem_id)) {
+
+            speedFeedback(messageBuffer);
+
+        } //endif
+
+        // a piece of a long device message: no rate limit or merging, it goes out whole.
+        // Dropped if the base station can't read ROVER_LONG_MESSAGE
+
+        if (messageBuffer[0] == fragment_id) {
+
+            if (FRAGMENT_LINK_ENABLED) {
+
+                roveFragmentLinkReceive(messageBuffer);
+
+            } //endif
+
+        } else if (roveTelemPolicyFilter(messageBuffer) == TELEM_POLICY_FORWARD) {
+
+            roveTelemQueuePost(messageBuffer);
+
+        } //endif
+
+        // anything held back by its rate limit whose window has opened since
+
+        roveTelemPolicyFlush();
 
     } //endwhile
 
     //postcondition: execution will not reach this state unless a serious error occurs
 
-    printf("Rove Telem Cntrl Task Error: Forced Exit\n");
+    roveLogEvent(LOG_TELEM_EXIT);
 
     //exit Task
 
@@ -0,0 +1,331 @@
+# base_station_sync.py MST MRDT
+#
+# Reference base station side of the rover link housekeeping, for testing on a Linux host
+#
+#   SYNCHRONIZE_STATUS  answers the rover's clock sync requests with t2 / t3 (see roveClockSync.h)
+#   ROVER_HEARTBEAT     echoes heartbeats back with base receive / send times (see roveLinkStats.h)
+#   ROVER_TELEM_STAMPED prints how old each sample was when it arrived
+#   ROVER_COMMAND_STAMPED stamped_command() builds commands roveCmdCntrl can age check (see roveCmdExpiry.h)
+#   drive_calibration   calibration_command() builds an ESC table for one drive motor (see roveCalibration.h)
+#   ROVER_DIAGNOSTIC    asks for the command latency trace every DIAGNOSTIC_PERIOD_S and prints it (see roveTrace.h)
+#                       and for the event log, saved to rove_log.bin for RoveLog/rove_log.py (see roveLog.h)
+#                       and for the cycle counter function timings (see roveProfile.h)
+#                       and for the program counter samples, saved to rove_samples.bin for
+#                       SampleProfiler/sample_profile.py (see roveSampler.h)
+#   ROVER_LONG_MESSAGE  long_message() frames a message longer than MAX_COMMAND_SIZE, device messages
+#                       the rover put back together are printed (see roveFragmentLink.h)
+#
+# and keeps its own estimate of the rover clock from the same exchanges, so both ends can be compared.
+# Listens where the rover expects RED (RED_IP, TCPPORT in mrdtRoveWare.h)
+#
+# usage: python base_station_sync.py [bind_ip] [port]
+
+from __future__ import print_function
+import socket
+import struct
+import sys
+import time
+
+SYNCHRONIZE_STATUS = 0x01
+ROVER_TELEM = 0x06
+ROVER_TELEM_DELTA = 0x08
+ROVER_HEARTBEAT = 0x09
+ROVER_TELEM_STAMPED = 0x0A
+ROVER_COMMAND_STAMPED = 0x0B
+ROVER_DIAGNOSTIC = 0x0C
+ROVER_LONG_MESSAGE = 0x0D
+
+DIAGNOSTIC_TRACE = 0x01
+DIAGNOSTIC_LOG = 0x02
+DIAGNOSTIC_PROFILE = 0x03
+DIAGNOSTIC_SAMPLES = 0x04
+DIAGNOSTIC_PERIOD_S = 5
+TRACE_STAGE_NAMES = ['recv', 'post', 'dispatch', 'actuate']
+PROFILE_PROBE_NAMES = ['calcCheckSum', 'buildSerialStructMessage', 'deviceWrite', 'DriveMotor', 'DriveMotorStage',
+                       'DriveMotorCommit', 'roveMotionProfileTick', 'parseRoverCommandMessage', 'calcCrc16']
+
+CLOCK_SYNC_FORMAT = '<BIII'
+HEARTBEAT_FORMAT = '<HIII'
+COMMAND_STAMP_FORMAT = '<HI'
+
+# getStructSize() for every telemetry id the rover can send
+TELEM_SIZES = {
+    140: 24,   # gps_telem
+    141: 22,   # telem_policy_telem
+    142: 30,   # link_stats_telem
+    143: 11,   # clock_sync_telem
+    144: 29,   # command_expiry_telem
+    145: 14,   # wheel_feedback_telem
+    146: 14,   # discovery_telem
+    147: 25,   # system_health_telem
+    148: 27,   # task_health_telem
+    149: 23,   # fragment_telem
+}
+
+TELEM_NAMES = {140: 'gps', 141: 'telem policy', 142: 'link stats', 143: 'clock sync', 144: 'commands', 145: 'wheel feedback', 146: 'discovery',
+               147: 'health', 148: 'task', 149: 'long messages'}
+
+START = time.time()
+
+
+def base_micros():
+    """The base station clock: microseconds, wrapping at 32 bits like the rover's."""
+    return int((time.time() - START) * 1000000) & 0xFFFFFFFF
+
+
+def signed32(value):
+    value &= 0xFFFFFFFF
+    return value - (1 << 32) if value & 0x80000000 else value
+
+
+def stamped_command(seq, command):
+    """ROVER_COMMAND_STAMPED framing of a packed command struct (id first), stamped with the base clock now."""
+    header = struct.pack(COMMAND_STAMP_FORMAT, seq & 0xFFFF, base_micros())
+    return bytearray([ROVER_COMMAND_STAMPED]) + header + bytearray(command)
+
+
+DRIVE_CALIBRATION_ID = 104
+CALIBRATION_POINTS = 6
+
+
+def calibration_command(motor, neutral_us, forward_us, reverse_us, save=False):
+    """drive_calibration_command: pulse widths at speed 1, 200, 400 ... 1000 each side of neutral."""
+    if len(forward_us) != CALIBRATION_POINTS or len(reverse_us) != CALIBRATION_POINTS:
+        raise ValueError('need %d points each side' % CALIBRATION_POINTS)
+    return struct.pack('<BBBH%dH%dH' % (CALIBRATION_POINTS, CALIBRATION_POINTS), DRIVE_CALIBRATION_ID,
+                       motor, 1 if save else 0, neutral_us, *(list(forward_us) + list(reverse_us)))
+
+
+def long_message(message):
+    """ROVER_LONG_MESSAGE framing of a packed struct (id first) of any length up to 6144 bytes."""
+    return bytearray([ROVER_LONG_MESSAGE]) + struct.pack('<H', len(message)) + bytearray(message)
+
+
+def trace_request():
+    """ROVER_DIAGNOSTIC asking for the per stage command latency histograms."""
+    return bytearray([ROVER_DIAGNOSTIC, DIAGNOSTIC_TRACE])
+
+
+def log_request():
+    """ROVER_DIAGNOSTIC asking for the rover's binary event log."""
+    return bytearray([ROVER_DIAGNOSTIC, DIAGNOSTIC_LOG])
+
+
+def print_trace(body):
+    """trace_report: per stage, latency since the command's first byte arrived."""
+    stages, buckets = struct.unpack('<BB', body[:2])
+    offset = 2
+    print('command latency trace, us since the message type byte:')
+    for stage in range(stages):
+        fields = struct.unpack('<IHI%dH' % buckets, body[offset:offset + 10 + 2 * buckets])
+        offset += 10 + 2 * buckets
+        samples, window, worst, histogram = fields[0], fields[1], fields[2], fields[3:]
+        name = TRACE_STAGE_NAMES[stage] if stage < len(TRACE_STAGE_NAMES) else 'stage %d' % stage
+        # median from the histogram: the bucket the middle sample falls in, as its upper edge
+        median, seen = 0, 0
+        for bucket, count in enumerate(histogram):
+            seen += count
+            if window and seen * 2 >= window:
+                median = 2 << bucket
+                break
+        print('  %-8s %7d total, last %3d: median < %d us, max %d us  %s' % (
+            name, samples, window, median, worst, ' '.join('%d' % count for count in histogram)))
+
+
+def profile_request():
+    """ROVER_DIAGNOSTIC asking for the roveProfile probe table."""
+    return bytearray([ROVER_DIAGNOSTIC, DIAGNOSTIC_PROFILE])
+
+
+def print_profile(body):
+    """profile_report: count and min / mean / max per probe, cycles turned into microseconds."""
+    cpu_hz, probes = struct.unpack('<IB', body[:5])
+    print('function timings at %d MHz:' % (cpu_hz // 1000000))
+    for probe in range(probes):
+        count, low, high, mean = struct.unpack('<IIII', body[5 + 16 * probe:21 + 16 * probe])
+        name = PROFILE_PROBE_NAMES[probe] if probe < len(PROFILE_PROBE_NAMES) else 'probe %d' % probe
+        if count == 0:
+            print('  %-26s never ran (PROFILE_ENABLED false?)' % name)
+            continue
+        per_us = cpu_hz / 1e6
+        print('  %-26s %8d calls, min %8.2f us, mean %8.2f us, max %8.2f us' % (
+            name, count, low / per_us, mean / per_us, high / per_us))
+
+
+def samples_request():
+    """ROVER_DIAGNOSTIC asking for the roveSampler program counter samples, the rover empties its ring."""
+    return bytearray([ROVER_DIAGNOSTIC, DIAGNOSTIC_SAMPLES])
+
+
+def recv_exact(connection, count):
+    data = b''
+    while len(data) < count:
+        chunk = connection.recv(count - len(data))
+        if not chunk:
+            raise EOFError('rover closed the connection')
+        data += chunk
+    return data
+
+
+# the last fragment_telem and when it came, for the throughput between two
+last_fragment_telem = None
+
+
+def print_telem(body, age_us=None):
+    global last_fragment_telem
+    struct_id = bytearray(body)[0]
+    line = TELEM_NAMES.get(struct_id, 'id %d' % struct_id)
+    if struct_id == 142:
+        _, samples, lost, srtt, rttvar, p50, p90, p99, worst, sent = struct.unpack('<BBHIIIIIIH', body)
+        line += ': srtt %d us, p50 %d, p90 %d, p99 %d, max %d, %d lost, %d telem sent' % (srtt, p50, p90, p99, worst, lost, sent)
+    elif struct_id == 143:
+        _, valid, samples, offset, delay = struct.unpack('<BBBiI', body)
+        line += ': rover thinks base - rover = %d us (delay %d us, valid %d)' % (offset, delay, valid)
+    elif struct_id == 144:
+        _, max_age, accepted, stale, old_seq, unchecked, avg, worst, stops = struct.unpack('<BHIIIIIIH', body)
+        line += ': %d applied, %d stale (> %d ms), %d out of order, %d late stops applied, %d unchecked, latency avg %d us max %d us' % (
+            accepted, stale, max_age, old_seq, stops, unchecked, avg, worst)
+    elif struct_id == 145:
+        values = struct.unpack('<BB6h', body)
+        line += (': current %s x 10 mA' if values[1] else ': speed %s') % (list(values[2:]),)
+    elif struct_id == 146:
+        values = struct.unpack('<BH11B', body)
+        names = {0: '-', 254: 'not probed', 255: 'bad reply'}
+        line += ': %d ms, ' % values[1] + ', '.join(
+            'jack %d %s' % (7 + i, names.get(device, device)) for i, device in enumerate(values[2:]))
+    elif struct_id == 147:
+        (_, cpu, swi, free, largest, hwi_size, hwi_peak, cmd_count, cmd_high, queue_high, tasks, pool_used,
+         pool_high, pool_waits) = struct.unpack('<BHHIIHHBBBBBBH', body)
+        line += ': cpu %.1f%%, swi %.1f%%, heap %d free (largest %d), hwi stack %d of %d, commands %d waiting ' \
+                '(most %d), telem queue %d, %d tasks, pool %d in use (most %d, %d waits)' % (
+                    cpu / 10.0, swi / 10.0, free, largest, hwi_peak, hwi_size, cmd_count, cmd_high, queue_high, tasks,
+                    pool_used, pool_high, pool_waits)
+    elif struct_id == 148:
+        _, task, priority, load, size, peak, name = struct.unpack('<BBbHHH18s', body)
+        name = name.split(b'\0')[0].decode('ascii', 'replace') or 'task %d' % task
+        line += ' %-18s pri %2d, %5.1f%%, stack %4d of %4d' % (name, priority, load / 10.0, peak, size)
+    elif struct_id == 149:
+        (_, sent, received, bytes_sent, bytes_received, fragments_sent, fragments_received, dropped, timeouts,
+         queue_full) = struct.unpack('<BHHIIHHHHH', body)
+        line += ': to devices %d (%d bytes, %d fragments), from devices %d (%d bytes, %d fragments), ' \
+                '%d fragments dropped, %d timed out, %d queue full' % (
+                    sent, bytes_sent, fragments_sent, received, bytes_received, fragments_received, dropped, timeouts,
+                    queue_full)
+        now = time.time()
+        if last_fragment_telem is not None:
+            then, then_sent, then_received = last_fragment_telem
+            line += ', %.0f bytes/s to and %.0f from devices' % (((bytes_sent - then_sent) & 0xFFFFFFFF) / (now - then),
+                                               ((bytes_received - then_received) & 0xFFFFFFFF) / (now - then))
+        last_fragment_telem = (now, bytes_sent, bytes_received)
+    if age_us is not None:
+        line += '   [age %.2f ms]' % (age_us / 1000.0)
+    print(line)
+
+
+def main():
+    bind_ip = sys.argv[1] if len(sys.argv) > 1 else '192.168.1.2'
+    port = int(sys.argv[2]) if len(sys.argv) > 2 else 11000
+
+    server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    server.bind((bind_ip, port))
+    server.listen(1)
+
+    print('Waiting for rover on %s:%d' % (bind_ip, port))
+    connection, addr = server.accept()
+    connection.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+    print('Connected to', addr)
+
+    # base side view of the rover clock, from the heartbeats: (offset, delay) with the lowest delay wins
+    best = None
+    last_diagnostic = time.time()
+    # every samples batch of this connection, each behind its u16 size
+    samples_dump = open('rove_samples.bin', 'wb')
+    sample_count = 0
+
+    try:
+        while True:
+            message_type = bytearray(recv_exact(connection, 1))[0]
+
+            # heartbeats come every 100 ms, so this runs often enough
+            if time.time() - last_diagnostic >= DIAGNOSTIC_PERIOD_S:
+                connection.sendall(trace_request() + log_request() + profile_request() + samples_request())
+                last_diagnostic = time.time()
+
+            if message_type == SYNCHRONIZE_STATUS:
+                data = recv_exact(connection, struct.calcsize(CLOCK_SYNC_FORMAT))
+                t2 = base_micros()
+                seq, t1, _, _ = struct.unpack(CLOCK_SYNC_FORMAT, data)
+                reply = struct.pack(CLOCK_SYNC_FORMAT, seq, t1, t2, base_micros())
+                connection.sendall(bytearray([SYNCHRONIZE_STATUS]) + reply)
+
+            elif message_type == ROVER_HEARTBEAT:
+                data = recv_exact(connection, struct.calcsize(HEARTBEAT_FORMAT))
+                base_rx = base_micros()
+                seq, rover_tx, _, _ = struct.unpack(HEARTBEAT_FORMAT, data)
+                reply = struct.pack(HEARTBEAT_FORMAT, seq, rover_tx, base_rx, base_micros())
+                connection.sendall(bytearray([ROVER_HEARTBEAT]) + reply)
+
+                # one way only, so this bounds the offset rather than measuring it
+                offset = signed32(base_rx - rover_tx)
+                if best is None or offset < best:
+                    best = offset
+
+            elif message_type == ROVER_TELEM:
+                struct_id = bytearray(recv_exact(connection, 1))[0]
+                body = bytearray([struct_id]) + recv_exact(connection, TELEM_SIZES[struct_id] - 1)
+                print_telem(bytes(body))
+
+            elif message_type == ROVER_TELEM_STAMPED:
+                stamp, struct_id = struct.unpack('<IB', recv_exact(connection, 5))
+                age = signed32(base_micros() - stamp)
+                body = bytearray([struct_id]) + recv_exact(connection, TELEM_SIZES[struct_id] - 1)
+                print_telem(bytes(body), age)
+
+            elif message_type == ROVER_TELEM_DELTA:
+                header = bytearray(recv_exact(connection, 4))
+                recv_exact(connection, header[3])
+                print('delta frame for id %d (decode with TelemetryCodec/telem_codec.py)' % header[0])
+
+            elif message_type == ROVER_DIAGNOSTIC:
+                kind, size = struct.unpack('<BH', recv_exact(connection, 3))
+                body = recv_exact(connection, size)
+                if kind == DIAGNOSTIC_TRACE:
+                    print_trace(body)
+                elif kind == DIAGNOSTIC_PROFILE:
+                    print_profile(body)
+                elif kind == DIAGNOSTIC_LOG:
+                    with open('rove_log.bin', 'wb') as dump:
+                        dump.write(body)
+                    print('event log, %d bytes (decode with RoveLog/rove_log.py rove_log.bin)' % size)
+                elif kind == DIAGNOSTIC_SAMPLES:
+                    samples_dump.write(struct.pack('<H', size) + body)
+                    samples_dump.flush()
+                    sample_count += struct.unpack('<H', body[12:14])[0]
+                    print('%d program counter samples saved (profile with SampleProfiler/sample_profile.py rove_samples.bin)'
+                          % sample_count)
+                else:
+                    print('diagnostic %d, %d bytes' % (kind, size))
+
+            elif message_type == ROVER_LONG_MESSAGE:
+                size = struct.unpack('<H', recv_exact(connection, 2))[0]
+                body = bytearray(recv_exact(connection, size))
+                print('long message from id %d, %d bytes' % (body[0], size))
+
+            else:
+                print('Unknown message type 0x%02x, stream lost' % message_type)
+                break
+
+    except (EOFError, KeyboardInterrupt) as error:
+        print(error)
+
+    if best is not None:
+        print('base - rover upper bound from heartbeats: %d us' % best)
+
+    samples_dump.close()
+    connection.close()
+    server.close()
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,189 @@
+// calibration_ref.c MST MRDT
+//
+// Checks the fixed point roveCalibration tables against a floating point reference on a host
+//
+// every speed from -1000 to 1000 through the default table and an ESC with an offset neutral,
+// a deadband and uneven end points, compared with straight line interpolation between the
+// points. Also checks that bad tables are refused and that the EEPROM image round trips and
+// is refused once a byte of it is damaged
+//
+// build and run on a Linux host:
+//
+// 	gcc -Wall -o calibration_ref calibration_ref.c ../../CCS/RoverMotherboard/roveIncludes/roveWareSource/roveCalibration.c -lm
+// 	./calibration_ref
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../CCS/RoverMotherboard/roveIncludes/roveWareHeaders/roveCalibration.h"
+
+// the old DriveMotor scaling, before calibration
+
+static int linearMicroseconds(int speed) {
+
+    int microseconds = speed / 2 + 1500;
+
+    if (microseconds > 2000) {
+
+        microseconds = 2000;
+
+    }
+
+    if (microseconds < 1000) {
+
+        microseconds = 1000;
+
+    }
+
+    return microseconds;
+
+}
+
+static double referencePulse(const struct drive_calibration* table, int speed) {
+
+    const uint16_t* us = (speed > 0) ? table->forward_us : table->reverse_us;
+    double magnitude = abs(speed);
+    double low;
+    double high;
+    int point;
+
+    if (speed == 0) {
+
+        return table->neutral_us;
+
+    }
+
+    if (magnitude >= CALIBRATION_FULL_SCALE) {
+
+        return us[CALIBRATION_POINTS - 1];
+
+    }
+
+    for (point = 0; point < CALIBRATION_POINTS - 1; point++) {
+
+        low = (point == 0) ? 1 : point * CALIBRATION_STEP;
+        high = (point + 1) * CALIBRATION_STEP;
+
+        if (magnitude < high) {
+
+            return us[point] + (us[point + 1] - us[point]) * (magnitude - low) / (high - low);
+
+        }
+
+    }
+
+    return us[CALIBRATION_POINTS - 1];
+
+}
+
+// worst error against the reference over every speed, and whether the output ever steps backwards
+
+static int sweep(const char* name, int motor, const struct drive_calibration* table) {
+
+    double error;
+    double worst = 0.0;
+    int previous = 0;
+    int monotonic = 1;
+    int speed;
+    int us;
+
+    for (speed = -1100; speed <= 1100; speed++) {
+
+        us = roveCalibrationPulse(motor, speed);
+        error = fabs(us - referencePulse(table, speed));
+
+        if (error > worst) {
+
+            worst = error;
+
+        }
+
+        if ((speed > -1100) && (us < previous)) {
+
+            monotonic = 0;
+
+        }
+
+        previous = us;
+
+    }
+
+    printf("%-12s worst error %.2f us, %s\n", name, worst, monotonic ? "monotonic" : "NOT monotonic");
+
+    // rounding to whole microseconds
+    return (worst <= 0.5) && monotonic;
+
+}
+
+int main(void) {
+
+    struct drive_calibration table;
+    struct drive_calibration deadband = { 1520,
+            { 1565, 1640, 1720, 1790, 1850, 1900 },
+            { 1480, 1400, 1310, 1220, 1130, 1050 } };
+    struct drive_calibration bad;
+    struct calibration_store store;
+    int worst_linear = 0;
+    int speed;
+    int ok = 1;
+
+    // defaults: the old linear mapping on every motor
+    roveCalibrationReset();
+    roveCalibrationDefault(&table);
+    ok &= sweep("default", 0, &table);
+
+    for (speed = -1100; speed <= 1100; speed++) {
+
+        if (abs(roveCalibrationPulse(3, speed) - linearMicroseconds(speed)) > worst_linear) {
+
+            worst_linear = abs(roveCalibrationPulse(3, speed) - linearMicroseconds(speed));
+
+        }
+
+    }
+
+    printf("default against the old scaling: worst %d us\n", worst_linear);
+    ok &= (worst_linear <= 1);
+
+    // an ESC that creeps at 1500 and needs 45 us to start
+    ok &= roveCalibrationSet(2, &deadband);
+    ok &= sweep("deadband", 2, &deadband);
+    ok &= (roveCalibrationPulse(2, 0) == 1520) && (roveCalibrationPulse(2, 1) == 1565)
+            && (roveCalibrationPulse(2, -1) == 1480);
+
+    // refused: backwards, past neutral, out of range, bad motor
+    bad = deadband;
+    bad.forward_us[3] = 1700;
+    ok &= !roveCalibrationSet(2, &bad);
+    bad = deadband;
+    bad.reverse_us[0] = 1530;
+    ok &= !roveCalibrationSet(2, &bad);
+    bad = deadband;
+    bad.forward_us[5] = 2600;
+    ok &= !roveCalibrationSet(2, &bad);
+    ok &= !roveCalibrationSet(CALIBRATION_MOTORS, &deadband);
+    ok &= (roveCalibrationPulse(2, 0) == 1520);
+
+    // EEPROM image: round trip, then refused when damaged or erased
+    roveCalibrationStore(&store);
+    roveCalibrationReset();
+    ok &= roveCalibrationRestore(&store) && (roveCalibrationPulse(2, 1) == 1565);
+
+    ((uint8_t*) &store)[20] ^= 0x04;
+    roveCalibrationReset();
+    ok &= !roveCalibrationRestore(&store) && (roveCalibrationPulse(2, 1) == 1500);
+
+    memset(&store, 0xFF, sizeof(store));
+    ok &= !roveCalibrationRestore(&store);
+
+    printf("EEPROM image %d bytes (%s a whole number of words)\n", (int) sizeof(store),
+            (sizeof(store) % 4) ? "NOT" : "is");
+    ok &= (sizeof(store) % 4) == 0;
+
+    printf("%s\n", ok ? "PASS" : "FAIL");
+
+    return !ok;
+
+}
@@ -0,0 +1,312 @@
+// checksum_bench.c MST MRDT
+//
+// Host checks and timing of the roveChecksum kernels behind the serial frames
+//
+// the word at a time XOR against the byte loop calcCheckSum used to be, at every length and
+// alignment; the CRC-16 table against a bit at a time reference and the CRC-16/CCITT check
+// value; what each one misses of the errors a noisy RS485 pair makes; and ns per frame.
+// On the rover roveChecksumTester times the same kernels and the CRC module in cycles, and the
+// PROFILE_CALC_CHECKSUM / PROFILE_CALC_CRC probes time them in use (PROFILE_ENABLED in
+// mrdtRoveWare.h, DIAGNOSTIC_PROFILE in base_station_sync.py)
+//
+// build and run on a Linux host:
+//
+// 	gcc -O2 -Wall -Wextra -o checksum_bench checksum_bench.c ../../CCS/RoverMotherboard/roveIncludes/roveWareSource/roveChecksum.c
+// 	./checksum_bench
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../../CCS/RoverMotherboard/roveIncludes/roveWareHeaders/roveChecksum.h"
+
+#define MAX_LENGTH 64
+#define ERROR_TRIALS 100000
+#define TIMING_ROUNDS 2000000
+
+// the largest command, 1 id + MAX_COMMAND_SIZE, and a motor_control_struct
+
+#define LARGE_FRAME 31
+#define MOTOR_FRAME 5
+
+static int failures = 0;
+
+static void check(int ok, const char* what) {
+
+    if (!ok) {
+
+        printf("FAIL %s\n", what);
+        failures++;
+
+    }
+
+}
+
+static double now_s(void) {
+
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+
+}
+
+// calcCheckSum before this change. Kept out of line like it was, or the timing compares an
+// inlined loop against a call
+
+__attribute__((noinline)) static uint8_t xorBytes(const uint8_t* data, uint32_t size, uint8_t seed) {
+
+    uint32_t i;
+
+    for (i = 0; i < size; i++) {
+
+        seed ^= data[i];
+
+    }
+
+    return seed;
+
+}
+
+static uint16_t crcBits(const uint8_t* data, uint32_t size, uint16_t crc) {
+
+    uint32_t i;
+    int bit;
+
+    for (i = 0; i < size; i++) {
+
+        crc ^= data[i] << 8;
+
+        for (bit = 0; bit < 8; bit++) {
+
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+
+        }
+
+    }
+
+    return crc;
+
+}
+
+static void correctness(void) {
+
+    uint8_t buffer[MAX_LENGTH + 8];
+    int offset;
+    int length;
+    int round;
+
+    check(roveChecksumCrc16("123456789", 9, CHECKSUM_CRC16_SEED) == 0x29B1, "CRC-16/CCITT check value");
+
+    for (round = 0; round < 200; round++) {
+
+        for (offset = 0; offset < (int) sizeof(buffer); offset++) {
+
+            buffer[offset] = rand();
+
+        }
+
+        for (offset = 0; offset < 4; offset++) {
+
+            for (length = 0; length <= MAX_LENGTH; length++) {
+
+                check(roveChecksumXor(buffer + offset, length, length) == xorBytes(buffer + offset, length, length),
+                        "word XOR matches byte XOR");
+                check(roveChecksumCrc16(buffer + offset, length, CHECKSUM_CRC16_SEED)
+                        == crcBits(buffer + offset, length, CHECKSUM_CRC16_SEED), "table CRC matches bitwise CRC");
+
+            }
+
+        }
+
+    }
+
+}
+
+// the frame checks as the rover makes them: size byte then the struct
+
+static uint16_t frameXor(const uint8_t* data, int size) {
+
+    return roveChecksumXor(data, size, size);
+
+}
+
+static uint16_t frameCrc(const uint8_t* data, int size) {
+
+    uint8_t length = size;
+
+    return roveChecksumCrc16(data, size, roveChecksumCrc16(&length, 1, CHECKSUM_CRC16_SEED));
+
+}
+
+static void corrupt(uint8_t* frame, int size, int kind) {
+
+    int a = rand() % size;
+    int b = (a + 1 + rand() % (size - 1)) % size;
+    uint8_t mask = 1 + rand() % 255;
+    uint8_t swap;
+
+    switch (kind) {
+
+    case 0:
+        // two bytes swapped
+        if (frame[a] == frame[b]) {
+
+            frame[b] ^= 0x5A;
+
+        }
+
+        swap = frame[a];
+        frame[a] = frame[b];
+        frame[b] = swap;
+        break;
+
+    case 1:
+        // a byte doubled over its neighbour
+        b = (a + 1) % size;
+
+        if (frame[a] == frame[b]) {
+
+            frame[a] ^= 0x5A;
+
+        }
+
+        frame[b] = frame[a];
+        break;
+
+    default:
+        // the same bits flipped in two bytes
+        frame[a] ^= mask;
+        frame[b] ^= mask;
+        break;
+
+    }
+
+}
+
+static void detection(void) {
+
+    const char* kinds[] = { "two bytes swapped", "byte doubled", "same bits in two bytes" };
+    uint8_t frame[LARGE_FRAME];
+    uint8_t bad[LARGE_FRAME];
+    int missed_xor;
+    int missed_crc;
+    int kind;
+    int trial;
+    int i;
+
+    printf("undetected errors in %d frames of %d bytes:\n", ERROR_TRIALS, LARGE_FRAME);
+
+    for (kind = 0; kind < 3; kind++) {
+
+        missed_xor = 0;
+        missed_crc = 0;
+
+        for (trial = 0; trial < ERROR_TRIALS; trial++) {
+
+            for (i = 0; i < LARGE_FRAME; i++) {
+
+                frame[i] = rand();
+
+            }
+
+            memcpy(bad, frame, sizeof(frame));
+            corrupt(bad, sizeof(bad), kind);
+
+            if (memcmp(bad, frame, sizeof(frame)) == 0) {
+
+                continue;
+
+            }
+
+            missed_xor += frameXor(bad, sizeof(bad)) == frameXor(frame, sizeof(frame));
+            missed_crc += frameCrc(bad, sizeof(bad)) == frameCrc(frame, sizeof(frame));
+
+        }
+
+        printf("  %-24s XOR %6.2f%%  CRC-16 %6.2f%%\n", kinds[kind], 100.0 * missed_xor / ERROR_TRIALS,
+                100.0 * missed_crc / ERROR_TRIALS);
+
+        // swaps and doubles of unequal bytes are single burst errors under 16 bits, a CRC-16 sees all of them
+        if (kind < 2) {
+
+            check(missed_crc == 0, "CRC-16 catches every swap and double");
+
+        }
+
+    }
+
+}
+
+static volatile uint32_t sink;
+
+static void timing(int size) {
+
+    static uint8_t frame[LARGE_FRAME + 4];
+    double start;
+    double bytes_ns;
+    double words_ns;
+    double crc_ns;
+    int round;
+
+    for (round = 0; round < (int) sizeof(frame); round++) {
+
+        frame[round] = rand();
+
+    }
+
+    // offset by one, the way a struct sits after the 3 byte header
+    start = now_s();
+
+    for (round = 0; round < TIMING_ROUNDS; round++) {
+
+        frame[1] = round;
+        sink += xorBytes(frame + 1, size, size);
+
+    }
+
+    bytes_ns = (now_s() - start) * 1e9 / TIMING_ROUNDS;
+    start = now_s();
+
+    for (round = 0; round < TIMING_ROUNDS; round++) {
+
+        frame[1] = round;
+        sink += roveChecksumXor(frame + 1, size, size);
+
+    }
+
+    words_ns = (now_s() - start) * 1e9 / TIMING_ROUNDS;
+    start = now_s();
+
+    for (round = 0; round < TIMING_ROUNDS; round++) {
+
+        frame[1] = round;
+        sink += frameCrc(frame + 1, size);
+
+    }
+
+    crc_ns = (now_s() - start) * 1e9 / TIMING_ROUNDS;
+
+    printf("  %2d byte struct: byte XOR %5.1f ns, word XOR %5.1f ns, table CRC-16 %5.1f ns\n", size, bytes_ns,
+            words_ns, crc_ns);
+
+}
+
+int main(void) {
+
+    srand(1);
+
+    correctness();
+    detection();
+
+    printf("per frame on this host:\n");
+    timing(MOTOR_FRAME);
+    timing(LARGE_FRAME);
+
+    printf("%s\n", failures ? "FAILED" : "all passed");
+
+    return failures ? 1 : 0;
+
+}
@@ -0,0 +1,142 @@
+// cmd_expiry.c MST MRDT
+//
+// Host checks of roveCmdExpiry, the stale and out of order command filter in roveCmdCntrl
+//
+// each scenario feeds cmd_stamps the way roveCmdCntrl builds them from stamped commands: fresh
+// commands pass, old or overtaken ones are dropped, and stops (e_stop_arm, zero drive speeds)
+// are applied however late they are
+//
+// build and run on a Linux host:
+//
+// 	gcc -O2 -Wall -Wextra -o cmd_expiry cmd_expiry.c ../../CCS/RoverMotherboard/roveIncludes/roveWareSource/roveCmdExpiry.c
+// 	./cmd_expiry
+
+#include <stdio.h>
+
+#include "../../CCS/RoverMotherboard/roveIncludes/roveWareHeaders/roveCmdExpiry.h"
+
+// same values as mrdtRoveWare.h
+
+#define CMD_MAX_AGE_MS 250
+
+static int failures = 0;
+
+static void check(int ok, const char* what) {
+
+    if (!ok) {
+
+        printf("FAIL %s\n", what);
+        failures++;
+
+    }
+
+}
+
+static int command(int cmd_class, uint16_t seq, bool stop, int32_t age_ms) {
+
+    struct cmd_stamp stamp;
+
+    stamp.cmd_class = cmd_class;
+    stamp.seq = seq;
+    stamp.stop = stop;
+    stamp.age_known = (age_ms >= 0);
+    stamp.age_us = age_ms * 1000;
+
+    return roveCmdExpiryCheck(&stamp);
+
+}
+
+static void fresh(void) {
+
+    roveCmdExpiryReset();
+
+    check(command(CMD_CLASS_DRIVE, 1, false, 10) == CMD_ACCEPT, "fresh drive");
+    check(command(CMD_CLASS_DRIVE, 2, false, CMD_MAX_AGE_MS) == CMD_ACCEPT, "drive at max age");
+    check(command(CMD_CLASS_ARM, 1, false, 10) == CMD_ACCEPT, "arm numbered on its own");
+
+    // a wrap of the sequence number is still newer
+    check(command(CMD_CLASS_ARM, 0xFFFF, false, 10) == CMD_DROP_OUT_OF_ORDER, "arm 0xFFFF behind 1");
+    roveCmdExpiryReset();
+    check(command(CMD_CLASS_ARM, 0xFFFF, false, 10) == CMD_ACCEPT, "arm 0xFFFF after reset");
+    check(command(CMD_CLASS_ARM, 0, false, 10) == CMD_ACCEPT, "arm seq wraps");
+
+}
+
+static void stale(void) {
+
+    roveCmdExpiryReset();
+
+    check(command(CMD_CLASS_DRIVE, 1, false, CMD_MAX_AGE_MS + 1) == CMD_DROP_STALE, "stale drive");
+    check(command(CMD_CLASS_DRIVE, 2, false, 10) == CMD_ACCEPT, "drive after a stale one");
+    check(command(CMD_CLASS_DRIVE, 2, false, 10) == CMD_DROP_OUT_OF_ORDER, "repeated seq");
+    check(command(CMD_CLASS_DRIVE, 1, false, 10) == CMD_DROP_OUT_OF_ORDER, "overtaken drive");
+
+    // no clock yet: only the order counts
+    check(command(CMD_CLASS_DRIVE, 3, false, -1) == CMD_ACCEPT, "age unknown");
+
+    // age check off
+    roveCmdExpirySetMaxAge(0);
+    check(command(CMD_CLASS_DRIVE, 4, false, 60000) == CMD_ACCEPT, "max age 0");
+    roveCmdExpirySetMaxAge(CMD_MAX_AGE_MS);
+
+}
+
+static void lateStops(void) {
+
+    struct cmd_expiry_stats stats;
+    struct cmd_expiry_stats before;
+
+    roveCmdExpiryReset();
+    roveCmdExpiryStats(&before);
+
+    // the case that matters: an arm moving, then an e_stop_arm held up past the max age
+    check(command(CMD_CLASS_ARM, 10, false, 10) == CMD_ACCEPT, "arm moving");
+    check(command(CMD_CLASS_ARM, 11, true, CMD_MAX_AGE_MS * 4) == CMD_ACCEPT, "stale e_stop_arm applied");
+
+    // and a zero drive speed overtaken by a newer drive command
+    check(command(CMD_CLASS_DRIVE, 5, false, 10) == CMD_ACCEPT, "drive moving");
+    check(command(CMD_CLASS_DRIVE, 4, true, 10) == CMD_ACCEPT, "out of order stop applied");
+
+    // a late stop doesn't move the class back, seq 5 is still the newest drive applied
+    check(command(CMD_CLASS_DRIVE, 5, false, 10) == CMD_DROP_OUT_OF_ORDER, "seq not moved back");
+    check(command(CMD_CLASS_DRIVE, 6, false, 10) == CMD_ACCEPT, "next drive");
+
+    // the stale stop was newer, so the arm carries on from it
+    check(command(CMD_CLASS_ARM, 11, false, 10) == CMD_DROP_OUT_OF_ORDER, "arm seq from the stop");
+
+    roveCmdExpiryStats(&stats);
+
+    check(stats.late_stops - before.late_stops == 2, "late stops counted");
+    check(stats.dropped_stale == before.dropped_stale, "late stops not counted stale");
+    check(stats.dropped_out_of_order - before.dropped_out_of_order == 2, "out of order counted");
+    check(stats.max_age_ms == CMD_MAX_AGE_MS, "max age reported");
+
+}
+
+static void latency(void) {
+
+    struct cmd_expiry_stats stats;
+
+    roveCmdExpiryApplied(8000);
+    roveCmdExpiryApplied(24000);
+    roveCmdExpiryStats(&stats);
+
+    check(stats.latency_max_us == 24000, "latency max");
+    check(stats.latency_avg_us == 8000 - 500 + 1500, "latency average, 1/16 weight");
+
+}
+
+int main(void) {
+
+    roveCmdExpirySetMaxAge(CMD_MAX_AGE_MS);
+
+    fresh();
+    stale();
+    lateStops();
+    latency();
+
+    printf("%s\n", failures ? "FAILED" : "all passed");
+
+    return failures ? 1 : 0;
+
+}
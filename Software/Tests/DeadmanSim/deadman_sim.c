@@ -0,0 +1,163 @@
+// deadman_sim.c MST MRDT
+//
+// Host simulation of the roveDeadman failsafe in virtual time
+//
+// the deadmanTimer Hwi is replaced by a loop calling roveDeadmanTick(DEADMAN_TICK_MS) and the
+// neutral functions record when they ran, so each scenario can check the exact trip time
+//
+// build and run on a Linux host:
+//
+// 	gcc -Wall -o deadman_sim deadman_sim.c ../../CCS/RoverMotherboard/roveIncludes/roveWareSource/roveDeadman.c
+// 	./deadman_sim
+
+#include <stdio.h>
+
+#include "../../CCS/RoverMotherboard/roveIncludes/roveWareHeaders/roveDeadman.h"
+
+// same values as mrdtRoveWare.h
+
+#define DEADMAN_WINDOW_MS 250
+#define DEADMAN_TICK_MS 5
+
+static uint32_t virtual_ms;
+static uint32_t neutral_at_ms[DEADMAN_GROUP_COUNT];
+static int neutral_calls[DEADMAN_GROUP_COUNT];
+static int failures = 0;
+
+static void neutralGroup(int group) {
+
+    neutral_at_ms[group] = virtual_ms;
+    neutral_calls[group]++;
+
+}
+
+static void leftNeutral(void) { neutralGroup(DEADMAN_LEFT_DRIVE); }
+static void rightNeutral(void) { neutralGroup(DEADMAN_RIGHT_DRIVE); }
+static void armNeutral(void) { neutralGroup(DEADMAN_ARM); }
+
+static void reset(uint32_t start_ms) {
+
+    int group;
+
+    roveDeadmanInit(DEADMAN_LEFT_DRIVE, DEADMAN_WINDOW_MS, leftNeutral);
+    roveDeadmanInit(DEADMAN_RIGHT_DRIVE, DEADMAN_WINDOW_MS, rightNeutral);
+    roveDeadmanInit(DEADMAN_ARM, DEADMAN_WINDOW_MS, armNeutral);
+
+    // every group is disarmed, so one big tick jumps the clock to start_ms (which
+    // scenarios put near the top of the range to cross the 32 bit wrap)
+    roveDeadmanTick(start_ms - virtual_ms);
+    virtual_ms = start_ms;
+
+    for (group = 0; group < DEADMAN_GROUP_COUNT; group++) {
+
+        neutral_at_ms[group] = 0;
+        neutral_calls[group] = 0;
+
+    }
+
+}
+
+// advance virtual time by ms, one timer period at a time
+
+static void run(uint32_t ms) {
+
+    uint32_t end = virtual_ms + ms;
+
+    while (virtual_ms != end) {
+
+        virtual_ms += DEADMAN_TICK_MS;
+        roveDeadmanTick(DEADMAN_TICK_MS);
+
+    }
+
+}
+
+static void check(int ok, const char* what) {
+
+    printf("%s  %s\n", ok ? "PASS" : "FAIL", what);
+
+    if (!ok) {
+
+        failures++;
+
+    }
+
+}
+
+int main(void) {
+
+    int i;
+    uint32_t fed_at;
+
+    reset(0);
+    run(10000);
+    check(neutral_calls[DEADMAN_LEFT_DRIVE] == 0 && neutral_calls[DEADMAN_ARM] == 0,
+            "groups never commanded are never neutralized");
+
+    reset(0);
+    for (i = 0; i < 100; i++) {
+
+        roveDeadmanFeed(DEADMAN_LEFT_DRIVE);
+        roveDeadmanFeed(DEADMAN_RIGHT_DRIVE);
+        run(100);
+
+    }
+    check(neutral_calls[DEADMAN_LEFT_DRIVE] == 0 && neutral_calls[DEADMAN_RIGHT_DRIVE] == 0,
+            "commands every 100 ms keep the drive running");
+
+    reset(0);
+    roveDeadmanFeed(DEADMAN_LEFT_DRIVE);
+    fed_at = virtual_ms;
+    run(DEADMAN_WINDOW_MS - DEADMAN_TICK_MS);
+    check(neutral_calls[DEADMAN_LEFT_DRIVE] == 0, "no trip one tick before the window");
+    run(DEADMAN_TICK_MS);
+    check(neutral_at_ms[DEADMAN_LEFT_DRIVE] == fed_at + DEADMAN_WINDOW_MS,
+            "trip exactly one window after the last command");
+    run(5000);
+    check(neutral_calls[DEADMAN_LEFT_DRIVE] == 1 && roveDeadmanIsTripped(DEADMAN_LEFT_DRIVE),
+            "neutral sent once and the group stays tripped");
+    roveDeadmanFeed(DEADMAN_LEFT_DRIVE);
+    check(!roveDeadmanIsTripped(DEADMAN_LEFT_DRIVE), "next command clears the trip");
+    run(DEADMAN_WINDOW_MS);
+    check(neutral_calls[DEADMAN_LEFT_DRIVE] == 2 && roveDeadmanTrips(DEADMAN_LEFT_DRIVE) == 2,
+            "re-armed group trips again");
+
+    reset(0);
+    for (i = 0; i < 20; i++) {
+
+        roveDeadmanFeed(DEADMAN_RIGHT_DRIVE);
+        roveDeadmanFeed(DEADMAN_ARM);
+        run(50);
+
+    }
+    run(100);
+    for (i = 0; i < 10; i++) {
+
+        roveDeadmanFeed(DEADMAN_RIGHT_DRIVE);
+        run(50);
+
+    }
+    check(neutral_calls[DEADMAN_ARM] == 1 && neutral_calls[DEADMAN_RIGHT_DRIVE] == 0,
+            "arm starves while the drive is still commanded");
+
+    reset(0);
+    roveDeadmanSetWindow(DEADMAN_ARM, 0);
+    roveDeadmanFeed(DEADMAN_ARM);
+    run(10000);
+    check(neutral_calls[DEADMAN_ARM] == 0, "window of 0 disables the group");
+
+    reset(0xFFFFFFFF - 100 - ((0xFFFFFFFF - 100) % DEADMAN_TICK_MS));
+    roveDeadmanFeed(DEADMAN_RIGHT_DRIVE);
+    fed_at = virtual_ms;
+    run(DEADMAN_WINDOW_MS - DEADMAN_TICK_MS);
+    check(neutral_calls[DEADMAN_RIGHT_DRIVE] == 0, "no early trip across the 32 bit wrap");
+    run(DEADMAN_TICK_MS);
+    check(neutral_calls[DEADMAN_RIGHT_DRIVE] == 1
+            && neutral_at_ms[DEADMAN_RIGHT_DRIVE] == fed_at + DEADMAN_WINDOW_MS,
+            "on time trip across the 32 bit wrap");
+
+    printf("%d failed\n", failures);
+
+    return failures != 0;
+
+}
@@ -0,0 +1,873 @@
+// fragment_loopback.c MST MRDT
+//
+// Host tests of roveFragment, the long message layer over the base station TCP link and the uarts
+//
+// unit cases first, then both directions end to end, each stage a thread the way the rover runs them:
+//
+//   base to device: the base station sends ROVER_LONG_MESSAGEs over a real TCP socket on 127.0.0.1,
+//   the rover cuts each into fragments as it reads it, as parseLongMessage does, and writes them in
+//   rove serial frames to a socketpair standing in for the uart, and the device puts them back together
+//
+//   device to base: the device sends fragments through a uart that drops and corrupts frames, the rover
+//   puts them back together and queues whole messages in a roveQueue, as roveFragmentLink does, and a
+//   sender thread sends them over TCP to the base station, which checks every byte
+//
+// and prints the throughput of each, and what the fragment and frame headers cost on a 115200 baud uart
+//
+// build and run on a Linux host:
+//
+// 	gcc -O2 -Wall -Wextra -pthread -o fragment_loopback fragment_loopback.c ../../CCS/RoverMotherboard/roveIncludes/roveWareSource/roveFragment.c ../../CCS/RoverMotherboard/roveIncludes/roveWareSource/roveQueue.c ../../CCS/RoverMotherboard/roveIncludes/roveWareSource/roveChecksum.c
+// 	./fragment_loopback
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../../CCS/RoverMotherboard/roveIncludes/roveWareHeaders/roveChecksum.h"
+#include "../../CCS/RoverMotherboard/roveIncludes/roveWareHeaders/roveFragment.h"
+#include "../../CCS/RoverMotherboard/roveIncludes/roveWareHeaders/roveQueue.h"
+
+// same values as mrdtRoveWare.h
+
+#define ROVER_LONG_MESSAGE 0x0D
+#define FRAGMENT_MAX_MESSAGE 512
+#define FRAGMENT_TIMEOUT_MS 250
+#define FRAGMENT_QUEUE_SIZE 1024
+#define SERIAL_FRAME_XOR 0x85
+#define SERIAL_FRAME_HEADER 3
+#define fragment_id 250
+
+// a science bay reading, the struct id the messages go by
+
+#define SCIENCE_ID 160
+
+#define LOOPBACK_MESSAGES 20000
+
+// device to base uart faults, per frame in parts per 10000
+
+#define UART_DROP_IN_10000 50
+#define UART_CORRUPT_IN_10000 50
+
+// how far the messages lost may be from what the bad frames predict, as a fraction of it
+
+#define UPLINK_LOSS_TOLERANCE 0.2
+
+#define UART_BAUD 115200
+
+static int failures = 0;
+
+static void check(int ok, const char* what) {
+
+    if (!ok) {
+
+        printf("FAIL %s\n", what);
+        failures++;
+
+    }
+
+}
+
+static double now_s(void) {
+
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+
+}
+
+static uint32_t now_ms(void) {
+
+    return (uint32_t) (now_s() * 1000);
+
+}
+
+// message n: the struct id, n, then bytes that depend on both, 5 to FRAGMENT_MAX_MESSAGE long
+
+static int makeMessage(uint32_t n, uint8_t* message) {
+
+    int length = 5 + (n * 7919) % (FRAGMENT_MAX_MESSAGE - 4);
+    int i;
+
+    message[0] = SCIENCE_ID;
+    memcpy(message + 1, &n, sizeof(n));
+
+    for (i = 5; i < length; i++) {
+
+        message[i] = (uint8_t) (n * 31 + i * 7);
+
+    }
+
+    return length;
+
+}
+
+// Post: n of the message, -1 if any byte is not what makeMessage made
+
+static long checkMessage(const uint8_t* message, int length) {
+
+    uint8_t expected[FRAGMENT_MAX_MESSAGE];
+    uint32_t n;
+
+    if (length < 5) {
+
+        return -1;
+
+    }
+
+    memcpy(&n, message + 1, sizeof(n));
+
+    if ((makeMessage(n, expected) != length) || (memcmp(expected, message, length) != 0)) {
+
+        return -1;
+
+    }
+
+    return n;
+
+}
+
+static void unitTests(void) {
+
+    static uint8_t message[600];
+    static uint8_t buffer[600];
+    struct fragment_reassembly reassembly;
+    struct fragment_stats stats;
+    struct fragment_struct fragments[32];
+    int count;
+    int length;
+    int index;
+    int result;
+    int i;
+
+    check(roveFragmentCount(0) == 0, "empty message has no fragments");
+    check(roveFragmentCount(1) == 1 && roveFragmentCount(FRAGMENT_DATA_SIZE) == 1, "one fragment");
+    check(roveFragmentCount(FRAGMENT_DATA_SIZE + 1) == 2, "two fragments");
+    check(roveFragmentCount(FRAGMENT_MAX_COUNT * FRAGMENT_DATA_SIZE) == FRAGMENT_MAX_COUNT, "longest message");
+    check(roveFragmentCount(FRAGMENT_MAX_COUNT * FRAGMENT_DATA_SIZE + 1) == 0, "too long to fragment");
+    check(sizeof(struct fragment_struct) == 30, "a fragment fits MAX_TELEM_SIZE");
+
+    // every length, split and put back together
+    for (length = 1; length <= (int) sizeof(message); length++) {
+
+        memset(&stats, 0, sizeof(stats));
+        roveFragmentReassemblyInit(&reassembly, buffer, sizeof(buffer), FRAGMENT_TIMEOUT_MS, &stats);
+
+        for (i = 0; i < length; i++) {
+
+            message[i] = (uint8_t) (length + i * 13);
+
+        }
+
+        count = roveFragmentCount(length);
+        result = FRAGMENT_PENDING;
+
+        for (index = 0; index < count; index++) {
+
+            roveFragmentSplit(&fragments[0], fragment_id, length, index, message, length);
+            roveFragmentCountSent(&stats, &fragments[0]);
+
+            if ((index == count - 1) && ((length % FRAGMENT_DATA_SIZE) != 0)) {
+
+                check(fragments[0].data[FRAGMENT_DATA_SIZE - 1] == 0, "last fragment padded with zeros");
+
+            }
+
+            check(fragments[0].destination == message[0], "destination is the message's struct id");
+            result = roveFragmentAccept(&reassembly, &fragments[0], 0);
+            check(result == ((index == count - 1) ? FRAGMENT_COMPLETE : FRAGMENT_PENDING), "complete on the last");
+
+        }
+
+        check(result == FRAGMENT_COMPLETE && reassembly.total_length == length
+                && memcmp(buffer, message, length) == 0, "message put back together");
+        check(stats.messages_sent == 1 && stats.messages_received == 1 && stats.bytes_sent == (uint32_t) length
+                && stats.bytes_received == (uint32_t) length && stats.fragments_sent == (uint32_t) count
+                && stats.fragments_received == (uint32_t) count && stats.dropped == 0, "round trip counted");
+
+    }
+
+    // 100 bytes: 5 fragments
+    for (i = 0; i < 100; i++) {
+
+        message[i] = i;
+
+    }
+
+    for (index = 0; index < 5; index++) {
+
+        roveFragmentSplit(&fragments[index], fragment_id, 1, index, message, 100);
+
+    }
+
+    // a gap throws the partial message away, and the rest of it after
+    memset(&stats, 0, sizeof(stats));
+    roveFragmentReassemblyInit(&reassembly, buffer, 512, FRAGMENT_TIMEOUT_MS, &stats);
+    check(roveFragmentAccept(&reassembly, &fragments[0], 0) == FRAGMENT_PENDING, "first fragment");
+    check(roveFragmentAccept(&reassembly, &fragments[2], 0) == FRAGMENT_DROPPED, "gap drops");
+    check(roveFragmentAccept(&reassembly, &fragments[3], 0) == FRAGMENT_DROPPED, "rest of it dropped");
+    check(stats.dropped == 3 && stats.messages_received == 0, "gap counted");
+
+    // a new message replaces a partial one
+    roveFragmentAccept(&reassembly, &fragments[0], 0);
+    roveFragmentAccept(&reassembly, &fragments[1], 0);
+    roveFragmentSplit(&fragments[5], fragment_id, 2, 0, message, 10);
+    check(roveFragmentAccept(&reassembly, &fragments[5], 0) == FRAGMENT_COMPLETE, "new message completes");
+    check(stats.dropped == 5 && memcmp(buffer, message, 10) == 0, "partial one counted dropped");
+
+    // same index and length from another message
+    roveFragmentAccept(&reassembly, &fragments[0], 0);
+    roveFragmentSplit(&fragments[6], fragment_id, 9, 1, message, 100);
+    check(roveFragmentAccept(&reassembly, &fragments[6], 0) == FRAGMENT_DROPPED, "other message id dropped");
+
+    // a stall longer than the timeout, the clock wrapping underneath
+    memset(&stats, 0, sizeof(stats));
+    roveFragmentReassemblyInit(&reassembly, buffer, 512, FRAGMENT_TIMEOUT_MS, &stats);
+    roveFragmentAccept(&reassembly, &fragments[0], 0xFFFFFF00);
+    check(roveFragmentAccept(&reassembly, &fragments[1], 0xFFFFFF00 + FRAGMENT_TIMEOUT_MS) == FRAGMENT_PENDING,
+            "in time across the wrap");
+    check(!roveFragmentExpire(&reassembly, 0xFFFFFF00 + 2 * FRAGMENT_TIMEOUT_MS), "not expired yet");
+    check(roveFragmentExpire(&reassembly, 0xFFFFFF00 + 2 * FRAGMENT_TIMEOUT_MS + 1), "expired");
+    check(stats.timeouts == 1 && stats.dropped == 2, "timeout counted");
+    roveFragmentAccept(&reassembly, &fragments[0], 0);
+    check(roveFragmentAccept(&reassembly, &fragments[1], FRAGMENT_TIMEOUT_MS + 1) == FRAGMENT_DROPPED,
+            "late fragment dropped");
+    check(stats.timeouts == 2, "late fragment times the message out");
+
+    // longer than the buffer, and an index past the end
+    roveFragmentReassemblyInit(&reassembly, buffer, 64, FRAGMENT_TIMEOUT_MS, &stats);
+    check(roveFragmentAccept(&reassembly, &fragments[0], 0) == FRAGMENT_DROPPED, "too long for the buffer");
+    fragments[5].index = 3;
+    check(roveFragmentAccept(&reassembly, &fragments[5], 0) == FRAGMENT_DROPPED, "index past the end");
+
+}
+
+// the uart: rove serial frames on a socketpair
+
+struct uart {
+
+    int fd;
+    uint32_t drop_in_10000;
+    uint32_t corrupt_in_10000;
+    unsigned seed;
+    uint64_t wire_bytes;
+    uint32_t dropped;
+    uint32_t corrupted;
+
+};
+
+static void writeAll(int fd, const void* data, size_t length) {
+
+    const uint8_t* bytes = data;
+    ssize_t wrote;
+
+    while (length > 0) {
+
+        wrote = write(fd, bytes, length);
+
+        if (wrote <= 0) {
+
+            return;
+
+        }
+
+        bytes += wrote;
+        length -= wrote;
+
+    }
+
+}
+
+static int readAll(int fd, void* data, size_t length) {
+
+    uint8_t* bytes = data;
+    ssize_t got;
+
+    while (length > 0) {
+
+        got = read(fd, bytes, length);
+
+        if (got <= 0) {
+
+            return -1;
+
+        }
+
+        bytes += got;
+        length -= got;
+
+    }
+
+    return 0;
+
+}
+
+static void uartWrite(struct uart* uart, const struct fragment_struct* fragment) {
+
+    uint8_t frame[SERIAL_FRAME_HEADER + sizeof(*fragment) + 1];
+    uint8_t size = sizeof(*fragment);
+
+    frame[0] = 0x06;
+    frame[1] = SERIAL_FRAME_XOR;
+    frame[2] = size;
+    memcpy(frame + SERIAL_FRAME_HEADER, fragment, size);
+    frame[SERIAL_FRAME_HEADER + size] = roveChecksumXor(fragment, size, size);
+
+    uart->wire_bytes += sizeof(frame);
+
+    if ((uint32_t) (rand_r(&uart->seed) % 10000) < uart->drop_in_10000) {
+
+        uart->dropped++;
+        return;
+
+    }
+
+    if ((uint32_t) (rand_r(&uart->seed) % 10000) < uart->corrupt_in_10000) {
+
+        frame[rand_r(&uart->seed) % sizeof(frame)] ^= 1 << (rand_r(&uart->seed) % 8);
+        uart->corrupted++;
+
+    }
+
+    writeAll(uart->fd, frame, sizeof(frame));
+
+}
+
+// recvSerialStructMessage: find the start byte, check the version and the checksum.
+// Post: 1 with a struct of size bytes in buffer, 0 for a bad frame, -1 once the uart is closed
+
+static int uartRead(struct uart* uart, uint8_t buffer[64], int* size) {
+
+    uint8_t byte;
+    uint8_t length;
+
+    do {
+
+        if (readAll(uart->fd, &byte, 1) < 0) {
+
+            return -1;
+
+        }
+
+    } while (byte != 0x06);
+
+    if ((readAll(uart->fd, &byte, 1) < 0) || (readAll(uart->fd, &length, 1) < 0)) {
+
+        return -1;
+
+    }
+
+    if ((byte != SERIAL_FRAME_XOR) || (length == 0) || (length > 40)) {
+
+        return 0;
+
+    }
+
+    if (readAll(uart->fd, buffer, length + 1) < 0) {
+
+        return -1;
+
+    }
+
+    *size = length;
+
+    return roveChecksumXor(buffer, length, length) == buffer[length];
+
+}
+
+static int tcpPair(int* client, int* server) {
+
+    struct sockaddr_in address;
+    socklen_t address_size = sizeof(address);
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if ((bind(listener, (struct sockaddr*) &address, sizeof(address)) < 0) || (listen(listener, 1) < 0)
+            || (getsockname(listener, (struct sockaddr*) &address, &address_size) < 0)) {
+
+        return -1;
+
+    }
+
+    *client = socket(AF_INET, SOCK_STREAM, 0);
+
+    if (connect(*client, (struct sockaddr*) &address, sizeof(address)) < 0) {
+
+        return -1;
+
+    }
+
+    *server = accept(listener, NULL, NULL);
+    close(listener);
+
+    // small messages one at a time, like the rover's sends
+    setsockopt(*client, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    setsockopt(*server, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    return (*server < 0) ? -1 : 0;
+
+}
+
+// base station to device
+
+struct downlink {
+
+    int base_fd;
+    int rover_fd;
+    struct uart uart;
+    int device_fd;
+    struct fragment_stats rover_stats;
+    struct fragment_stats device_stats;
+    uint64_t message_bytes;
+    long delivered;
+    long bad;
+
+};
+
+static void* downlinkBase(void* arg) {
+
+    struct downlink* link = arg;
+    uint8_t frame[3 + FRAGMENT_MAX_MESSAGE];
+    uint16_t length;
+    uint32_t n;
+
+    for (n = 0; n < LOOPBACK_MESSAGES; n++) {
+
+        length = makeMessage(n, frame + 3);
+        frame[0] = ROVER_LONG_MESSAGE;
+        memcpy(frame + 1, &length, sizeof(length));
+        writeAll(link->base_fd, frame, 3 + length);
+        link->message_bytes += length;
+
+    }
+
+    shutdown(link->base_fd, SHUT_WR);
+
+    return NULL;
+
+}
+
+// parseLongMessage and the fragment_id case of roveCmdCntrl
+
+static void* downlinkRover(void* arg) {
+
+    struct downlink* link = arg;
+    struct fragment_struct fragment;
+    uint8_t message_id = 0;
+    uint8_t type;
+    uint8_t destination;
+    uint16_t total_length;
+    uint8_t* data;
+    int count;
+    int index;
+    int length;
+
+    while ((readAll(link->rover_fd, &type, 1) == 0) && (type == ROVER_LONG_MESSAGE)) {
+
+        if ((readAll(link->rover_fd, &total_length, sizeof(total_length)) < 0)
+                || (readAll(link->rover_fd, &destination, 1) < 0)) {
+
+            break;
+
+        }
+
+        count = roveFragmentCount(total_length);
+        message_id++;
+
+        for (index = 0; index < count; index++) {
+
+            length = roveFragmentPrepare(&fragment, fragment_id, destination, message_id, index, total_length);
+            data = fragment.data;
+
+            if (index == 0) {
+
+                *data++ = destination;
+                length--;
+
+            }
+
+            if ((length > 0) && (readAll(link->rover_fd, data, length) < 0)) {
+
+                break;
+
+            }
+
+            uartWrite(&link->uart, &fragment);
+            roveFragmentCountSent(&link->rover_stats, &fragment);
+
+        }
+
+    }
+
+    shutdown(link->uart.fd, SHUT_WR);
+
+    return NULL;
+
+}
+
+static void* downlinkDevice(void* arg) {
+
+    struct downlink* link = arg;
+    static uint8_t buffer[FRAGMENT_MAX_MESSAGE];
+    struct fragment_reassembly reassembly;
+    struct uart uart;
+    struct fragment_struct fragment;
+    uint8_t frame[64];
+    long expected = 0;
+    int size;
+    int result;
+
+    memset(&uart, 0, sizeof(uart));
+    uart.fd = link->device_fd;
+
+    roveFragmentReassemblyInit(&reassembly, buffer, sizeof(buffer), FRAGMENT_TIMEOUT_MS, &link->device_stats);
+
+    while ((result = uartRead(&uart, frame, &size)) >= 0) {
+
+        if (!result || (frame[0] != fragment_id) || (size != sizeof(fragment))) {
+
+            link->bad++;
+            continue;
+
+        }
+
+        memcpy(&fragment, frame, sizeof(fragment));
+
+        if (roveFragmentAccept(&reassembly, &fragment, now_ms()) == FRAGMENT_COMPLETE) {
+
+            if (checkMessage(buffer, reassembly.total_length) != expected) {
+
+                link->bad++;
+
+            }
+
+            expected++;
+            link->delivered++;
+
+        }
+
+    }
+
+    return NULL;
+
+}
+
+// device to base station
+
+struct uplink {
+
+    struct uart uart;
+    int rover_fd;
+    int sender_fd;
+    int base_fd;
+    struct fragment_stats device_stats;
+    struct fragment_stats rover_stats;
+    uint8_t queue_buffer[FRAGMENT_QUEUE_SIZE];
+    struct rove_queue queue;
+    volatile int rover_done;
+    uint64_t message_bytes;
+    long delivered;
+    long bad;
+
+    // messages the uart faults should cost: one is lost if any of its frames is bad
+    double expected_lost;
+
+};
+
+static void* uplinkDevice(void* arg) {
+
+    struct uplink* link = arg;
+    uint8_t message[FRAGMENT_MAX_MESSAGE];
+    struct fragment_struct fragment;
+    double frame_good;
+    double message_good;
+    uint32_t n;
+    int length;
+    int index;
+
+    // a frame is dropped, or else it may be corrupted
+    frame_good = (1 - link->uart.drop_in_10000 / 10000.0) * (1 - link->uart.corrupt_in_10000 / 10000.0);
+
+    for (n = 0; n < LOOPBACK_MESSAGES; n++) {
+
+        length = makeMessage(n, message);
+        message_good = 1;
+
+        for (index = 0; index < roveFragmentCount(length); index++) {
+
+            roveFragmentSplit(&fragment, fragment_id, (uint8_t) n, index, message, length);
+            uartWrite(&link->uart, &fragment);
+            roveFragmentCountSent(&link->device_stats, &fragment);
+            message_good *= frame_good;
+
+        }
+
+        link->expected_lost += 1 - message_good;
+
+    }
+
+    shutdown(link->uart.fd, SHUT_WR);
+
+    return NULL;
+
+}
+
+// roveTelemCntrl and roveFragmentLinkReceive
+
+static void* uplinkRover(void* arg) {
+
+    struct uplink* link = arg;
+    static uint8_t buffer[FRAGMENT_MAX_MESSAGE];
+    struct fragment_reassembly reassembly;
+    struct uart uart;
+    struct fragment_struct fragment;
+    uint8_t frame[64];
+    int size;
+    int result;
+
+    memset(&uart, 0, sizeof(uart));
+    uart.fd = link->rover_fd;
+
+    roveFragmentReassemblyInit(&reassembly, buffer, sizeof(buffer), FRAGMENT_TIMEOUT_MS, &link->rover_stats);
+
+    while ((result = uartRead(&uart, frame, &size)) >= 0) {
+
+        // a bad frame never gets past recvSerialStructMessage
+        if (!result || (frame[0] != fragment_id)) {
+
+            continue;
+
+        }
+
+        memcpy(&fragment, frame, sizeof(fragment));
+
+        if (roveFragmentAccept(&reassembly, &fragment, now_ms()) == FRAGMENT_COMPLETE) {
+
+            while (!roveQueuePush(&link->queue, NULL, 0, buffer, reassembly.total_length)) {
+
+                usleep(100);
+
+            }
+
+        }
+
+    }
+
+    link->rover_done = 1;
+
+    return NULL;
+
+}
+
+// roveTcpSender
+
+static void* uplinkSender(void* arg) {
+
+    struct uplink* link = arg;
+    uint8_t frame[3 + FRAGMENT_MAX_MESSAGE];
+    uint16_t length;
+    int size;
+    int done;
+
+    for (;;) {
+
+        done = link->rover_done;
+
+        while ((size = roveQueuePop(&link->queue, NULL, 0, frame + 3, FRAGMENT_MAX_MESSAGE)) >= 0) {
+
+            length = size;
+            frame[0] = ROVER_LONG_MESSAGE;
+            memcpy(frame + 1, &length, sizeof(length));
+            writeAll(link->sender_fd, frame, 3 + length);
+
+        }
+
+        if (done) {
+
+            break;
+
+        }
+
+        usleep(100);
+
+    }
+
+    shutdown(link->sender_fd, SHUT_WR);
+
+    return NULL;
+
+}
+
+static void* uplinkBase(void* arg) {
+
+    struct uplink* link = arg;
+    uint8_t message[FRAGMENT_MAX_MESSAGE];
+    uint8_t type;
+    uint16_t length;
+    long last = -1;
+    long n;
+
+    while ((readAll(link->base_fd, &type, 1) == 0) && (readAll(link->base_fd, &length, sizeof(length)) == 0)) {
+
+        if ((type != ROVER_LONG_MESSAGE) || (length > sizeof(message)) || (readAll(link->base_fd, message, length) < 0)) {
+
+            link->bad++;
+            break;
+
+        }
+
+        n = checkMessage(message, length);
+
+        if (n <= last) {
+
+            link->bad++;
+
+        } else {
+
+            last = n;
+
+        }
+
+        link->delivered++;
+        link->message_bytes += length;
+
+    }
+
+    return NULL;
+
+}
+
+static double wireSeconds(uint64_t wire_bytes) {
+
+    // 8N1: ten bits a byte
+    return wire_bytes * 10.0 / UART_BAUD;
+
+}
+
+static void downlinkTest(void) {
+
+    static struct downlink link;
+    pthread_t base, rover, device;
+    int uart[2];
+    double start;
+    double elapsed;
+
+    memset(&link, 0, sizeof(link));
+
+    check(tcpPair(&link.base_fd, &link.rover_fd) == 0, "tcp loopback");
+    check(socketpair(AF_UNIX, SOCK_STREAM, 0, uart) == 0, "uart socketpair");
+    link.uart.fd = uart[0];
+    link.device_fd = uart[1];
+
+    start = now_s();
+    pthread_create(&device, NULL, downlinkDevice, &link);
+    pthread_create(&rover, NULL, downlinkRover, &link);
+    pthread_create(&base, NULL, downlinkBase, &link);
+    pthread_join(base, NULL);
+    pthread_join(rover, NULL);
+    pthread_join(device, NULL);
+    elapsed = now_s() - start;
+
+    check(link.delivered == LOOPBACK_MESSAGES && link.bad == 0, "every message reaches the device intact, in order");
+    check(link.rover_stats.messages_sent == LOOPBACK_MESSAGES
+            && link.rover_stats.bytes_sent == link.message_bytes, "rover counts what it sent");
+    check(link.device_stats.fragments_received == link.rover_stats.fragments_sent
+            && link.device_stats.bytes_received == link.message_bytes, "device counts what it got");
+
+    printf("base to device: %ld messages, %.1f KB in %d fragments\n", link.delivered,
+            link.message_bytes / 1024.0, link.rover_stats.fragments_sent);
+    printf("  host loopback %.0f messages/s, %.2f MB/s\n", link.delivered / elapsed,
+            link.message_bytes / elapsed / 1e6);
+    printf("  at %d baud %.0f bytes/s of message, %.0f%% of the uart (the rest is fragment and frame headers "
+            "and padding)\n", UART_BAUD, link.message_bytes / wireSeconds(link.uart.wire_bytes),
+            100.0 * link.message_bytes / link.uart.wire_bytes);
+
+    close(link.base_fd);
+    close(link.rover_fd);
+    close(uart[0]);
+    close(uart[1]);
+
+}
+
+static void uplinkTest(void) {
+
+    static struct uplink link;
+    pthread_t base, sender, rover, device;
+    int uart[2];
+    double start;
+    double elapsed;
+    long lost;
+
+    memset(&link, 0, sizeof(link));
+
+    check(tcpPair(&link.base_fd, &link.sender_fd) == 0, "tcp loopback");
+    check(socketpair(AF_UNIX, SOCK_STREAM, 0, uart) == 0, "uart socketpair");
+    link.uart.fd = uart[0];
+    link.uart.drop_in_10000 = UART_DROP_IN_10000;
+    link.uart.corrupt_in_10000 = UART_CORRUPT_IN_10000;
+    link.uart.seed = 1;
+    link.rover_fd = uart[1];
+    roveQueueInit(&link.queue, link.queue_buffer, FRAGMENT_QUEUE_SIZE, NULL, NULL);
+
+    start = now_s();
+    pthread_create(&base, NULL, uplinkBase, &link);
+    pthread_create(&sender, NULL, uplinkSender, &link);
+    pthread_create(&rover, NULL, uplinkRover, &link);
+    pthread_create(&device, NULL, uplinkDevice, &link);
+    pthread_join(device, NULL);
+    pthread_join(rover, NULL);
+    pthread_join(sender, NULL);
+    pthread_join(base, NULL);
+    elapsed = now_s() - start;
+
+    lost = LOOPBACK_MESSAGES - link.delivered;
+
+    check(link.bad == 0, "every message that reaches the base station is intact and in order");
+    check(link.delivered == (long) link.rover_stats.messages_received, "every message put together is sent");
+    check(lost > 0 && lost <= (long) (link.uart.dropped + link.uart.corrupted), "a message lost per bad frame at most");
+
+    // nothing lost beyond the bad frames: about 11 frames a message at 1% bad frames loses
+    // around 10% of them. One standard deviation is about 45 messages, 2% of the expected loss
+    check(lost >= link.expected_lost * (1 - UPLINK_LOSS_TOLERANCE)
+            && lost <= link.expected_lost * (1 + UPLINK_LOSS_TOLERANCE), "loss as the bad frames predict");
+    check(link.rover_stats.bytes_received == link.message_bytes, "rover counts what it put together");
+
+    printf("device to base, %.1f%% of frames dropped and %.1f%% corrupted: %ld of %d messages, %d lost\n",
+            UART_DROP_IN_10000 / 100.0, UART_CORRUPT_IN_10000 / 100.0, link.delivered, LOOPBACK_MESSAGES, (int) lost);
+    printf("  %.1f%% of messages lost, %.1f%% expected from the bad frames\n", 100.0 * lost / LOOPBACK_MESSAGES,
+            100.0 * link.expected_lost / LOOPBACK_MESSAGES);
+    printf("  %u fragments dropped by the rover, %u messages timed out\n", link.rover_stats.dropped,
+            link.rover_stats.timeouts);
+    printf("  host loopback %.0f messages/s, %.2f MB/s\n", link.delivered / elapsed,
+            link.message_bytes / elapsed / 1e6);
+
+    close(link.base_fd);
+    close(link.sender_fd);
+    close(uart[0]);
+    close(uart[1]);
+
+}
+
+int main(void) {
+
+    unitTests();
+    downlinkTest();
+    uplinkTest();
+
+    printf("%s\n", failures ? "FAILED" : "all passed");
+
+    return failures ? 1 : 0;
+
+}
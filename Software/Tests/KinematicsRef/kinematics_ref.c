@@ -0,0 +1,191 @@
+// kinematics_ref.c MST MRDT
+//
+// Checks the fixed point roveKinematics against a floating point reference on a host
+//
+// sweeps linear and angular setpoints well past what the wheels can do, with unity and
+// uneven trims, and checks every wheel command against the reference, that nothing passes
+// full scale, and that saturation slows the rover down without changing the turn radius
+//
+// build and run on a Linux host:
+//
+// 	gcc -Wall -o kinematics_ref kinematics_ref.c ../../CCS/RoverMotherboard/roveIncludes/roveWareSource/roveKinematics.c -lm
+// 	./kinematics_ref
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../../CCS/RoverMotherboard/roveIncludes/roveWareHeaders/roveKinematics.h"
+
+// same values as mrdtRoveWare.h
+
+#define KINEMATICS_TRACK_WIDTH_MM 760
+#define KINEMATICS_MAX_WHEEL_SPEED_MM_S 1500
+
+static const int8_t directions[KINEMATICS_WHEEL_COUNT] = { -1, -1, 1, -1, 1, -1 };
+
+// fixed point truncates at the side speed, the trim and the saturation, so up to
+// three counts out of 1000 is expected
+
+#define MAX_ERROR_COUNTS 3
+
+static void referenceTwist(const struct kinematics_config* config, double linear,
+        double angular, double wheel[KINEMATICS_WHEEL_COUNT]) {
+
+    double turn = angular / 1000.0 * config->track_width_mm / 2.0;
+    double right = (linear + turn) / config->max_wheel_speed_mm_s * 1000.0;
+    double left = (linear - turn) / config->max_wheel_speed_mm_s * 1000.0;
+    double largest = 0.0;
+    int i;
+
+    for (i = 0; i < KINEMATICS_WHEEL_COUNT; i++) {
+
+        wheel[i] = ((i < KINEMATICS_LEFT_FIRST) ? right : left) * config->trim_q12[i] / 4096.0;
+
+        if (fabs(wheel[i]) > largest) {
+
+            largest = fabs(wheel[i]);
+
+        }
+
+    }
+
+    for (i = 0; i < KINEMATICS_WHEEL_COUNT; i++) {
+
+        if (largest > 1000.0) {
+
+            wheel[i] *= 1000.0 / largest;
+
+        }
+
+        wheel[i] *= config->direction[i];
+
+    }
+
+}
+
+static int sweep(const char* name, const uint16_t trims[KINEMATICS_WHEEL_COUNT]) {
+
+    struct kinematics_config config;
+    double expected[KINEMATICS_WHEEL_COUNT];
+    int16_t wheel[KINEMATICS_WHEEL_COUNT];
+    double error;
+    double worst_error = 0.0;
+    double worst_turn_error = 0.0;
+    double turn;
+    double asked_right;
+    double asked_left;
+    double right;
+    double left;
+    int32_t linear;
+    int32_t angular;
+    int saturated = 0;
+    int cases = 0;
+    int over_scale = 0;
+    int i;
+
+    config.track_width_mm = KINEMATICS_TRACK_WIDTH_MM;
+    config.max_wheel_speed_mm_s = KINEMATICS_MAX_WHEEL_SPEED_MM_S;
+
+    for (i = 0; i < KINEMATICS_WHEEL_COUNT; i++) {
+
+        config.direction[i] = directions[i];
+        config.trim_q12[i] = trims[i];
+
+    }
+
+    roveKinematicsConfigure(&config);
+
+    for (linear = -3000; linear <= 3000; linear += 25) {
+
+        for (angular = -8000; angular <= 8000; angular += 50) {
+
+            roveKinematicsTwist(linear, angular, wheel);
+            referenceTwist(&config, linear, angular, expected);
+            cases++;
+
+            for (i = 0; i < KINEMATICS_WHEEL_COUNT; i++) {
+
+                error = fabs(wheel[i] - expected[i]);
+
+                if (error > worst_error) {
+
+                    worst_error = error;
+
+                }
+
+                if (abs(wheel[i]) > 1000) {
+
+                    over_scale++;
+
+                }
+
+            }
+
+            // the turn radius is set by the ratio of the sides: compare what came out (trim and
+            // direction taken off) with what was asked for before any saturation
+            turn = angular / 1000.0 * config.track_width_mm / 2.0;
+            asked_right = (linear + turn) / config.max_wheel_speed_mm_s * 1000.0;
+            asked_left = (linear - turn) / config.max_wheel_speed_mm_s * 1000.0;
+
+            right = wheel[1] * (double) config.direction[1] * 4096.0 / trims[1];
+            left = wheel[4] * (double) config.direction[4] * 4096.0 / trims[4];
+
+            if (fabs(asked_right * trims[1] / 4096.0) > 1000.0
+                    || fabs(asked_left * trims[4] / 4096.0) > 1000.0) {
+
+                saturated++;
+
+            }
+
+            // right / left == asked_right / asked_left, cross multiplied and scaled back to counts
+            error = fabs(right * asked_left - left * asked_right)
+                    / fmax(fmax(fabs(asked_right), fabs(asked_left)), 1.0);
+
+            if (error > worst_turn_error) {
+
+                worst_turn_error = error;
+
+            }
+
+        }
+
+    }
+
+    printf("%-14s %6d cases, %5d saturated, worst wheel error %.2f counts, worst turn error %.2f counts, %d over full scale\n",
+            name, cases, saturated, worst_error, worst_turn_error, over_scale);
+
+    return (worst_error <= MAX_ERROR_COUNTS) && (worst_turn_error <= 2 * MAX_ERROR_COUNTS)
+            && (over_scale == 0);
+
+}
+
+int main(void) {
+
+    static const uint16_t unity[KINEMATICS_WHEEL_COUNT] = { 4096, 4096, 4096, 4096, 4096, 4096 };
+    static const uint16_t uneven[KINEMATICS_WHEEL_COUNT] = { 4300, 3900, 4096, 4500, 3700, 4096 };
+
+    int16_t wheel[KINEMATICS_WHEEL_COUNT];
+    struct kinematics_config config = { KINEMATICS_TRACK_WIDTH_MM, KINEMATICS_MAX_WHEEL_SPEED_MM_S,
+            { -1, -1, 1, -1, 1, -1 }, { 4096, 4096, 4096, 4096, 4096, 4096 } };
+    int ok = 1;
+
+    ok &= sweep("unity trim", unity);
+    ok &= sweep("uneven trim", uneven);
+
+    // the old left / right messages: one side alone, clamped
+    roveKinematicsConfigure(&config);
+    ok &= (roveKinematicsWheel(0, 1500) == -1000) && (roveKinematicsWheel(2, 1500) == 1000)
+            && (roveKinematicsWheel(4, -250) == -250) && (roveKinematicsWheel(5, -250) == 250);
+
+    // half speed forward, then spinning in place
+    roveKinematicsTwist(750, 0, wheel);
+    ok &= (wheel[0] == -500) && (wheel[2] == 500) && (wheel[3] == -500) && (wheel[4] == 500);
+    roveKinematicsTwist(0, 1000, wheel);
+    ok &= (wheel[0] == -253) && (wheel[3] == 253);
+
+    printf("%s\n", ok ? "PASS" : "FAIL");
+
+    return !ok;
+
+}
@@ -0,0 +1,296 @@
+// motion_profile_sim.c MST MRDT
+//
+// Runs roveMotionProfile against a simulated drive motor on a host
+//
+// the plant is a brushed motor behind an ESC on the 24 V pack: the ESC puts command / 1000 of
+// the pack across the winding, current is (V - back emf) / R, and the wheel spins up against its
+// inertia. A full reversal with the profile off shows the current spike that browns out the power
+// board, then the same reversal and a random command stream with the profile on are checked for
+// accel / jerk limits, overshoot and settling
+//
+// build and run on a Linux host:
+//
+// 	gcc -O2 -Wall -o motion_profile_sim motion_profile_sim.c ../../CCS/RoverMotherboard/roveIncludes/roveWareSource/roveMotionProfile.c -lm
+// 	./motion_profile_sim
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../../CCS/RoverMotherboard/roveIncludes/roveWareHeaders/roveMotionProfile.h"
+
+// same values as mrdtRoveWare.h
+
+#define MOTION_PROFILE_RATE_HZ 500
+#define MOTION_ACCEL_LIMIT 2000
+#define MOTION_JERK_LIMIT 20000
+
+// plant
+
+#define PACK_VOLTS 24.0
+#define WINDING_OHMS 0.2
+#define MOTOR_K 0.05 		// V per rad/s and N m per A
+#define INERTIA 0.002 		// kg m^2 at the motor shaft
+#define FRICTION 0.0005 	// N m per rad/s
+#define PLANT_STEPS 10 		// plant sub steps per profile tick
+
+struct plant {
+
+    double omega;
+    double current;
+
+};
+
+static double plantStep(struct plant* motor, int command, double dt) {
+
+    double volts = command / 1000.0 * PACK_VOLTS;
+
+    motor->current = (volts - MOTOR_K * motor->omega) / WINDING_OHMS;
+    motor->omega += (MOTOR_K * motor->current - FRICTION * motor->omega) / INERTIA * dt;
+
+    return fabs(motor->current);
+
+}
+
+// accel and jerk are measured on the profile's own Q16 speed, one tick apart, so they are
+// exact: the whole unit rounding of the output never enters into it
+
+static int32_t last_speed = 0;
+static int32_t last_change = 0;
+static int measured_ticks = 0;
+
+static void clearHistory(void) {
+
+    measured_ticks = 0;
+
+}
+
+// runs one motor for ticks profile ticks from the current state, returns the peak current
+
+static double run(int motor, struct plant* plant, int ticks, int16_t* last,
+        double* worst_accel, double* worst_jerk, int* peak_speed) {
+
+    double dt = 1.0 / MOTION_PROFILE_RATE_HZ;
+    double peak = 0.0;
+    double current;
+    double accel;
+    double jerk;
+    int32_t speed;
+    int32_t change;
+    int16_t output;
+    int tick;
+    int step;
+
+    for (tick = 0; tick < ticks; tick++) {
+
+        roveMotionProfileStep(motor, &output);
+
+        speed = roveMotionProfileSpeed(motor);
+        change = speed - last_speed;
+
+        if (measured_ticks >= 1) {
+
+            accel = fabs((double) change) * MOTION_PROFILE_RATE_HZ / 65536.0;
+
+            if (accel > *worst_accel) {
+
+                *worst_accel = accel;
+
+            }
+
+        }
+
+        if (measured_ticks >= 2) {
+
+            jerk = fabs((double) (change - last_change)) * MOTION_PROFILE_RATE_HZ
+                    * MOTION_PROFILE_RATE_HZ / 65536.0;
+
+            if (jerk > *worst_jerk) {
+
+                *worst_jerk = jerk;
+
+            }
+
+        }
+
+        last_speed = speed;
+        last_change = change;
+        measured_ticks++;
+
+        if (abs(output) > *peak_speed) {
+
+            *peak_speed = abs(output);
+
+        }
+
+        *last = output;
+
+        for (step = 0; step < PLANT_STEPS; step++) {
+
+            current = plantStep(plant, output, dt / PLANT_STEPS);
+
+            if (current > peak) {
+
+                peak = current;
+
+            }
+
+        }
+
+    }
+
+    return peak;
+
+}
+
+static int settleTicks(int motor, int16_t target, int limit) {
+
+    int16_t output = 0;
+    int tick;
+
+    roveMotionProfileSetTarget(motor, target);
+
+    for (tick = 0; tick < limit; tick++) {
+
+        roveMotionProfileStep(motor, &output);
+
+        if (output > target) {
+
+            printf("overshoot to %d\n", output);
+            return -1;
+
+        }
+
+        if (output == target) {
+
+            return tick + 1;
+
+        }
+
+    }
+
+    return -1;
+
+}
+
+int main(void) {
+
+    struct plant plant = { 0.0, 0.0 };
+    double worst_accel = 0.0;
+    double worst_jerk = 0.0;
+    double stepped_peak;
+    double profiled_peak;
+    int peak_speed = 0;
+    int16_t last = 0;
+    int16_t output;
+    int ticks;
+    int ok = 1;
+    int i;
+    uint32_t value;
+    clock_t start;
+    double ns_per_tick;
+
+    // integer square root against the C library
+    for (i = 0; i < 1000000; i++) {
+
+        value = ((uint32_t) rand() << 16) ^ (uint32_t) rand();
+
+        if (roveIsqrt64((uint64_t) value * value) != value
+                || roveIsqrt64((uint64_t) value * value + 2 * (uint64_t) value) != value) {
+
+            printf("FAIL  isqrt at %u\n", value);
+            ok = 0;
+            break;
+
+        }
+
+    }
+
+    // profile off: a full reversal is one step
+    roveMotionProfileConfigure(0, 0, 0, MOTION_PROFILE_RATE_HZ);
+    roveMotionProfileSetTarget(0, 1000);
+    run(0, &plant, 2 * MOTION_PROFILE_RATE_HZ, &last, &worst_accel, &worst_jerk, &peak_speed);
+    roveMotionProfileSetTarget(0, -1000);
+    stepped_peak = run(0, &plant, 2 * MOTION_PROFILE_RATE_HZ, &last, &worst_accel, &worst_jerk,
+            &peak_speed);
+
+    // profile on: same reversal
+    plant.omega = 0.0;
+    last = 0;
+    clearHistory();
+    roveMotionProfileHalt(0);
+    roveMotionProfileConfigure(0, MOTION_ACCEL_LIMIT, MOTION_JERK_LIMIT, MOTION_PROFILE_RATE_HZ);
+    roveMotionProfileSetTarget(0, 1000);
+    worst_accel = 0.0;
+    worst_jerk = 0.0;
+    peak_speed = 0;
+    run(0, &plant, 2 * MOTION_PROFILE_RATE_HZ, &last, &worst_accel, &worst_jerk, &peak_speed);
+    roveMotionProfileSetTarget(0, -1000);
+    profiled_peak = run(0, &plant, 3 * MOTION_PROFILE_RATE_HZ, &last, &worst_accel, &worst_jerk,
+            &peak_speed);
+
+    printf("full reversal peak current: %.0f A stepped, %.0f A profiled\n", stepped_peak,
+            profiled_peak);
+    ok &= (last == -1000) && (profiled_peak < stepped_peak / 2);
+
+    // random commands, including reversals mid ramp
+    srand(42);
+    for (i = 0; i < 2000; i++) {
+
+        roveMotionProfileSetTarget(0, (int16_t) (rand() % 2001 - 1000));
+        run(0, &plant, 1 + rand() % 400, &last, &worst_accel, &worst_jerk, &peak_speed);
+
+    }
+
+    printf("worst accel %.0f /s (limit %d), worst jerk %.0f /s^2 (limit %d), peak speed %d\n",
+            worst_accel, MOTION_ACCEL_LIMIT, worst_jerk, MOTION_JERK_LIMIT, peak_speed);
+    ok &= (worst_accel <= MOTION_ACCEL_LIMIT);
+    ok &= (worst_jerk <= MOTION_JERK_LIMIT);
+    ok &= (peak_speed <= 1000);
+
+    // settles exactly, without overshoot
+    roveMotionProfileHalt(0);
+    ticks = settleTicks(0, 1000, 5 * MOTION_PROFILE_RATE_HZ);
+    printf("0 to 1000 settles in %d ms (%.0f ms at the accel limit alone)\n",
+            ticks * 1000 / MOTION_PROFILE_RATE_HZ, 1000.0 * 1000 / MOTION_ACCEL_LIMIT);
+    ok &= (ticks > 0);
+
+    for (i = 0; i < MOTION_PROFILE_RATE_HZ; i++) {
+
+        roveMotionProfileStep(0, &output);
+        ok &= (output == 1000);
+
+    }
+
+    // cost: all six motors ramping, as at 500 Hz on the rover
+    for (i = 0; i < MOTION_PROFILE_MOTORS; i++) {
+
+        roveMotionProfileConfigure(i, MOTION_ACCEL_LIMIT, MOTION_JERK_LIMIT, MOTION_PROFILE_RATE_HZ);
+
+    }
+
+    start = clock();
+    for (ticks = 0; ticks < 200000; ticks++) {
+
+        for (i = 0; i < MOTION_PROFILE_MOTORS; i++) {
+
+            if ((ticks % 500) == 0) {
+
+                roveMotionProfileSetTarget(i, (ticks / 500) % 2 ? 1000 : -1000);
+
+            }
+
+            roveMotionProfileStep(i, &output);
+
+        }
+
+    }
+    ns_per_tick = (double) (clock() - start) / CLOCKS_PER_SEC * 1e9 / 200000;
+    printf("six motor tick: %.0f ns on this host\n", ns_per_tick);
+
+    printf("%s\n", ok ? "PASS" : "FAIL");
+
+    return !ok;
+
+}
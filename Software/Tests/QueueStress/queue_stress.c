@@ -0,0 +1,408 @@
+// queue_stress.c MST MRDT
+//
+// Host tests of roveQueue, the command queue between roveTcpHandler and roveCmdCntrl
+//
+// unit cases first, then a producer and a consumer thread pushing a few million records of
+// random length through a small ring while the consumer checks every byte, then throughput
+// against a model of the Mailbox it replaced: fixed sizeof(base_station_msg_struct) slots, a
+// free and a full semaphore and a lock around the slot list, the way ti.sysbios.knl.Mailbox
+// works. Both sides wake the consumer with a semaphore post like the firmware does
+//
+// build and run on a Linux host:
+//
+// 	gcc -O2 -Wall -Wextra -pthread -o queue_stress queue_stress.c ../../CCS/RoverMotherboard/roveIncludes/roveWareSource/roveQueue.c
+// 	./queue_stress
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../../CCS/RoverMotherboard/roveIncludes/roveWareHeaders/roveQueue.h"
+
+// same values as mrdtRoveWare.h / roveStructs.h
+
+#define CMD_QUEUE_SIZE 512
+#define MAX_COMMAND_SIZE 30
+#define BASE_MSG_SIZE (1 + MAX_COMMAND_SIZE + 11)
+#define CMD_METADATA_SIZE 11
+
+// the Mailbox in RoverMotherboard.cfg before roveCmdQueue
+
+#define MAILBOX_SLOTS 10
+
+#define STRESS_RECORDS 4000000
+#define THROUGHPUT_RECORDS 2000000
+
+// motor_control_struct, the most common command
+
+#define MOTOR_COMMAND_SIZE 5
+
+static int failures = 0;
+
+static void check(int ok, const char* what) {
+
+    if (!ok) {
+
+        printf("FAIL %s\n", what);
+        failures++;
+
+    }
+
+}
+
+static double now_s(void) {
+
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+
+}
+
+static void unitTests(void) {
+
+    static uint8_t buffer[64];
+    struct rove_queue queue;
+    uint8_t header[4];
+    uint8_t body[32];
+    uint8_t record[32];
+    int i;
+    int round;
+
+    roveQueueInit(&queue, buffer, sizeof(buffer), NULL, NULL);
+
+    check(roveQueuePop(&queue, header, sizeof(header), body, sizeof(body)) == -1, "empty queue pops nothing");
+    check(roveQueueCount(&queue) == 0, "empty queue counts 0");
+
+    // header and body come back split where the consumer asks
+    check(roveQueuePush(&queue, "abcd", 4, "efg", 3), "push fits");
+    check(roveQueueCount(&queue) == 1, "one record counted");
+    check(roveQueuePop(&queue, header, 4, body, sizeof(body)) == 3, "body length returned");
+    check(memcmp(header, "abcd", 4) == 0 && memcmp(body, "efg", 3) == 0, "record intact");
+
+    // a record with no body, and one popped with a shorter header than pushed
+    check(roveQueuePush(&queue, "xy", 2, NULL, 0), "header only push");
+    check(roveQueuePop(&queue, header, 4, body, sizeof(body)) == 0, "header only pop");
+    check(roveQueuePush(&queue, "12", 2, "345", 3), "push for a split pop");
+    check(roveQueuePop(&queue, header, 1, body, sizeof(body)) == 4 && memcmp(body, "2345", 4) == 0, "split moves");
+
+    // a body longer than the consumer's buffer is cut, the next record still lines up
+    check(roveQueuePush(&queue, "h", 1, "0123456789", 10), "long push");
+    check(roveQueuePush(&queue, "i", 1, "ok", 2), "following push");
+    memset(body, 0, sizeof(body));
+    check(roveQueuePop(&queue, header, 1, body, 4) == 10 && memcmp(body, "0123", 4) == 0 && body[4] == 0, "cut body");
+    check(roveQueuePop(&queue, header, 1, body, 4) == 2 && header[0] == 'i' && memcmp(body, "ok", 2) == 0, "lined up after cut");
+
+    // 64 bytes hold exactly 64: two 30 byte records, a third refused
+    check(roveQueuePush(&queue, NULL, 0, record, 30), "first of two fills");
+    check(roveQueuePush(&queue, NULL, 0, record, 30), "second of two fills");
+    check(!roveQueuePush(&queue, NULL, 0, record, 1), "full queue refuses");
+    check(roveQueueFull(&queue) == 1, "refusal counted");
+    check(roveQueueHighWater(&queue) == 2, "high water");
+    roveQueuePop(&queue, NULL, 0, body, sizeof(body));
+    roveQueuePop(&queue, NULL, 0, body, sizeof(body));
+
+    // every offset of the ring, so records wrap in the length, the header and the body
+    for (round = 0; round < 200; round++) {
+
+        for (i = 0; i < (int) sizeof(record); i++) {
+
+            record[i] = (uint8_t) (round + i);
+
+        }
+
+        check(roveQueuePush(&queue, record, 3, record + 3, 4 + round % 20), "wrapping push");
+        memset(body, 0, sizeof(body));
+        check(roveQueuePop(&queue, header, 3, body, sizeof(body)) == 4 + round % 20, "wrapping pop length");
+        check(memcmp(header, record, 3) == 0 && memcmp(body, record + 3, 4 + round % 20) == 0, "wrapping pop bytes");
+
+    }
+
+    roveQueueInit(&queue, buffer, sizeof(buffer), NULL, NULL);
+    check(roveQueueCount(&queue) == 0 && roveQueueHighWater(&queue) == 0, "init resets");
+
+}
+
+// stress: record n is n's low byte repeated n % 29 + 1 times behind n itself
+
+struct stress {
+
+    struct rove_queue queue;
+    sem_t wakeup;
+    long records;
+    long bad;
+
+};
+
+static void postWakeup(void* arg) {
+
+    sem_post(&((struct stress*) arg)->wakeup);
+
+}
+
+static void* stressProducer(void* arg) {
+
+    struct stress* stress = arg;
+    uint8_t body[32];
+    uint32_t n;
+    int length;
+
+    for (n = 0; n < stress->records; n++) {
+
+        length = n % 29 + 1;
+        memset(body, (uint8_t) n, length);
+
+        while (!roveQueuePush(&stress->queue, &n, sizeof(n), body, length)) {
+
+            sched_yield();
+
+        }
+
+    }
+
+    return NULL;
+
+}
+
+static void* stressConsumer(void* arg) {
+
+    struct stress* stress = arg;
+    uint8_t body[32];
+    uint32_t expected;
+    uint32_t n;
+    int length;
+    int i;
+
+    for (expected = 0; expected < stress->records; expected++) {
+
+        while ((length = roveQueuePop(&stress->queue, &n, sizeof(n), body, sizeof(body))) < 0) {
+
+            sem_wait(&stress->wakeup);
+
+        }
+
+        if ((n != expected) || (length != (int) (n % 29 + 1))) {
+
+            stress->bad++;
+            continue;
+
+        }
+
+        for (i = 0; i < length; i++) {
+
+            if (body[i] != (uint8_t) n) {
+
+                stress->bad++;
+                break;
+
+            }
+
+        }
+
+    }
+
+    return NULL;
+
+}
+
+static void stressTest(void) {
+
+    static uint8_t buffer[128];
+    struct stress stress;
+    pthread_t producer;
+    pthread_t consumer;
+
+    memset(&stress, 0, sizeof(stress));
+    sem_init(&stress.wakeup, 0, 0);
+    stress.records = STRESS_RECORDS;
+    roveQueueInit(&stress.queue, buffer, sizeof(buffer), postWakeup, &stress);
+
+    pthread_create(&consumer, NULL, stressConsumer, &stress);
+    pthread_create(&producer, NULL, stressProducer, &stress);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+
+    printf("stress: %ld records through a %d byte ring, %u refused while full, %ld bad\n", stress.records,
+            (int) sizeof(buffer), roveQueueFull(&stress.queue), stress.bad);
+    check(stress.bad == 0, "stress records intact and in order");
+    check(roveQueueCount(&stress.queue) == 0, "stress queue drained");
+
+    sem_destroy(&stress.wakeup);
+
+}
+
+// the Mailbox model: every post and pend copies a whole slot and goes through two semaphores
+
+struct mailbox {
+
+    uint8_t slots[MAILBOX_SLOTS][BASE_MSG_SIZE];
+    int head;
+    int tail;
+    pthread_mutex_t lock;
+    sem_t free_slots;
+    sem_t full_slots;
+
+};
+
+static void mailboxPost(struct mailbox* mailbox, const void* message) {
+
+    sem_wait(&mailbox->free_slots);
+    pthread_mutex_lock(&mailbox->lock);
+    memcpy(mailbox->slots[mailbox->head], message, BASE_MSG_SIZE);
+    mailbox->head = (mailbox->head + 1) % MAILBOX_SLOTS;
+    pthread_mutex_unlock(&mailbox->lock);
+    sem_post(&mailbox->full_slots);
+
+}
+
+static void mailboxPend(struct mailbox* mailbox, void* message) {
+
+    sem_wait(&mailbox->full_slots);
+    pthread_mutex_lock(&mailbox->lock);
+    memcpy(message, mailbox->slots[mailbox->tail], BASE_MSG_SIZE);
+    mailbox->tail = (mailbox->tail + 1) % MAILBOX_SLOTS;
+    pthread_mutex_unlock(&mailbox->lock);
+    sem_post(&mailbox->free_slots);
+
+}
+
+static struct mailbox mailbox;
+
+static void* mailboxProducer(void* arg) {
+
+    uint8_t message[BASE_MSG_SIZE];
+    long n;
+
+    (void) arg;
+
+    memset(message, 0, sizeof(message));
+
+    for (n = 0; n < THROUGHPUT_RECORDS; n++) {
+
+        message[0] = (uint8_t) n;
+        mailboxPost(&mailbox, message);
+
+    }
+
+    return NULL;
+
+}
+
+static void* mailboxConsumer(void* arg) {
+
+    uint8_t message[BASE_MSG_SIZE];
+    long n;
+
+    (void) arg;
+
+    for (n = 0; n < THROUGHPUT_RECORDS; n++) {
+
+        mailboxPend(&mailbox, message);
+
+    }
+
+    return NULL;
+
+}
+
+// the queue as roveCmdQueue uses it: metadata as the header, a motor command as the body
+
+static void* queueProducer(void* arg) {
+
+    struct stress* stress = arg;
+    uint8_t message[BASE_MSG_SIZE];
+    long n;
+
+    memset(message, 0, sizeof(message));
+
+    for (n = 0; n < THROUGHPUT_RECORDS; n++) {
+
+        message[0] = (uint8_t) n;
+
+        while (!roveQueuePush(&stress->queue, message + 1 + MAX_COMMAND_SIZE, CMD_METADATA_SIZE, message,
+                MOTOR_COMMAND_SIZE)) {
+
+            sched_yield();
+
+        }
+
+    }
+
+    return NULL;
+
+}
+
+static void* queueConsumer(void* arg) {
+
+    struct stress* stress = arg;
+    uint8_t message[BASE_MSG_SIZE];
+    long n;
+
+    for (n = 0; n < THROUGHPUT_RECORDS; n++) {
+
+        while (roveQueuePop(&stress->queue, message + 1 + MAX_COMMAND_SIZE, CMD_METADATA_SIZE, message,
+                1 + MAX_COMMAND_SIZE) < 0) {
+
+            sem_wait(&stress->wakeup);
+
+        }
+
+    }
+
+    return NULL;
+
+}
+
+static double run(void* (*producer)(void*), void* (*consumer)(void*), void* arg) {
+
+    pthread_t threads[2];
+    double start = now_s();
+
+    pthread_create(&threads[1], NULL, consumer, arg);
+    pthread_create(&threads[0], NULL, producer, arg);
+    pthread_join(threads[0], NULL);
+    pthread_join(threads[1], NULL);
+
+    return THROUGHPUT_RECORDS / (now_s() - start);
+
+}
+
+static void throughputTest(void) {
+
+    static uint8_t buffer[CMD_QUEUE_SIZE];
+    struct stress queue;
+    double mailbox_rate;
+    double queue_rate;
+
+    memset(&mailbox, 0, sizeof(mailbox));
+    pthread_mutex_init(&mailbox.lock, NULL);
+    sem_init(&mailbox.free_slots, 0, MAILBOX_SLOTS);
+    sem_init(&mailbox.full_slots, 0, 0);
+    mailbox_rate = run(mailboxProducer, mailboxConsumer, NULL);
+
+    memset(&queue, 0, sizeof(queue));
+    sem_init(&queue.wakeup, 0, 0);
+    roveQueueInit(&queue.queue, buffer, sizeof(buffer), postWakeup, &queue);
+    queue_rate = run(queueProducer, queueConsumer, &queue);
+
+    printf("motor commands: Mailbox model %.2f M/s (%d byte slots x %d), roveQueue %.2f M/s (%d bytes), %.1fx\n",
+            mailbox_rate / 1e6, BASE_MSG_SIZE, MAILBOX_SLOTS, queue_rate / 1e6, CMD_QUEUE_SIZE,
+            queue_rate / mailbox_rate);
+
+}
+
+int main(void) {
+
+    unitTests();
+    stressTest();
+    throughputTest();
+
+    printf("%s\n", failures ? "FAILED" : "all passed");
+
+    return failures ? 1 : 0;
+
+}
@@ -0,0 +1,309 @@
+// rove_log.c MST MRDT
+//
+// Host checks of roveLog, the binary event ring, and of what roveLogSnapshot hands rove_log.py
+//
+// unit cases first: an empty log, a few events, laps of the ring, and a snapshot taken while a
+// writer is between taking its place and finishing its entry (the unlock hook stands in for
+// a Hwi arriving there). Then a writer thread logging numbered events while the main thread
+// takes snapshots, checking every entry it gets back is whole and in order
+//
+// build and run on a Linux host:
+//
+// 	gcc -O2 -Wall -Wextra -pthread -o rove_log rove_log.c ../../CCS/RoverMotherboard/roveIncludes/roveWareSource/roveLog.c
+// 	./rove_log
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../../CCS/RoverMotherboard/roveIncludes/roveWareHeaders/roveLog.h"
+
+#define STRESS_EVENTS 2000000
+
+static int failures = 0;
+
+static void check(int ok, const char* what) {
+
+    if (!ok) {
+
+        printf("FAIL %s\n", what);
+        failures++;
+
+    }
+
+}
+
+static uint32_t fake_us = 0;
+
+static uint32_t fakeClock(void) {
+
+    return fake_us;
+
+}
+
+// the unlock hook: set interrupt to take a snapshot as the next writer leaves the lock
+
+static struct log_report interrupted_report;
+static struct log_entry interrupted_entries[LOG_RING_SIZE];
+static int interrupt = 0;
+
+static uint32_t noLock(void) {
+
+    return 0x5A;
+
+}
+
+static void unlockAndInterrupt(uint32_t key) {
+
+    check(key == 0x5A, "unlock gets the lock's key");
+
+    if (interrupt) {
+
+        interrupt = 0;
+        roveLogSnapshot(&interrupted_report, interrupted_entries);
+
+    }
+
+}
+
+static void empty(void) {
+
+    struct log_report report;
+    static struct log_entry entries[LOG_RING_SIZE];
+
+    roveLogSnapshot(&report, entries);
+
+    check(report.entries == 0, "empty log has no entries");
+    check(report.first == 0 && report.written == 0, "empty log places");
+    check(report.entry_size == sizeof(struct log_entry), "entry size");
+    check(sizeof(struct log_entry) == 12, "entry is 12 bytes, as rove_log.py reads it");
+
+}
+
+// from a fresh process: the ring has never been written
+
+static void firstPlace(void) {
+
+    struct log_report report;
+    static struct log_entry entries[LOG_RING_SIZE];
+
+    // the first event ever, interrupted before it is written: its zero slot is not an event 0
+    interrupt = 1;
+    fake_us = 1000;
+    roveLog(LOG_TCP_INIT, 0, 0, 0);
+
+    check(interrupted_report.written == 1, "interrupted first place handed out");
+    check(interrupted_report.entries == 0, "unfinished first event left out");
+
+    roveLogSnapshot(&report, entries);
+
+    check(report.entries == 1, "first event once finished");
+    check(entries[0].us == 1000 && (entries[0].tag & 0xFF) == LOG_TCP_INIT, "first event contents");
+
+}
+
+static void someEvents(void) {
+
+    struct log_report report;
+    static struct log_entry entries[LOG_RING_SIZE];
+    uint32_t before;
+    int i;
+
+    roveLogSnapshot(&report, entries);
+    before = report.written;
+
+    for (i = 0; i < 5; i++) {
+
+        fake_us = 2000 + i;
+        roveLog(LOG_TCP_UNKNOWN_TYPE, i, -i, 7);
+
+    }
+
+    fake_us = 9000;
+    roveLogSnapshot(&report, entries);
+
+    check(report.written == before + 5, "written counts every event");
+    check(report.now_us == 9000, "report time from the clock");
+    check(report.entries == before + 5, "all kept before a lap");
+
+    for (i = 0; i < 5; i++) {
+
+        struct log_entry* entry = &entries[before + i];
+
+        check((entry->tag & 0xFF) == LOG_TCP_UNKNOWN_TYPE, "event id in the tag");
+        check((entry->tag >> 8) == ((before + i) & 0xFF), "place in the tag");
+        check(entry->us == (uint32_t) (2000 + i), "event time");
+        check(entry->arg[0] == i && entry->arg[1] == -i && entry->arg[2] == 7, "event args");
+
+    }
+
+}
+
+static void laps(void) {
+
+    struct log_report report;
+    static struct log_entry entries[LOG_RING_SIZE];
+    uint32_t before;
+    int i;
+
+    roveLogSnapshot(&report, entries);
+    before = report.written;
+
+    // two and a half laps, only the last LOG_RING_SIZE are kept
+    for (i = 0; i < LOG_RING_SIZE * 5 / 2; i++) {
+
+        roveLog(LOG_SENDER_CLOSED, (int16_t) i, 0, 0);
+
+    }
+
+    roveLogSnapshot(&report, entries);
+
+    check(report.written == before + LOG_RING_SIZE * 5 / 2, "written after laps");
+    check(report.entries == LOG_RING_SIZE, "a full ring kept");
+    check(report.first == report.written - LOG_RING_SIZE, "first is the oldest kept");
+
+    for (i = 0; i < LOG_RING_SIZE; i++) {
+
+        check(entries[i].arg[0] == LOG_RING_SIZE * 3 / 2 + i, "newest events, oldest first");
+
+    }
+
+}
+
+static void interrupted(void) {
+
+    struct log_report report;
+    static struct log_entry entries[LOG_RING_SIZE];
+    int i;
+
+    // the place being written still holds the event from a lap before
+    interrupt = 1;
+    roveLog(LOG_TCP_CLOSED, 1, 2, 3);
+
+    check(interrupted_report.entries == LOG_RING_SIZE - 1, "unfinished event left out");
+    check(interrupted_report.first == interrupted_report.written - LOG_RING_SIZE,
+            "first still counts the unfinished place");
+
+    for (i = 0; i < interrupted_report.entries; i++) {
+
+        check((interrupted_entries[i].tag & 0xFF) != LOG_TCP_CLOSED, "no half written event");
+
+    }
+
+    roveLogSnapshot(&report, entries);
+
+    check(report.entries == LOG_RING_SIZE, "finished event kept afterwards");
+    check((entries[LOG_RING_SIZE - 1].tag & 0xFF) == LOG_TCP_CLOSED
+            && entries[LOG_RING_SIZE - 1].arg[2] == 3, "finished event is the newest");
+
+}
+
+// a writer thread and snapshots taken while it runs, the lock is a mutex
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static volatile int writing = 1;
+
+static uint32_t mutexLock(void) {
+
+    pthread_mutex_lock(&mutex);
+    return 0;
+
+}
+
+static void mutexUnlock(uint32_t key) {
+
+    (void) key;
+    pthread_mutex_unlock(&mutex);
+
+}
+
+static void* writer(void* arg) {
+
+    uint32_t n;
+
+    (void) arg;
+
+    for (n = 0; n < STRESS_EVENTS; n++) {
+
+        roveLog(LOG_SENDER_LINK_DEAD, (int16_t) n, (int16_t) (n >> 16), (int16_t) ~n);
+
+    }
+
+    writing = 0;
+
+    return NULL;
+
+}
+
+static void stress(void) {
+
+    struct log_report report;
+    static struct log_entry entries[LOG_RING_SIZE];
+    pthread_t thread;
+    uint32_t n;
+    uint32_t last;
+    long snapshots = 0;
+    long kept = 0;
+    int bad = 0;
+    int i;
+
+    roveLogInit(fakeClock, mutexLock, mutexUnlock);
+
+    pthread_create(&thread, NULL, writer, NULL);
+
+    while (writing) {
+
+        roveLogSnapshot(&report, entries);
+        snapshots++;
+        kept += report.entries;
+        last = 0;
+
+        for (i = 0; i < report.entries; i++) {
+
+            if ((entries[i].tag & 0xFF) != LOG_SENDER_LINK_DEAD) {
+
+                continue;
+
+            }
+
+            n = (uint16_t) entries[i].arg[0] | ((uint32_t) (uint16_t) entries[i].arg[1] << 16);
+
+            // every entry whole, and numbered up the ring
+            if (((int16_t) ~n != entries[i].arg[2]) || ((last != 0) && (n <= last))) {
+
+                bad++;
+
+            }
+
+            last = n;
+
+        }
+
+    }
+
+    pthread_join(thread, NULL);
+
+    check(bad == 0, "snapshots under a running writer only hold whole events, in order");
+    check(snapshots > 0, "snapshots taken");
+
+    printf("%ld snapshots while %d events were logged, %.1f entries each\n", snapshots, STRESS_EVENTS,
+            snapshots ? (double) kept / snapshots : 0.0);
+
+}
+
+int main(void) {
+
+    roveLogInit(fakeClock, noLock, unlockAndInterrupt);
+
+    empty();
+    firstPlace();
+    someEvents();
+    laps();
+    interrupted();
+    stress();
+
+    printf("%s\n", failures ? "FAILED" : "all passed");
+
+    return failures ? 1 : 0;
+
+}
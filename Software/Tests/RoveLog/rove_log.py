@@ -0,0 +1,77 @@
+# rove_log.py MST MRDT
+#
+# Base station side of roveLog: turns a DIAGNOSTIC_LOG back into text
+#
+# the event ids and their formats are read from roveLog.h, so the two can't drift apart.
+# The input is the body of a ROVER_DIAGNOSTIC DIAGNOSTIC_LOG as base_station_sync.py saves it:
+# a struct log_report and then its entries
+#
+# usage: python rove_log.py rove_log.bin [roveLog.h]
+
+from __future__ import print_function
+import os
+import re
+import struct
+import sys
+
+HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'CCS', 'RoverMotherboard',
+                      'roveIncludes', 'roveWareHeaders', 'roveLog.h')
+
+# struct log_report, struct log_entry: packed, little endian
+REPORT_FORMAT = '<IIIHB'
+ENTRY_FORMAT = '<I3hH'
+
+EVENT_LINE = re.compile(r'#define\s+(LOG_\w+)\s+(\d+)\s*//\s*"(.*)"')
+
+
+def load_formats(header=HEADER):
+    """{event id: (name, format)} from the comments in roveLog.h."""
+    formats = {}
+    with open(header) as source:
+        for line in source:
+            match = EVENT_LINE.match(line.strip())
+            if match:
+                formats[int(match.group(2))] = (match.group(1), match.group(3))
+    return formats
+
+
+def decode(body, formats):
+    """Lines of text, oldest first, with the time relative to when the rover sent the log."""
+    now_us, first, written, entries, entry_size = struct.unpack(REPORT_FORMAT, body[:struct.calcsize(REPORT_FORMAT)])
+    if entry_size != struct.calcsize(ENTRY_FORMAT):
+        raise ValueError('entry size %d, this decoder knows %d' % (entry_size, struct.calcsize(ENTRY_FORMAT)))
+
+    lines = ['%d events since boot, %d here from event %d' % (written, entries, first)]
+    offset = struct.calcsize(REPORT_FORMAT)
+    place = first
+    for _ in range(entries):
+        us, arg0, arg1, arg2, tag = struct.unpack(ENTRY_FORMAT, body[offset:offset + entry_size])
+        offset += entry_size
+
+        # the high byte of the tag is where the entry sits in the log: a jump is an entry the
+        # rover dropped because it was still being written
+        while (place & 0xFF) != (tag >> 8):
+            lines.append('  (event %d unfinished)' % place)
+            place += 1
+        place += 1
+
+        name, text = formats.get(tag & 0xFF, ('LOG_%d' % (tag & 0xFF), 'unknown event %d, args %%d %%d %%d' % (tag & 0xFF)))
+        args = (arg0, arg1, arg2)[:text.count('%d')]
+        ago_ms = ((now_us - us) & 0xFFFFFFFF) / 1000.0
+        lines.append('%10.1f ms  %s' % (-ago_ms, text % args))
+    return lines
+
+
+def main():
+    if len(sys.argv) < 2:
+        print('usage: python rove_log.py rove_log.bin [roveLog.h]')
+        sys.exit(1)
+    formats = load_formats(sys.argv[2] if len(sys.argv) > 2 else HEADER)
+    with open(sys.argv[1], 'rb') as dump:
+        body = dump.read()
+    for line in decode(body, formats):
+        print(line)
+
+
+if __name__ == '__main__':
+    main()
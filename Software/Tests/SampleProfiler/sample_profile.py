@@ -0,0 +1,158 @@
+# sample_profile.py MST MRDT
+#
+# Base station side of roveSampler: a flat profile of the firmware from its program counter samples
+#
+# the input is rove_samples.bin as base_station_sync.py saves it, every DIAGNOSTIC_SAMPLES body
+# of a connection one after the other, each behind its u16 size. Addresses are turned into
+# functions with the symbols of the same build: the .out (through nm, armnm from the TI tools
+# works too) or, without one, the global symbols of the linker .map. The .map has no static
+# functions, their samples land in the global function before them
+#
+# usage: python sample_profile.py rove_samples.bin RoverMotherboard.out|RoverMotherboard.map [top]
+
+from __future__ import print_function
+import bisect
+import os
+import re
+import struct
+import subprocess
+import sys
+
+# struct sampler_report, struct sampler_task, struct sampler_sample: packed, little endian
+REPORT_FORMAT = '<IIIHB'
+HEALTH_TASK_NAME_SIZE = 18
+TASK_FORMAT = '<I%ds' % HEALTH_TASK_NAME_SIZE
+SAMPLE_FORMAT = '<II'
+
+# Cortex-M4 exception numbers below the first peripheral interrupt
+EXCEPTION_NAMES = {2: 'NMI', 3: 'HardFault', 11: 'SVCall', 14: 'PendSV', 15: 'SysTick'}
+FIRST_IRQ = 16
+
+MAP_SYMBOL = re.compile(r'^([0-9a-fA-F]{8})\s+(\S+)\s*$')
+NM_SYMBOL = re.compile(r'^([0-9a-fA-F]+)\s+[Tt]\s+(\S+)\s*$')
+
+
+def load_map(path):
+    """(address, name) of every global symbol in a TI linker .map."""
+    symbols = []
+    in_table = False
+    with open(path) as source:
+        for line in source:
+            if line.startswith('GLOBAL SYMBOLS: SORTED BY Symbol Address'):
+                in_table = True
+                continue
+            if in_table and line.startswith('[') and 'symbols' in line:
+                break
+            match = MAP_SYMBOL.match(line) if in_table else None
+            if match:
+                symbols.append((int(match.group(1), 16), match.group(2)))
+    return symbols
+
+
+def load_out(path):
+    """(address, name) of every function in an ELF .out, static ones included."""
+    nm = os.environ.get('NM', 'nm')
+    output = subprocess.check_output([nm, '-n', path]).decode('ascii', 'replace')
+    symbols = []
+    for line in output.splitlines():
+        match = NM_SYMBOL.match(line)
+        if match:
+            symbols.append((int(match.group(1), 16), match.group(2)))
+    return symbols
+
+
+class Symbols(object):
+
+    def __init__(self, symbols):
+        # Thumb function addresses have bit 0 set, program counters don't
+        pairs = sorted((address & ~1, name) for address, name in symbols)
+        self.addresses = [address for address, _ in pairs]
+        self.names = [name for _, name in pairs]
+
+    def lookup(self, pc):
+        place = bisect.bisect_right(self.addresses, pc) - 1
+        if place < 0:
+            return '0x%08x' % pc
+        return self.names[place]
+
+
+def read_batches(path):
+    """Every DIAGNOSTIC_SAMPLES body in the dump, in order."""
+    with open(path, 'rb') as dump:
+        data = dump.read()
+    offset = 0
+    while offset + 2 <= len(data):
+        size, = struct.unpack('<H', data[offset:offset + 2])
+        yield data[offset + 2:offset + 2 + size]
+        offset += 2 + size
+
+
+def decode(body):
+    """(report, {task handle: name}, [(pc, task)]) from one DIAGNOSTIC_SAMPLES body."""
+    offset = struct.calcsize(REPORT_FORMAT)
+    rate_hz, taken, dropped, samples, tasks = struct.unpack(REPORT_FORMAT, body[:offset])
+    names = {}
+    for _ in range(tasks):
+        handle, name = struct.unpack(TASK_FORMAT, body[offset:offset + struct.calcsize(TASK_FORMAT)])
+        names[handle] = name.split(b'\0')[0].decode('ascii', 'replace') or '0x%08x' % handle
+        offset += struct.calcsize(TASK_FORMAT)
+    pcs = []
+    for _ in range(samples):
+        pcs.append(struct.unpack(SAMPLE_FORMAT, body[offset:offset + struct.calcsize(SAMPLE_FORMAT)]))
+        offset += struct.calcsize(SAMPLE_FORMAT)
+    return (rate_hz, taken, dropped), names, pcs
+
+
+def context_name(task, names):
+    """Who was running: a task, an interrupt or a Swi / boot code on the main stack."""
+    if task in names:
+        return names[task]
+    if task == 0:
+        return 'main stack (Swi)'
+    if task < FIRST_IRQ:
+        return EXCEPTION_NAMES.get(task, 'exception %d' % task)
+    if task < 0x1000:
+        return 'Hwi irq %d' % (task - FIRST_IRQ)
+    return 'task 0x%08x' % task
+
+
+def print_table(title, counts, total, top):
+    print(title)
+    for name, count in sorted(counts.items(), key=lambda item: -item[1])[:top]:
+        print('  %6.2f%%  %7d  %s' % (100.0 * count / total, count, name))
+
+
+def main():
+    if len(sys.argv) < 3:
+        print('usage: python sample_profile.py rove_samples.bin RoverMotherboard.out|RoverMotherboard.map [top]')
+        sys.exit(1)
+    image = sys.argv[2]
+    symbols = Symbols(load_map(image) if image.endswith('.map') else load_out(image))
+    top = int(sys.argv[3]) if len(sys.argv) > 3 else 30
+
+    functions = {}
+    contexts = {}
+    total = 0
+    report = None
+    for body in read_batches(sys.argv[1]):
+        report, names, pcs = decode(body)
+        for pc, task in pcs:
+            function = symbols.lookup(pc)
+            functions[function] = functions.get(function, 0) + 1
+            context = context_name(task, names)
+            contexts[context] = contexts.get(context, 0) + 1
+            total += 1
+
+    if total == 0:
+        print('no samples (SAMPLER_ENABLED false?)')
+        return
+
+    rate_hz, taken, dropped = report
+    print('%d samples at %d Hz, %.1f s of run time. Since boot %d taken, %d dropped for a full ring' % (
+        total, rate_hz, float(total) / rate_hz, taken, dropped))
+    print_table('by function:', functions, total, top)
+    print_table('by context:', contexts, total, top)
+
+
+if __name__ == '__main__':
+    main()
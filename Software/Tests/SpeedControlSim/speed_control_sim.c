@@ -0,0 +1,227 @@
+// speed_control_sim.c MST MRDT
+//
+// Runs roveSpeedControl against a simulated wheel on a host, for tuning and as a regression test
+//
+// the plant is the same brushed motor behind an ESC as Software/Tests/MotionProfileSim, with a
+// load torque added for a hill. Each case is run open loop and closed loop, with feedback from
+// an encoder every tick or from motor current at CURRENT_RATE_HZ (wheel_feedback_telem), and
+// checked for steady state error under load, overshoot, recovery from a stall (anti windup)
+// and falling back to open loop when the feedback stops
+//
+// build and run on a Linux host:
+//
+// 	gcc -O2 -Wall -o speed_control_sim speed_control_sim.c ../../CCS/RoverMotherboard/roveIncludes/roveWareSource/roveSpeedControl.c -lm
+// 	./speed_control_sim
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../../CCS/RoverMotherboard/roveIncludes/roveWareHeaders/roveSpeedControl.h"
+
+// same values as mrdtRoveWare.h
+
+#define MOTION_PROFILE_RATE_HZ 500
+#define SPEED_CONTROL_KP_Q16 131072
+#define SPEED_CONTROL_KI_Q16 655
+#define SPEED_CONTROL_KD_Q16 0
+#define SPEED_CONTROL_KFF_Q16 65536
+#define SPEED_CONTROL_FEEDBACK_TIMEOUT_TICKS 50
+#define SPEED_CONTROL_WINDING_MOHM 200
+#define SPEED_CONTROL_PACK_MV 24000
+
+// plant
+
+#define PACK_VOLTS 24.0
+#define WINDING_OHMS 0.2
+#define MOTOR_K 0.05 		// V per rad/s and N m per A
+#define INERTIA 0.002 		// kg m^2 at the motor shaft
+#define FRICTION 0.0005 	// N m per rad/s
+#define PLANT_STEPS 10 		// plant sub steps per control tick
+#define HILL_NM 0.4 		// load torque climbing a slope
+
+// no load full scale: DriveMotor 1000 is the whole pack across the winding
+
+#define FULL_SCALE_RAD_S (PACK_VOLTS / MOTOR_K)
+
+#define CURRENT_RATE_HZ 50
+
+#define FEEDBACK_NONE 0
+#define FEEDBACK_ENCODER 1
+#define FEEDBACK_CURRENT 2
+
+struct plant {
+
+    double omega;
+    double current;
+
+};
+
+static void plantStep(struct plant* motor, int command, double load, int stalled, double dt) {
+
+    double volts = command / 1000.0 * PACK_VOLTS;
+    double torque;
+
+    motor->current = (volts - MOTOR_K * motor->omega) / WINDING_OHMS;
+
+    if (stalled) {
+
+        motor->omega = 0.0;
+        return;
+
+    }
+
+    // the load always opposes the motion the motor is asked for
+    torque = MOTOR_K * motor->current - FRICTION * motor->omega
+            - ((command < 0) ? -load : load);
+    motor->omega += torque / INERTIA * dt;
+
+}
+
+static double units(const struct plant* motor) {
+
+    return motor->omega / FULL_SCALE_RAD_S * 1000.0;
+
+}
+
+static void configure(void) {
+
+    struct speed_control_config config = { SPEED_CONTROL_KP_Q16, SPEED_CONTROL_KI_Q16,
+            SPEED_CONTROL_KD_Q16, SPEED_CONTROL_KFF_Q16, SPEED_CONTROL_FEEDBACK_TIMEOUT_TICKS,
+            SPEED_CONTROL_WINDING_MOHM, SPEED_CONTROL_PACK_MV };
+
+    roveSpeedControlConfigure(&config);
+
+}
+
+// runs ticks control ticks, returns the largest speed reached
+
+static double run(struct plant* motor, int16_t setpoint, int ticks, int feedback, double load,
+        int stalled, long* tick_count) {
+
+    double dt = 1.0 / MOTION_PROFILE_RATE_HZ;
+    double peak = -1e9;
+    int16_t command;
+    int tick;
+    int step;
+
+    for (tick = 0; tick < ticks; tick++, (*tick_count)++) {
+
+        if (feedback == FEEDBACK_ENCODER) {
+
+            roveSpeedControlFeedback(0, (int32_t) lround(units(motor)));
+
+        } else if ((feedback == FEEDBACK_CURRENT)
+                && ((*tick_count % (MOTION_PROFILE_RATE_HZ / CURRENT_RATE_HZ)) == 0)) {
+
+            // current sensors read a magnitude
+            roveSpeedControlCurrent(0, (int32_t) lround(fabs(motor->current) * 1000.0));
+
+        }
+
+        roveSpeedControlStep(0, setpoint, &command);
+
+        for (step = 0; step < PLANT_STEPS; step++) {
+
+            plantStep(motor, command, load, stalled, dt / PLANT_STEPS);
+
+        }
+
+        if (units(motor) > peak) {
+
+            peak = units(motor);
+
+        }
+
+    }
+
+    return peak;
+
+}
+
+static int hill(const char* name, int feedback) {
+
+    struct plant motor = { 0.0, 0.0 };
+    long ticks = 0;
+    double peak;
+    double error;
+    int16_t output;
+
+    configure();
+
+    // flat ground to 600, then the hill
+    peak = run(&motor, 600, 2 * MOTION_PROFILE_RATE_HZ, feedback, 0.0, 0, &ticks);
+    run(&motor, 600, 2 * MOTION_PROFILE_RATE_HZ, feedback, HILL_NM, 0, &ticks);
+    error = 600.0 - units(&motor);
+
+    printf("%-16s overshoot %5.1f, speed error on the hill %5.1f (of 600)\n", name, peak - 600.0,
+            error);
+
+    if (feedback == FEEDBACK_NONE) {
+
+        return error > 20.0;
+
+    }
+
+    roveSpeedControlStep(0, 600, &output);
+
+    return roveSpeedControlIsClosed(0) && (fabs(error) < 5.0) && (peak - 600.0 < 30.0);
+
+}
+
+int main(void) {
+
+    struct plant motor = { 0.0, 0.0 };
+    long ticks = 0;
+    double peak;
+    int16_t output;
+    int ok = 1;
+    int i;
+    clock_t start;
+
+    ok &= hill("open loop", FEEDBACK_NONE);
+    ok &= hill("encoder", FEEDBACK_ENCODER);
+    ok &= hill("current 50 Hz", FEEDBACK_CURRENT);
+
+    // stalled against a rock for two seconds at 800, then let go
+    configure();
+    run(&motor, 800, 2 * MOTION_PROFILE_RATE_HZ, FEEDBACK_ENCODER, 0.0, 1, &ticks);
+    peak = run(&motor, 800, 2 * MOTION_PROFILE_RATE_HZ, FEEDBACK_ENCODER, 0.0, 0, &ticks);
+    printf("stall release    overshoot %5.1f, settled at %5.1f (of 800)\n", peak - 800.0,
+            units(&motor));
+    ok &= (peak - 800.0 < 30.0) && (fabs(units(&motor) - 800.0) < 5.0);
+
+    // feedback stops: open loop once it is SPEED_CONTROL_FEEDBACK_TIMEOUT_TICKS old
+    for (i = 0; i < SPEED_CONTROL_FEEDBACK_TIMEOUT_TICKS; i++) {
+
+        roveSpeedControlStep(0, 700, &output);
+
+    }
+
+    printf("feedback lost    %s, command %d for setpoint 700\n",
+            roveSpeedControlIsClosed(0) ? "still closed" : "open loop", output);
+    ok &= !roveSpeedControlIsClosed(0) && (output == 700);
+
+    // cost: six wheels closed loop
+    start = clock();
+
+    for (ticks = 0; ticks < 200000; ticks++) {
+
+        for (i = 0; i < SPEED_CONTROL_WHEELS; i++) {
+
+            roveSpeedControlFeedback(i, (int32_t) (ticks % 900));
+            roveSpeedControlStep(i, 500, &output);
+
+        }
+
+    }
+
+    printf("six wheel tick: %.0f ns on this host\n",
+            (double) (clock() - start) / CLOCKS_PER_SEC * 1e9 / 200000);
+
+    printf("%s\n", ok ? "PASS" : "FAIL");
+
+    return !ok;
+
+}
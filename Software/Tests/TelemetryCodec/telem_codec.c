@@ -0,0 +1,279 @@
+// telem_codec.c MST MRDT
+//
+// Host checks of roveTelemCodec, the ROVER_TELEM_DELTA encoder the rover runs
+//
+// with no arguments: varint round trips at the edges, keyframe placement, seq, field deltas that
+// wrap, and the stream table limits.
+// with "encode": reads packed gps_telem samples from stdin and writes the frames the rover would
+// send for them to stdout. telem_codec.py feeds it a recorded NMEA log that way and decodes the
+// frames the way the base station does
+//
+// build and run on a Linux host:
+//
+// 	gcc -O2 -Wall -Wextra -o telem_codec telem_codec.c ../../CCS/RoverMotherboard/roveIncludes/roveWareSource/roveTelemCodec.c
+// 	./telem_codec
+// 	python telem_codec.py ./telem_codec gps_log.nmea [keyframe_interval]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "../../CCS/RoverMotherboard/roveIncludes/roveWareHeaders/roveTelemCodec.h"
+
+// same values as mrdtRoveWare.h
+
+#define ROVER_TELEM_DELTA 0x08
+#define TELEM_KEYFRAME_INTERVAL 20
+#define gps_telem_reply 140
+
+// same layout as roveStructs.h, and the same field table as initTelemCodecStreams
+
+struct gps_telem {
+
+    uint8_t struct_id;
+    uint8_t fix;
+    uint8_t fix_quality;
+    uint8_t satellites;
+    int32_t latitude_fixed;
+    int32_t longitude_fixed;
+    float altitude;
+    float speed;
+    float angle;
+
+}__attribute__((packed));
+
+static const struct telem_field gps_telem_fields[] = {
+
+    { offsetof(struct gps_telem, fix), 1 },
+    { offsetof(struct gps_telem, fix_quality), 1 },
+    { offsetof(struct gps_telem, satellites), 1 },
+    { offsetof(struct gps_telem, latitude_fixed), 4 },
+    { offsetof(struct gps_telem, longitude_fixed), 4 },
+    { offsetof(struct gps_telem, altitude), 4 },
+    { offsetof(struct gps_telem, speed), 4 },
+    { offsetof(struct gps_telem, angle), 4 },
+
+};
+
+#define GPS_FIELD_COUNT (sizeof(gps_telem_fields) / sizeof(gps_telem_fields[0]))
+
+static int failures = 0;
+
+static void check(int ok, const char* what) {
+
+    if (!ok) {
+
+        printf("FAIL %s\n", what);
+        failures++;
+
+    }
+
+}
+
+static void initCodec(uint8_t keyframe_interval) {
+
+    roveTelemCodecInit(ROVER_TELEM_DELTA, keyframe_interval);
+    roveTelemCodecAddStream(gps_telem_reply, sizeof(struct gps_telem), gps_telem_fields,
+            GPS_FIELD_COUNT, true);
+
+}
+
+static void varints(void) {
+
+    static const int32_t values[] = { 0, 1, -1, 63, -64, 64, -65, 8191, -8192, 1000000,
+            0x7FFFFFFF, (int32_t) 0x80000000 };
+    uint8_t buffer[8];
+    int32_t value;
+    int written;
+    size_t i;
+
+    for (i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+
+        written = roveVarintWrite(values[i], buffer);
+
+        check(written >= 1 && written <= 5, "varint length");
+        check(roveVarintRead(buffer, written, &value) == written, "varint read length");
+        check(value == values[i], "varint round trip");
+        check(roveVarintRead(buffer, written - 1, &value) == -1, "truncated varint refused");
+
+    }
+
+    // zigzag keeps small deltas of either sign to one byte
+    check(roveVarintWrite(-64, buffer) == 1, "-64 in one byte");
+    check(roveVarintWrite(63, buffer) == 1, "63 in one byte");
+    check(roveVarintWrite(64, buffer) == 2, "64 in two bytes");
+
+}
+
+static void frames(void) {
+
+    struct gps_telem sample;
+    char frame[TELEM_DELTA_MAX_FRAME];
+    const uint8_t* bytes = (const uint8_t*) frame;
+    int32_t value;
+    int length;
+    int pos;
+    int i;
+
+    initCodec(4);
+
+    memset(&sample, 0, sizeof(sample));
+    sample.struct_id = gps_telem_reply;
+    sample.fix = 1;
+    sample.latitude_fixed = 379530000;
+    sample.longitude_fixed = -917720000;
+
+    check(roveTelemCodecIsEnabled(gps_telem_reply), "gps stream enabled");
+    check(!roveTelemCodecIsEnabled(gps_telem_reply + 1), "other ids not encoded");
+
+    // first frame is a keyframe holding the raw struct
+    length = roveTelemEncode(&sample, frame);
+
+    check(length == TELEM_DELTA_HEADER_SIZE + (int) sizeof(sample), "keyframe length");
+    check(bytes[0] == ROVER_TELEM_DELTA && bytes[1] == gps_telem_reply, "keyframe header");
+    check(bytes[2] == 0 && bytes[3] == TELEM_DELTA_KEYFRAME, "keyframe seq and flags");
+    check(bytes[4] == sizeof(sample), "keyframe payload length");
+    check(memcmp(frame + TELEM_DELTA_HEADER_SIZE, &sample, sizeof(sample)) == 0, "keyframe payload");
+
+    // an unchanged sample is one zero byte per field
+    length = roveTelemEncode(&sample, frame);
+
+    check(length == TELEM_DELTA_HEADER_SIZE + (int) GPS_FIELD_COUNT, "unchanged delta length");
+    check(bytes[2] == 1 && bytes[3] == 0, "delta seq and flags");
+
+    // a small move, and a latitude that wraps through the int32 range
+    sample.satellites = 9;
+    sample.latitude_fixed = 379530007;
+    sample.longitude_fixed = -917720003;
+
+    length = roveTelemEncode(&sample, frame);
+    pos = TELEM_DELTA_HEADER_SIZE;
+
+    for (i = 0; i < (int) GPS_FIELD_COUNT; i++) {
+
+        int32_t expected = 0;
+
+        pos += roveVarintRead(bytes + pos, length - pos, &value);
+
+        if (i == 2) {
+
+            expected = 9;
+
+        } else if (i == 3) {
+
+            expected = 7;
+
+        } else if (i == 4) {
+
+            expected = -3;
+
+        }
+
+        check(value == expected, "field delta");
+
+    }
+
+    check(pos == length, "delta payload fully used");
+
+    sample.latitude_fixed = (int32_t) 0x80000000;
+    length = roveTelemEncode(&sample, frame);
+    roveVarintRead(bytes + TELEM_DELTA_HEADER_SIZE + 3, length, &value);
+
+    check((uint32_t) (379530007 + (uint32_t) value) == 0x80000000, "wrapping delta");
+
+    // keyframe after keyframe_interval deltas, and after a resync
+    length = roveTelemEncode(&sample, frame);
+
+    check(bytes[3] == 0, "fourth delta");
+
+    length = roveTelemEncode(&sample, frame);
+
+    check(bytes[3] == TELEM_DELTA_KEYFRAME && bytes[2] == 5, "keyframe after interval");
+
+    roveTelemEncode(&sample, frame);
+    roveTelemCodecResync();
+    roveTelemEncode(&sample, frame);
+
+    check(bytes[3] == TELEM_DELTA_KEYFRAME, "keyframe after resync");
+
+    // switched off, and back on with a keyframe
+    check(roveTelemCodecEnable(gps_telem_reply, false), "disable");
+    check(roveTelemEncode(&sample, frame) == -1, "disabled stream refused");
+    check(roveTelemCodecEnable(gps_telem_reply, true), "enable");
+    roveTelemEncode(&sample, frame);
+
+    check(bytes[3] == TELEM_DELTA_KEYFRAME, "keyframe after enable");
+    check(!roveTelemCodecEnable(gps_telem_reply + 1, true), "unknown id refused");
+
+}
+
+static void streams(void) {
+
+    int i;
+
+    roveTelemCodecInit(ROVER_TELEM_DELTA, TELEM_KEYFRAME_INTERVAL);
+
+    check(!roveTelemCodecAddStream(1, TELEM_DELTA_MAX_SAMPLE + 1, gps_telem_fields, GPS_FIELD_COUNT,
+            true), "oversized struct refused");
+
+    for (i = 0; i < TELEM_DELTA_MAX_STREAMS; i++) {
+
+        check(roveTelemCodecAddStream(i + 1, sizeof(struct gps_telem), gps_telem_fields,
+                GPS_FIELD_COUNT, false), "stream added");
+
+    }
+
+    check(!roveTelemCodecAddStream(1, sizeof(struct gps_telem), gps_telem_fields, GPS_FIELD_COUNT,
+            false), "duplicate id refused");
+    check(!roveTelemCodecAddStream(TELEM_DELTA_MAX_STREAMS + 1, sizeof(struct gps_telem),
+            gps_telem_fields, GPS_FIELD_COUNT, false), "full table refused");
+
+}
+
+// samples in on stdin, frames out on stdout
+
+static int encode(uint8_t keyframe_interval) {
+
+    struct gps_telem sample;
+    char frame[TELEM_DELTA_MAX_FRAME];
+    int length;
+
+    initCodec(keyframe_interval);
+
+    while (fread(&sample, sizeof(sample), 1, stdin) == 1) {
+
+        length = roveTelemEncode(&sample, frame);
+
+        if (length < 0) {
+
+            fprintf(stderr, "sample with id %d is not delta encoded\n", sample.struct_id);
+            return 1;
+
+        }
+
+        fwrite(frame, 1, length, stdout);
+
+    }
+
+    return 0;
+
+}
+
+int main(int argc, char** argv) {
+
+    if ((argc > 1) && (strcmp(argv[1], "encode") == 0)) {
+
+        return encode((argc > 2) ? atoi(argv[2]) : TELEM_KEYFRAME_INTERVAL);
+
+    }
+
+    varints();
+    frames();
+    streams();
+
+    printf("%s\n", failures ? "FAILED" : "all passed");
+
+    return failures ? 1 : 0;
+
+}
@@ -0,0 +1,174 @@
+# telem_codec.py MST MRDT
+#
+# Base station side of roveTelemCodec (ROVER_TELEM_DELTA frames)
+#
+# Replays a recorded GPS NMEA log through the real roveTelemCodec.c, built into the
+# telem_codec.c host harness, decodes the frames it writes the way the base station
+# would, checks every sample round trips bit exact, and reports how many bytes that
+# saves over plain ROVER_TELEM.
+#
+# usage: python telem_codec.py ./telem_codec gps_log.nmea [keyframe_interval]
+
+from __future__ import print_function
+import struct
+import subprocess
+import sys
+
+ROVER_TELEM_DELTA = 0x08
+TELEM_DELTA_KEYFRAME = 0x01
+GPS_TELEM_REPLY = 140
+
+# struct gps_telem, packed, little endian: id, fix, fix_quality, satellites,
+# latitude_fixed, longitude_fixed, altitude, speed, angle
+GPS_FORMAT = '<BBBBiifff'
+GPS_SIZE = struct.calcsize(GPS_FORMAT)
+
+# (offset, width) of every field after struct_id, must match gps_telem_fields[] in roveStructs.c
+GPS_FIELDS = [(1, 1), (2, 1), (3, 1), (4, 4), (8, 4), (12, 4), (16, 4), (20, 4)]
+
+LAYOUTS = {GPS_TELEM_REPLY: (GPS_SIZE, GPS_FIELDS)}
+
+
+def varint_read(data, pos):
+    folded = 0
+    shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        folded |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            break
+    value = (folded >> 1) ^ -(folded & 1)
+    return value, pos
+
+
+def read_field(sample, field):
+    offset, width = field
+    value = 0
+    for i in reversed(range(width)):
+        value = (value << 8) | sample[offset + i]
+    return value
+
+
+def write_field(sample, field, value):
+    offset, width = field
+    for i in range(width):
+        sample[offset + i] = (value >> (8 * i)) & 0xFF
+
+
+class Decoder(object):
+    """What the base station runs on every ROVER_TELEM_DELTA frame."""
+
+    def __init__(self):
+        self.last = {}
+        self.next_seq = {}
+        self.dropped = 0
+
+    def decode(self, frame):
+        struct_id, seq, flags, length = frame[1], frame[2], frame[3], frame[4]
+        payload = frame[5:5 + length]
+        size, fields = LAYOUTS[struct_id]
+
+        # a lost frame breaks the delta chain until the next keyframe
+        if self.next_seq.get(struct_id, seq) != seq:
+            self.last.pop(struct_id, None)
+        self.next_seq[struct_id] = (seq + 1) & 0xFF
+
+        if flags & TELEM_DELTA_KEYFRAME:
+            sample = bytearray(payload)
+        elif struct_id in self.last:
+            sample = bytearray(self.last[struct_id])
+            pos = 0
+            for field in fields:
+                delta, pos = varint_read(payload, pos)
+                mask = (1 << (8 * field[1])) - 1
+                write_field(sample, field, (read_field(sample, field) + delta) & mask)
+        else:
+            self.dropped += 1
+            return None
+
+        self.last[struct_id] = sample
+        return sample
+
+
+def nmea_degrees(value, hemisphere):
+    if not value:
+        return 0
+    dot = value.index('.')
+    degrees = int(value[:dot - 2]) + float(value[dot - 2:]) / 60.0
+    if hemisphere in ('S', 'W'):
+        degrees = -degrees
+    return int(round(degrees * 10000000))
+
+
+def gps_samples(path):
+    """Builds gps_telem structs the way the Adafruit GPS parser fills them: one per GGA sentence."""
+    speed = angle = 0.0
+    for line in open(path):
+        fields = line.strip().split('*')[0].split(',')
+        if fields[0].endswith('RMC') and len(fields) > 8:
+            speed = float(fields[7] or 0)
+            angle = float(fields[8] or 0)
+        elif fields[0].endswith('GGA') and len(fields) > 9:
+            quality = int(fields[6] or 0)
+            yield bytearray(struct.pack(GPS_FORMAT, GPS_TELEM_REPLY, quality > 0, quality,
+                                        int(fields[7] or 0),
+                                        nmea_degrees(fields[2], fields[3]),
+                                        nmea_degrees(fields[4], fields[5]),
+                                        float(fields[9] or 0), speed, angle))
+
+
+def frames(data):
+    pos = 0
+    while pos < len(data):
+        end = pos + 5 + data[pos + 4]
+        yield data[pos:end]
+        pos = end
+
+
+def main():
+    if len(sys.argv) < 3:
+        print('usage: python telem_codec.py ./telem_codec gps_log.nmea [keyframe_interval]')
+        sys.exit(1)
+
+    samples = list(gps_samples(sys.argv[2]))
+    if not samples:
+        print('No GGA sentences found')
+        sys.exit(1)
+
+    encoder = subprocess.Popen([sys.argv[1], 'encode'] + sys.argv[3:4],
+                               stdin=subprocess.PIPE, stdout=subprocess.PIPE)
+    output, _ = encoder.communicate(b''.join(bytes(sample) for sample in samples))
+    if encoder.returncode != 0:
+        print('encoder failed')
+        sys.exit(1)
+
+    decoder = Decoder()
+    decoded = 0
+    output = bytearray(output)
+
+    for frame in frames(output):
+        if frame[0] != ROVER_TELEM_DELTA or decoded >= len(samples):
+            print('Unexpected frame', decoded)
+            sys.exit(1)
+        if decoder.decode(frame) != samples[decoded]:
+            print('Round trip mismatch on sample', decoded)
+            sys.exit(1)
+        decoded += 1
+
+    if decoded != len(samples):
+        print('Only %d of %d samples came back' % (decoded, len(samples)))
+        sys.exit(1)
+
+    plain_bytes = len(samples) * (1 + GPS_SIZE)
+
+    print('samples:          ', decoded)
+    print('ROVER_TELEM bytes:', plain_bytes)
+    print('delta bytes:      ', len(output))
+    print('compression ratio: %.2f : 1' % (float(plain_bytes) / len(output)))
+    print('bytes per sample:  %.1f -> %.1f' % (float(plain_bytes) / decoded, float(len(output)) / decoded))
+
+
+if __name__ == '__main__':
+    main()